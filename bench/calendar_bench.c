@@ -0,0 +1,240 @@
+/*******************************************************************************
+************************** - CALENDAR QUEUE BENCHMARK - ************************
+*
+*	DESCRIPTION		Benchmark of the calendar queue against the heaps on a
+*					large schedule: N timers with intervals spread between
+*					one minute and four weeks (in seconds), then OPS hold
+*					operations (pop the earliest, push it one interval later).
+*					Prints the calendar resize statistics after every run.
+*	AUTHOR          Liad Raz
+*	USAGE			calendar_bench [N] [OPS]
+*
+*******************************************************************************/
+
+#include <stdio.h>		/* printf, puts */
+#include <stdlib.h>		/* malloc, free, rand, srand, atol */
+#include <time.h>		/* clock */
+
+#include "utilities.h"
+#include "calendar_queue.h"
+#include "dary_heap.h"
+#include "radix_heap.h"
+
+#define DEFAULT_N 		1000000
+#define DEFAULT_OPS 	1000000
+#define MIN_INTERVAL 	60L
+#define MAX_INTERVAL 	(4L * 7 * 24 * 60 * 60)
+
+typedef struct timer
+{
+	long next_run;
+	long interval;
+} timer_ty;
+
+static void RunCalendar(size_t n, size_t ops);
+static void RunDAryHeap(size_t n, size_t ops);
+static void RunRadixHeap(size_t n, size_t ops);
+static timer_ty *CreateTimers(size_t n);
+static long RandomImp(void);
+static void PrintResult(const char *name, double fill_sec, double hold_sec,
+						size_t n, size_t ops);
+
+/*******************************************************************************
+********************************** MAIN ***************************************/
+int main(int argc, char *argv[])
+{
+	size_t n = (1 < argc) ? (size_t)atol(argv[1]) : DEFAULT_N;
+	size_t ops = (2 < argc) ? (size_t)atol(argv[2]) : DEFAULT_OPS;
+
+	printf("\n--- Calendar Queue Benchmark N = %lu, OPS = %lu ---\n",
+			(unsigned long)n, (unsigned long)ops);
+	printf("%-16s %12s %14s %14s\n", "", "N", "fill ns/elem", "hold ns/op");
+
+	RunCalendar(n, ops);
+	RunDAryHeap(n, ops);
+	RunRadixHeap(n, ops);
+	puts("");
+
+	return 0;
+}
+
+
+/*******************************************************************************
+****************************** Implementation *********************************/
+static void RunCalendar(size_t n, size_t ops)
+{
+	cqueue_ty *cqueue = CQueueCreate();
+	timer_ty *timers = CreateTimers(n);
+	timer_ty *current = NULL;
+	cqueue_stats_ty stats = {0};
+	clock_t fill = 0;
+	clock_t hold = 0;
+	size_t i = 0;
+
+	if (NULL == timers || NULL == cqueue)
+	{
+		puts("calendar queue   allocation failure");
+		free(timers);
+		if (NULL != cqueue)
+		{
+			CQueueDestroy(cqueue);
+		}
+		return;
+	}
+
+	fill = clock();
+	for (i = 0; i < n; ++i)
+	{
+		CQueuePush(cqueue, timers[i].next_run, &timers[i]);
+	}
+	fill = clock() - fill;
+
+	hold = clock();
+	for (i = 0; i < ops; ++i)
+	{
+		current = CQueuePeek(cqueue);
+		CQueuePop(cqueue);
+
+		current->next_run += current->interval;
+		CQueuePush(cqueue, current->next_run, current);
+	}
+	hold = clock() - hold;
+
+	PrintResult("calendar queue", (double)fill / CLOCKS_PER_SEC,
+				(double)hold / CLOCKS_PER_SEC, n, ops);
+
+	CQueueGetStats(cqueue, &stats);
+	printf("    buckets %lu, width %lu, resizes %lu (grows %lu, shrinks %lu), "
+			"last at size %lu, direct searches %lu\n",
+			(unsigned long)stats.num_buckets, stats.width,
+			(unsigned long)stats.resizes, (unsigned long)stats.grows,
+			(unsigned long)stats.shrinks, (unsigned long)stats.last_resize_size,
+			(unsigned long)stats.direct_searches);
+
+	CQueueDestroy(cqueue);
+	free(timers);
+}
+
+static void RunDAryHeap(size_t n, size_t ops)
+{
+	dheap_ty *heap = DHeapCreate(DHEAP_DEFAULT_ARITY);
+	timer_ty *timers = CreateTimers(n);
+	timer_ty *current = NULL;
+	clock_t fill = 0;
+	clock_t hold = 0;
+	size_t i = 0;
+
+	if (NULL == timers || NULL == heap)
+	{
+		puts("4-ary heap       allocation failure");
+		free(timers);
+		if (NULL != heap)
+		{
+			DHeapDestroy(heap);
+		}
+		return;
+	}
+
+	fill = clock();
+	for (i = 0; i < n; ++i)
+	{
+		DHeapPush(heap, timers[i].next_run, &timers[i]);
+	}
+	fill = clock() - fill;
+
+	hold = clock();
+	for (i = 0; i < ops; ++i)
+	{
+		current = DHeapPeek(heap);
+		DHeapPop(heap);
+
+		current->next_run += current->interval;
+		DHeapPush(heap, current->next_run, current);
+	}
+	hold = clock() - hold;
+
+	PrintResult("4-ary heap", (double)fill / CLOCKS_PER_SEC,
+				(double)hold / CLOCKS_PER_SEC, n, ops);
+
+	DHeapDestroy(heap);
+	free(timers);
+}
+
+static void RunRadixHeap(size_t n, size_t ops)
+{
+	rheap_ty *heap = RHeapCreate();
+	timer_ty *timers = CreateTimers(n);
+	timer_ty *current = NULL;
+	clock_t fill = 0;
+	clock_t hold = 0;
+	size_t i = 0;
+
+	if (NULL == timers || NULL == heap)
+	{
+		puts("radix heap       allocation failure");
+		free(timers);
+		if (NULL != heap)
+		{
+			RHeapDestroy(heap);
+		}
+		return;
+	}
+
+	fill = clock();
+	for (i = 0; i < n; ++i)
+	{
+		RHeapPush(heap, timers[i].next_run, &timers[i]);
+	}
+	fill = clock() - fill;
+
+	hold = clock();
+	for (i = 0; i < ops; ++i)
+	{
+		current = RHeapPeek(heap);
+		RHeapPop(heap);
+
+		current->next_run += current->interval;
+		RHeapPush(heap, current->next_run, current);
+	}
+	hold = clock() - hold;
+
+	PrintResult("radix heap", (double)fill / CLOCKS_PER_SEC,
+				(double)hold / CLOCKS_PER_SEC, n, ops);
+
+	RHeapDestroy(heap);
+	free(timers);
+}
+
+static timer_ty *CreateTimers(size_t n)
+{
+	timer_ty *timers = (timer_ty *)malloc(n * sizeof(timer_ty));
+	size_t i = 0;
+
+	if (NULL == timers)
+	{
+		return NULL;
+	}
+
+	/* same seed for every run, so all queues get identical input */
+	srand(50);
+	for (i = 0; i < n; ++i)
+	{
+		timers[i].interval = MIN_INTERVAL + RandomImp() % (MAX_INTERVAL - MIN_INTERVAL);
+		timers[i].next_run = RandomImp() % timers[i].interval;
+	}
+
+	return timers;
+}
+
+/* rand() may stop at 32767; combine two calls to cover weeks of seconds */
+static long RandomImp(void)
+{
+	return ((long)(rand() & 0x7fff) << 15) | (long)(rand() & 0x7fff);
+}
+
+static void PrintResult(const char *name, double fill_sec, double hold_sec,
+						size_t n, size_t ops)
+{
+	printf("%-16s %12lu %14.1f %14.1f\n", name, (unsigned long)n,
+			fill_sec * 1e9 / n, (0 == ops) ? 0.0 : hold_sec * 1e9 / ops);
+}
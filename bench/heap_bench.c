@@ -0,0 +1,161 @@
+/*******************************************************************************
+************************** - PQUEUE BACKENDS BENCHMARK - ***********************
+*
+*	DESCRIPTION		Benchmark of the pqueue backends as the queue grows.
+*					For every N: fill the queue with N random keys, then
+*					run OPS hold operations (pop the minimum, push it back
+*					with a random later key), so the queue keeps its size.
+*	AUTHOR          Liad Raz
+*	USAGE			heap_bench [MAX_N] [OPS]
+*
+*******************************************************************************/
+
+#include <stdio.h>		/* printf, puts */
+#include <stdlib.h>		/* malloc, free, rand, srand, atol */
+#include <time.h>		/* clock */
+
+#include "utilities.h"
+#include "pqueue.h"
+
+#define DEFAULT_MAX_N 	10000000
+#define DEFAULT_OPS 	1000000
+#define MIN_N 			1000
+
+typedef struct timer
+{
+	long next_run;
+	long interval;
+} timer_ty;
+
+typedef pqueue_ty *(*CreateFunc)(size_t arity);
+
+static pqueue_ty *CreateSortL(size_t ignore);
+static pqueue_ty *CreateDAryHeap(size_t arity);
+static pqueue_ty *CreateRadixHeap(size_t ignore);
+
+static void RunBackend(const char *name, CreateFunc create, size_t arity,
+						size_t n, size_t ops);
+static timer_ty *CreateTimers(size_t n);
+static void PrintResult(const char *name, double fill_sec, double hold_sec,
+						size_t n, size_t ops);
+
+/*******************************************************************************
+********************************** MAIN ***************************************/
+int main(int argc, char *argv[])
+{
+	size_t max_n = (1 < argc) ? (size_t)atol(argv[1]) : DEFAULT_MAX_N;
+	size_t ops = (2 < argc) ? (size_t)atol(argv[2]) : DEFAULT_OPS;
+	size_t n = 0;
+
+	printf("\n--- PQueue Backends Benchmark N = %d..%lu, OPS = %lu ---\n",
+			MIN_N, (unsigned long)max_n, (unsigned long)ops);
+	printf("%-24s %12s %14s %14s\n", "", "N", "fill ns/elem", "hold ns/op");
+
+	for (n = MIN_N; n <= max_n; n *= 10)
+	{
+		RunBackend("sorted list (skip list)", CreateSortL, 0, n, ops);
+		RunBackend("binary heap (d = 2)", CreateDAryHeap, 2, n, ops);
+		RunBackend("4-ary heap", CreateDAryHeap, 4, n, ops);
+		RunBackend("8-ary heap", CreateDAryHeap, 8, n, ops);
+		RunBackend("radix heap", CreateRadixHeap, 0, n, ops);
+		puts("");
+	}
+
+	return 0;
+}
+
+
+/*******************************************************************************
+****************************** Implementation *********************************/
+static pqueue_ty *CreateSortL(size_t ignore)
+{
+	UNUSED(ignore);
+
+	return PQueueCreateKeyed(OFFSETOF_SIZE_T(timer_ty, next_run));
+}
+
+static pqueue_ty *CreateDAryHeap(size_t arity)
+{
+	return PQueueCreateDAryHeap(OFFSETOF_SIZE_T(timer_ty, next_run), arity);
+}
+
+static pqueue_ty *CreateRadixHeap(size_t ignore)
+{
+	UNUSED(ignore);
+
+	return PQueueCreateRadixHeap(OFFSETOF_SIZE_T(timer_ty, next_run));
+}
+
+static void RunBackend(const char *name, CreateFunc create, size_t arity,
+						size_t n, size_t ops)
+{
+	pqueue_ty *pqueue = create(arity);
+	timer_ty *timers = CreateTimers(n);
+	timer_ty *current = NULL;
+	clock_t fill = 0;
+	clock_t hold = 0;
+	size_t i = 0;
+
+	if (NULL == timers || NULL == pqueue)
+	{
+		printf("%-24s allocation failure\n", name);
+		free(timers);
+		if (NULL != pqueue)
+		{
+			PQueueDestroy(pqueue);
+		}
+		return;
+	}
+
+	fill = clock();
+	for (i = 0; i < n; ++i)
+	{
+		PQueueEnqueue(pqueue, &timers[i]);
+	}
+	fill = clock() - fill;
+
+	hold = clock();
+	for (i = 0; i < ops; ++i)
+	{
+		current = PQueuePeek(pqueue);
+		PQueueDequeue(pqueue);
+
+		current->next_run += current->interval;
+		PQueueEnqueue(pqueue, current);
+	}
+	hold = clock() - hold;
+
+	PrintResult(name, (double)fill / CLOCKS_PER_SEC, (double)hold / CLOCKS_PER_SEC,
+				n, ops);
+
+	PQueueDestroy(pqueue);
+	free(timers);
+}
+
+static timer_ty *CreateTimers(size_t n)
+{
+	timer_ty *timers = (timer_ty *)malloc(n * sizeof(timer_ty));
+	size_t i = 0;
+
+	if (NULL == timers)
+	{
+		return NULL;
+	}
+
+	/* same seed for every run, so all backends get identical input */
+	srand(50);
+	for (i = 0; i < n; ++i)
+	{
+		timers[i].next_run = (long)rand() % (long)n;
+		timers[i].interval = 1 + (long)rand() % (long)n;
+	}
+
+	return timers;
+}
+
+static void PrintResult(const char *name, double fill_sec, double hold_sec,
+						size_t n, size_t ops)
+{
+	printf("%-24s %12lu %14.1f %14.1f\n", name, (unsigned long)n,
+			fill_sec * 1e9 / n, (0 == ops) ? 0.0 : hold_sec * 1e9 / ops);
+}
@@ -0,0 +1,347 @@
+/*******************************************************************************
+************************ - PRIORITY QUEUE BENCHMARK - **************************
+*
+*	DESCRIPTION		Benchmark of pqueue implementations on a scheduler-like
+*					workload: fill the queue with N timers, then repeatedly
+*					pop the earliest and push it back one interval later.
+*					A second workload extends timeouts: every op moves a
+*					random timer to now + timeout, and timers which expire
+*					are restarted.
+*	AUTHOR          Liad Raz
+*	USAGE			pqueue_bench [N] [OPS]
+*
+*******************************************************************************/
+
+#include <stdio.h>		/* printf, puts */
+#include <stdlib.h>		/* malloc, free, rand, srand, atol */
+#include <time.h>		/* clock */
+
+#include "utilities.h"
+#include "pqueue.h"
+#include "pqueue_typed.h"
+
+#define DEFAULT_N 	10000
+#define DEFAULT_OPS 100000
+
+/* timeout extension workload: the clock advances once every
+   TICK_OPS operations */
+#define TIMEOUT 	30
+#define TICK_OPS 	100
+
+/* same intervals as example/sched_ex.c, in seconds */
+static const long g_intervals[] = {1, 2, 3, 5, 12};
+/* how many of g_intervals the current workload uses */
+static size_t g_num_intervals = SIZEOF_ARRAY(g_intervals);
+
+typedef int (*EnqueueFunc)(pqueue_ty *pqueue, void *data);
+typedef int (*ExtendFunc)(pqueue_ty *pqueue, void *data, long new_key);
+
+typedef struct timer
+{
+	long next_run;
+	long interval;
+	pq_link_ty link;
+	size_t heap_idx;
+	pq_heap_node_ty node;
+} timer_ty;
+
+static int CmpTimersGeneric(const void *t1, const void *t2, const void *ignore);
+static int CmpTimersTyped(const timer_ty *t1, const timer_ty *t2, const void *ignore);
+
+PQUEUE_DEFINE(Timer, timer_ty, CmpTimersTyped)
+
+static void RunAll(size_t n, size_t ops);
+static timer_ty *CreateTimers(size_t n);
+static void RunGeneric(const char *name, pqueue_ty *pqueue, EnqueueFunc enqueue,
+													size_t n, size_t ops);
+static void RunTyped(const char *name, size_t n, size_t ops);
+static double BenchGeneric(pqueue_ty *pqueue, EnqueueFunc enqueue,
+							timer_ty *timers, size_t n, size_t ops);
+static double BenchTyped(timer_ty *timers, size_t n, size_t ops);
+static void PrintResult(const char *name, double seconds, size_t ops);
+static void RunExtend(size_t n, size_t ops);
+static void RunExtendOne(const char *name, pqueue_ty *pqueue, ExtendFunc extend,
+													size_t n, size_t ops);
+static double BenchExtend(pqueue_ty *pqueue, ExtendFunc extend,
+							timer_ty *timers, size_t n, size_t ops);
+static int ReAddBack(pqueue_ty *pqueue, void *data, long new_key);
+
+/*******************************************************************************
+********************************** MAIN ***************************************/
+int main(int argc, char *argv[])
+{
+	size_t n = (1 < argc) ? (size_t)atol(argv[1]) : DEFAULT_N;
+	size_t ops = (2 < argc) ? (size_t)atol(argv[2]) : DEFAULT_OPS;
+
+	printf("\n--- PQueue Benchmark N = %lu, OPS = %lu ---\n",
+			(unsigned long)n, (unsigned long)ops);
+
+	puts("\n==> Mixed intervals (1, 2, 3, 5, 12)");
+	RunAll(n, ops);
+
+	puts("\n==> Single interval (1)");
+	g_num_intervals = 1;
+	RunAll(n, ops);
+
+	printf("\n==> Timeout extension (timeout %d, clock tick every %d ops)\n",
+			TIMEOUT, TICK_OPS);
+	RunExtend(n, ops);
+
+	return 0;
+}
+
+static void RunAll(size_t n, size_t ops)
+{
+	RunGeneric("pqueue callback", PQueueCreate(CmpTimersGeneric, NULL),
+				PQueueEnqueue, n, ops);
+	RunGeneric("pqueue keyed", PQueueCreateKeyed(OFFSETOF_SIZE_T(timer_ty, next_run)),
+				PQueueEnqueue, n, ops);
+	RunGeneric("pqueue intrusive", PQueueCreateIntrusive(
+				OFFSETOF_SIZE_T(timer_ty, next_run), OFFSETOF_SIZE_T(timer_ty, link)),
+				PQueueEnqueue, n, ops);
+	RunGeneric("pqueue intrusive back", PQueueCreateIntrusive(
+				OFFSETOF_SIZE_T(timer_ty, next_run), OFFSETOF_SIZE_T(timer_ty, link)),
+				PQueueEnqueueBack, n, ops);
+	RunTyped("PQUEUE_DEFINE typed", n, ops);
+}
+
+static void RunExtend(size_t n, size_t ops)
+{
+	RunExtendOne("sorted list update", PQueueCreateIntrusive(
+				OFFSETOF_SIZE_T(timer_ty, next_run), OFFSETOF_SIZE_T(timer_ty, link)),
+				PQueueUpdateKey, n, ops);
+	RunExtendOne("sorted list re-add back", PQueueCreateIntrusive(
+				OFFSETOF_SIZE_T(timer_ty, next_run), OFFSETOF_SIZE_T(timer_ty, link)),
+				ReAddBack, n, ops);
+	RunExtendOne("4-ary heap indexed", PQueueCreateDAryHeapIndexed(
+				OFFSETOF_SIZE_T(timer_ty, next_run), DHEAP_DEFAULT_ARITY,
+				OFFSETOF_SIZE_T(timer_ty, heap_idx)),
+				PQueueUpdateKey, n, ops);
+	RunExtendOne("pairing heap", PQueueCreatePairingHeap(
+				OFFSETOF_SIZE_T(timer_ty, next_run), OFFSETOF_SIZE_T(timer_ty, node)),
+				PQueueUpdateKey, n, ops);
+}
+
+
+/*******************************************************************************
+****************************** Implementation *********************************/
+static timer_ty *CreateTimers(size_t n)
+{
+	timer_ty *timers = (timer_ty *)malloc(n * sizeof(timer_ty));
+	size_t i = 0;
+
+	if (NULL == timers)
+	{
+		return NULL;
+	}
+
+	/* same seed for every run, so all queues get identical input */
+	srand(50);
+	for (i = 0; i < n; ++i)
+	{
+		timers[i].interval = g_intervals[(size_t)rand() % g_num_intervals];
+		timers[i].next_run = timers[i].interval;
+	}
+
+	return timers;
+}
+
+static void RunGeneric(const char *name, pqueue_ty *pqueue, EnqueueFunc enqueue,
+													size_t n, size_t ops)
+{
+	timer_ty *timers = CreateTimers(n);
+
+	if (NULL == timers || NULL == pqueue)
+	{
+		free(timers);
+		PrintResult(name, -1, ops);
+		return;
+	}
+
+	PrintResult(name, BenchGeneric(pqueue, enqueue, timers, n, ops), ops);
+	free(timers);
+}
+
+static void RunTyped(const char *name, size_t n, size_t ops)
+{
+	timer_ty *timers = CreateTimers(n);
+
+	if (NULL == timers)
+	{
+		PrintResult(name, -1, ops);
+		return;
+	}
+
+	PrintResult(name, BenchTyped(timers, n, ops), ops);
+	free(timers);
+}
+
+static double BenchGeneric(pqueue_ty *pqueue, EnqueueFunc enqueue,
+							timer_ty *timers, size_t n, size_t ops)
+{
+	timer_ty *current = NULL;
+	clock_t start = 0;
+	size_t i = 0;
+
+	start = clock();
+
+	for (i = 0; i < n; ++i)
+	{
+		enqueue(pqueue, &timers[i]);
+	}
+
+	for (i = 0; i < ops; ++i)
+	{
+		current = PQueuePeek(pqueue);
+		PQueueDequeue(pqueue);
+
+		current->next_run += current->interval;
+		enqueue(pqueue, current);
+	}
+
+	start = clock() - start;
+	PQueueDestroy(pqueue);
+
+	return ((double)start / CLOCKS_PER_SEC);
+}
+
+static double BenchTyped(timer_ty *timers, size_t n, size_t ops)
+{
+	Timer_pqueue_ty *pqueue = TimerPQueueCreate(NULL);
+	timer_ty current = {0};
+	clock_t start = 0;
+	size_t i = 0;
+
+	if (NULL == pqueue)
+	{
+		return -1;
+	}
+
+	start = clock();
+
+	for (i = 0; i < n; ++i)
+	{
+		TimerPQueueEnqueue(pqueue, timers[i]);
+	}
+
+	for (i = 0; i < ops; ++i)
+	{
+		current = *TimerPQueuePeek(pqueue);
+		TimerPQueueDequeue(pqueue);
+
+		current.next_run += current.interval;
+		TimerPQueueEnqueue(pqueue, current);
+	}
+
+	start = clock() - start;
+	TimerPQueueDestroy(pqueue);
+
+	return ((double)start / CLOCKS_PER_SEC);
+}
+
+static void RunExtendOne(const char *name, pqueue_ty *pqueue, ExtendFunc extend,
+													size_t n, size_t ops)
+{
+	timer_ty *timers = CreateTimers(n);
+
+	if (NULL == timers || NULL == pqueue)
+	{
+		free(timers);
+		if (NULL != pqueue)
+		{
+			PQueueDestroy(pqueue);
+		}
+		PrintResult(name, -1, ops);
+		return;
+	}
+
+	PrintResult(name, BenchExtend(pqueue, extend, timers, n, ops), ops);
+	free(timers);
+}
+
+static double BenchExtend(pqueue_ty *pqueue, ExtendFunc extend,
+							timer_ty *timers, size_t n, size_t ops)
+{
+	timer_ty *current = NULL;
+	clock_t start = 0;
+	long now = 0;
+	size_t i = 0;
+
+	/* deadlines spread over one timeout */
+	for (i = 0; i < n; ++i)
+	{
+		timers[i].next_run = (long)(i % TIMEOUT) + 1;
+	}
+
+	srand(50);
+	start = clock();
+
+	for (i = 0; i < n; ++i)
+	{
+		PQueueEnqueue(pqueue, &timers[i]);
+	}
+
+	for (i = 0; i < ops; ++i)
+	{
+		/* activity on a random timer pushes its deadline back */
+		extend(pqueue, &timers[(size_t)rand() % n], now + TIMEOUT);
+
+		if (0 != (i + 1) % TICK_OPS)
+		{
+			continue;
+		}
+
+		/* the clock ticks; the timers which expired start over */
+		++now;
+		while (((timer_ty *)PQueuePeek(pqueue))->next_run <= now)
+		{
+			current = PQueuePeek(pqueue);
+			PQueueDequeue(pqueue);
+
+			current->next_run = now + TIMEOUT;
+			PQueueEnqueueBack(pqueue, current);
+		}
+	}
+
+	start = clock() - start;
+	PQueueDestroy(pqueue);
+
+	return ((double)start / CLOCKS_PER_SEC);
+}
+
+/* the remove and add again a sorted list needs without an update key */
+static int ReAddBack(pqueue_ty *pqueue, void *data, long new_key)
+{
+	PQueueUnlink(pqueue, data);
+	((timer_ty *)data)->next_run = new_key;
+
+	return PQueueEnqueueBack(pqueue, data);
+}
+
+static void PrintResult(const char *name, double seconds, size_t ops)
+{
+	if (0 > seconds)
+	{
+		printf("%-24s allocation failure\n", name);
+		return;
+	}
+
+	printf("%-24s %10.4f sec  %10.1f ns/op\n", name, seconds,
+			(0 == ops) ? 0.0 : seconds * 1e9 / ops);
+}
+
+/*------------------------------- Comparators --------------------------------*/
+
+static int CmpTimersGeneric(const void *t1, const void *t2, const void *ignore)
+{
+	UNUSED(ignore);
+
+	return CmpTimersTyped(t1, t2, NULL);
+}
+
+static int CmpTimersTyped(const timer_ty *t1, const timer_ty *t2, const void *ignore)
+{
+	UNUSED(ignore);
+
+	return ((t1->next_run > t2->next_run) - (t1->next_run < t2->next_run));
+}
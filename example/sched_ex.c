@@ -58,11 +58,11 @@ void ExampleSchedRun(void)
 	scheduler_ty *scheduler = NULL;
 	enum run_status_ty exit_status = -1;
 
-    sched_id_ty id_task1 = {0};
-	sched_id_ty id_task2 = {0};
-	sched_id_ty id_task3 = {0};
-	sched_id_ty id_task4 = {0};
-	sched_id_ty id_pause = {0};
+    sched_id_ty id_task1 = SCHED_BAD_ID;
+	sched_id_ty id_task2 = SCHED_BAD_ID;
+	sched_id_ty id_task3 = SCHED_BAD_ID;
+	sched_id_ty id_task4 = SCHED_BAD_ID;
+	sched_id_ty id_pause = SCHED_BAD_ID;
 
 
 	scheduler = SchedCreate();
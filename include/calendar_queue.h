@@ -0,0 +1,146 @@
+/*******************************************************************************
+****************************** - CALENDAR QUEUE - ******************************
+*
+*	DESCRIPTION		API calendar queue - bucketed min priority queue
+*	AUTHOR 			Liad Raz
+*	FILES			calendar_queue.c calendar_queue_test.c calendar_queue.h
+*					slot_pool.c calendar_bench.c
+*
+*******************************************************************************/
+
+#ifndef __CALENDAR_QUEUE_H__
+#define __CALENDAR_QUEUE_H__
+
+#include <stddef.h> 	/* size_t */
+
+/*******************************************************************************
+* A calendar queue hashes each key to a "day" bucket: (key / width) modulo
+* the number of buckets, like dates on a desk calendar whose pages are
+* reused every year. Each bucket is a short sorted list. Taking the minimum
+* scans from the current day forward, so with a width matched to the
+* distance between keys enqueue and dequeue are O(1) on average.
+*
+* The queue resizes itself: the number of buckets doubles when there are
+* more than two elements per bucket and halves below one per two buckets.
+* Every resize re-estimates the width from the separation of the earliest
+* keys. CQueueGetStats reports the current geometry and resize counters.
+*
+* Keys may be pushed in any order. Elements with equal keys are popped in
+* insertion order.
+*******************************************************************************/
+
+/******************************************************************************
+******************************** Typedefs *************************************/
+typedef struct cqueue cqueue_ty;
+typedef long cqueue_key_ty;
+
+typedef struct cqueue_stats
+{
+	size_t num_buckets;			/* current number of buckets */
+	unsigned long width;		/* current key range of one bucket */
+	size_t resizes;				/* grows + shrinks */
+	size_t grows;
+	size_t shrinks;
+	size_t last_resize_size;	/* number of elements at the last resize */
+	size_t direct_searches;		/* dequeues which scanned a whole year */
+} cqueue_stats_ty;
+
+/*******************************************************************************
+* DESCRIPTION	Used in CQueueFind and CQueueErase
+* RETURN		boolean => 1 FOUND;	0 NOT_FOUND
+*******************************************************************************/
+typedef int (*CQueueIsMatch)(const void *element_data, const void *param);
+
+/*******************************************************************************
+* DESCRIPTION	Creates an empty calendar queue.
+* RETURN		NULL when memory allocation failed.
+* IMPORTANT		User needs to free the queue.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+cqueue_ty *CQueueCreate(void);
+
+/*******************************************************************************
+* DESCRIPTION	Frees the queue. Elements are not freed.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+void CQueueDestroy(cqueue_ty *cqueue);
+
+/*******************************************************************************
+* DESCRIPTION	Adds data ordered by key.
+* RETURN		status => 0 SUCCESS; non-zero value memory allocation FAILURE
+* IMPORTANT		A failed resize is not an error; the queue keeps working
+*				with its current buckets.
+*
+* Time Complexity 	O(1) average; O(n) when it resizes
+*******************************************************************************/
+int CQueuePush(cqueue_ty *cqueue, cqueue_key_ty key, void *data);
+
+/*******************************************************************************
+* DESCRIPTION	Removes the element with the smallest key.
+* IMPORTANT		Undefined behavior when queue is empty.
+*
+* Time Complexity 	O(1) average; O(n) when it resizes
+*******************************************************************************/
+void CQueuePop(cqueue_ty *cqueue);
+
+/*******************************************************************************
+* DESCRIPTION	Get the element with the smallest key.
+* RETURN		NULL when queue is empty.
+*
+* Time Complexity 	O(1) average
+*******************************************************************************/
+void *CQueuePeek(cqueue_ty *cqueue);
+
+/*******************************************************************************
+* DESCRIPTION	Obtain the number of elements in the queue.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+size_t CQueueSize(const cqueue_ty *cqueue);
+
+/*******************************************************************************
+* DESCRIPTION	Checks if elements are stored in the queue.
+* RETURN		boolean => 1 EMPTY; 0 NOT EMPTY.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+int CQueueIsEmpty(const cqueue_ty *cqueue);
+
+/*******************************************************************************
+* DESCRIPTION	Removes the first element which matches is_match.
+* RETURN		The removed element; NULL when not found.
+*
+* Time Complexity 	O(n + number_of_buckets)
+*******************************************************************************/
+void *CQueueErase(cqueue_ty *cqueue, CQueueIsMatch is_match, const void *param);
+
+/*******************************************************************************
+* DESCRIPTION	Removes the first element queued with key which matches
+*				is_match; only the bucket (day) of key is searched.
+* RETURN		The removed element; NULL when not found.
+*
+* Time Complexity 	O(1) average
+*******************************************************************************/
+void *CQueueEraseKey(cqueue_ty *cqueue, cqueue_key_ty key, CQueueIsMatch is_match,
+					const void *param);
+
+/*******************************************************************************
+* DESCRIPTION	Looks for the first element which matches is_match; the queue
+*				is not changed.
+* RETURN		The element found; NULL when not found.
+*
+* Time Complexity 	O(n + number_of_buckets)
+*******************************************************************************/
+void *CQueueFind(const cqueue_ty *cqueue, CQueueIsMatch is_match, const void *param);
+
+/*******************************************************************************
+* DESCRIPTION	Copies the queue geometry and resize counters to stats.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+void CQueueGetStats(const cqueue_ty *cqueue, cqueue_stats_ty *stats);
+
+
+#endif /* __CALENDAR_QUEUE_H__ */
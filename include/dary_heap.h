@@ -0,0 +1,164 @@
+/*******************************************************************************
+******************************** - D-ARY HEAP - *******************************
+*
+*	DESCRIPTION		API d-ary implicit min heap with packed keys
+*	AUTHOR 			Liad Raz
+*	FILES			dary_heap.c dary_heap_test.c dary_heap.h bench/heap_bench.c
+*
+*******************************************************************************/
+
+#ifndef __DARY_HEAP_H__
+#define __DARY_HEAP_H__
+
+#include <stddef.h> 	/* size_t */
+
+/*******************************************************************************
+* Elements live in one array of slots. Each slot packs the 64 bit key next to
+* the element pointer, so sift down reads the keys of all 'arity' children
+* from consecutive memory without touching the elements. With the default
+* arity (4) and 16 byte slots, the children of a node fill one cache line;
+* the array is aligned so that every group of siblings starts a cache line.
+*******************************************************************************/
+
+/******************************************************************************
+******************************** Typedefs *************************************/
+typedef struct dheap dheap_ty;
+typedef long dheap_key_ty;
+
+#define DHEAP_DEFAULT_ARITY 4
+
+/*******************************************************************************
+* DESCRIPTION	Used in DHeapFind and DHeapErase
+* RETURN		boolean => 1 FOUND;	0 NOT_FOUND
+*******************************************************************************/
+typedef int (*DHeapIsMatch)(const void *element_data, const void *param);
+
+/*******************************************************************************
+* DESCRIPTION	Creates an empty heap where every node has up to 'arity'
+*				children. arity 2 gives a classic binary heap.
+* RETURN		NULL when memory allocation failed.
+* IMPORTANT		User needs to free the heap.
+*				Undefined behavior when arity is smaller than 2.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+dheap_ty *DHeapCreate(size_t arity);
+
+/*******************************************************************************
+* DESCRIPTION	Creates an empty heap as DHeapCreate, where every element
+*				embeds a size_t index_offset bytes from its address. The heap
+*				keeps the element position there, so DHeapUnlink needs no
+*				search.
+* RETURN		NULL when memory allocation failed.
+* IMPORTANT		User needs to free the heap.
+*				Every move writes to the element: sifts touch element memory,
+*				which the plain heap avoids.
+*				Elements with equal keys are popped in push order; an element
+*				whose key DHeapUpdateKey changed goes behind them.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+dheap_ty *DHeapCreateIndexed(size_t arity, size_t index_offset);
+
+/*******************************************************************************
+* DESCRIPTION	Frees the heap. Elements are not freed.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+void DHeapDestroy(dheap_ty *heap);
+
+/*******************************************************************************
+* DESCRIPTION	Adds data ordered by key.
+* RETURN		status => 0 SUCCESS; non-zero value memory allocation FAILURE
+*
+* Time Complexity 	O(log(n)) amortized
+*******************************************************************************/
+int DHeapPush(dheap_ty *heap, dheap_key_ty key, void *data);
+
+/*******************************************************************************
+* DESCRIPTION	Removes the element with the smallest key.
+* IMPORTANT		Undefined behavior when heap is empty.
+*				Elements with equal keys are popped in unspecified order,
+*				push order in an indexed heap.
+*
+* Time Complexity 	O(arity * log(n) / log(arity))
+*******************************************************************************/
+void DHeapPop(dheap_ty *heap);
+
+/*******************************************************************************
+* DESCRIPTION	Get the element with the smallest key.
+* RETURN		NULL when heap is empty.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+void *DHeapPeek(const dheap_ty *heap);
+
+/*******************************************************************************
+* DESCRIPTION	Get the smallest key.
+* IMPORTANT		Undefined behavior when heap is empty.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+dheap_key_ty DHeapPeekKey(const dheap_ty *heap);
+
+/*******************************************************************************
+* DESCRIPTION	Obtain the number of elements in the heap.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+size_t DHeapSize(const dheap_ty *heap);
+
+/*******************************************************************************
+* DESCRIPTION	Checks if elements are stored in the heap.
+* RETURN		boolean => 1 EMPTY; 0 NOT EMPTY.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+int DHeapIsEmpty(const dheap_ty *heap);
+
+/*******************************************************************************
+* DESCRIPTION	Removes all elements; the array keeps its capacity.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+void DHeapClear(dheap_ty *heap);
+
+/*******************************************************************************
+* DESCRIPTION	Removes the first element which matches is_match.
+* RETURN		The removed element; NULL when not found.
+*
+* Time Complexity 	O(n)
+*******************************************************************************/
+void *DHeapErase(dheap_ty *heap, DHeapIsMatch is_match, const void *param);
+
+/*******************************************************************************
+* DESCRIPTION	Looks for the first element which matches is_match; the heap
+*				is not changed.
+* RETURN		The element found; NULL when not found.
+*
+* Time Complexity 	O(n)
+*******************************************************************************/
+void *DHeapFind(const dheap_ty *heap, DHeapIsMatch is_match, const void *param);
+
+/*******************************************************************************
+* DESCRIPTION	Removes data, found through the index it embeds.
+* IMPORTANT		Undefined behavior when the heap is not indexed or data is
+*				not in the heap; debug builds assert.
+*
+* Time Complexity 	O(arity * log(n) / log(arity))
+*******************************************************************************/
+void DHeapUnlink(dheap_ty *heap, void *data);
+
+/*******************************************************************************
+* DESCRIPTION	Changes the key of data in place; data sifts up when the key
+*				decreased and down when it increased. Nothing is allocated.
+* IMPORTANT		Undefined behavior when data is not in the heap; debug
+*				builds assert.
+*
+* Time Complexity 	O(arity * log(n) / log(arity)) indexed heap; a plain heap
+*					searches for data first, O(n)
+*******************************************************************************/
+void DHeapUpdateKey(dheap_ty *heap, void *data, dheap_key_ty key);
+
+
+#endif /* __DARY_HEAP_H__ */
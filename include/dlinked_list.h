@@ -19,6 +19,10 @@
 
 typedef struct dlist dlist_ty;
 typedef struct dlist_itr dlist_itr_ty;
+typedef struct node node_ty;
+
+/* integer key read in place from element data, see DListFindKey */
+typedef long dlist_key_ty;
 
 
 /*******************************************************************************
@@ -70,6 +74,40 @@ int DListIsSameIter(dlist_itr_ty itr1, dlist_itr_ty itr2);
 dlist_itr_ty DListInsert(dlist_itr_ty where, void *data);
 
 
+/*******************************************************************************
+* DESCRIPTION	Intrusive insert - links a node owned by the user (usually
+*				embedded inside data) before 'where'. Nothing is allocated.
+* RETURN		An iterator to the linked node.
+* IMPORTANT	 	The node must be detached with DListUnlink, never with
+*				DListRemove / Pop, and the dlist must be emptied that way
+*				before it is destroyed.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+dlist_itr_ty DListLink(dlist_itr_ty where, node_ty *node, void *data);
+
+
+/*******************************************************************************
+* DESCRIPTION	Detach an element from dlist without freeing its node.
+*				Counterpart of DListLink.
+* RETURN 		An iterator to the following item which has been detached.
+* IMPORTANT:	Undefined behavior when dlist is empty.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+dlist_itr_ty DListUnlink(dlist_itr_ty where);
+
+
+/*******************************************************************************
+* DESCRIPTION	Get an iterator to a node linked with DListLink, e.g. to
+*				unlink an element through the node it embeds.
+* IMPORTANT:	Undefined behavior when node is not linked in dlist.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+dlist_itr_ty DListItrOf(dlist_ty *dlist, node_ty *node);
+
+
 /*******************************************************************************
 * DESCRIPTION	Remove an element from dlist and frees it from memory.
 * RETURN 		An iterator to the following item which has been removed.
@@ -125,6 +163,21 @@ typedef int (*IsMatchFunc)(const void *data, const void *param);
 dlist_itr_ty DListFind(dlist_itr_ty from, dlist_itr_ty to, IsMatchFunc match_func_p, const void *param);
 
 
+/*******************************************************************************
+* DESCRIPTION	Locate an element by an integer key stored inside its data,
+*				key_offset bytes from the data address. Keys are compared
+*				inline, no callback is invoked.
+* RETURN		is_upper 0 => Iterator to the first key >= key
+*				is_upper 1 => Iterator to the first key >  key
+*				If not found iterator to the end of range.
+* IMPORTANT:	Undefined behavior when range contains END element.
+*
+* Time Complexity 	O(range)
+*******************************************************************************/
+dlist_itr_ty DListFindKey(dlist_itr_ty from, dlist_itr_ty to, size_t key_offset,
+											dlist_key_ty key, int is_upper);
+
+
 /*******************************************************************************
 * DESCRIPTION	Count matched dlist elements data with a data provided by the user.
 *
@@ -242,7 +295,13 @@ void DListPopFront(dlist_ty *dlistrunner);
 /*******************************************************************************
 >>>>>>>>>>>>>>>>>>>>>>>>> AREA 51 - Restricted AREA <<<<<<<<<<<<<<<<<<<<<<<<<<*/
 
-typedef struct node node_ty;
+/* exposed so users can embed a node inside their data, see DListLink */
+struct node
+{
+    void *data;
+    node_ty *next;
+    node_ty *prev;
+};
 
 struct dlist_itr
 {
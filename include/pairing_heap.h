@@ -0,0 +1,161 @@
+/*******************************************************************************
+******************************* - PAIRING HEAP - *******************************
+*
+*	DESCRIPTION		API intrusive pairing min heap with node handles
+*	AUTHOR 			Liad Raz
+*	FILES			pairing_heap.c pairing_heap_test.c pairing_heap.h
+*					pqueue_bench.c
+*
+*******************************************************************************/
+
+#ifndef __PAIRING_HEAP_H__
+#define __PAIRING_HEAP_H__
+
+#include <stddef.h> 	/* size_t */
+
+/*******************************************************************************
+* Every element embeds a pheap_node_ty, node_offset bytes from its address.
+* The node is the element's handle: the heap is a tree of nodes linked
+* through them, so push, meld and decrease-key are O(1) pointer updates and
+* an element is unlinked without a search. Pop pairs the children of the
+* root, O(log(n)) amortized.
+*
+* Nothing is allocated per element: push cannot fail.
+* Elements with equal keys are popped in push order.
+*******************************************************************************/
+
+/******************************************************************************
+******************************** Typedefs *************************************/
+typedef struct pheap pheap_ty;
+typedef struct pheap_node pheap_node_ty;
+typedef long pheap_key_ty;
+
+/*******************************************************************************
+* DESCRIPTION	Used in PHeapFind and PHeapErase
+* RETURN		boolean => 1 FOUND;	0 NOT_FOUND
+*******************************************************************************/
+typedef int (*PHeapIsMatch)(const void *element_data, const void *param);
+
+/*******************************************************************************
+* DESCRIPTION	Creates an empty heap of elements which embed a pheap_node_ty
+*				node_offset bytes from their address.
+* RETURN		NULL when memory allocation failed.
+* IMPORTANT		User needs to free the heap.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+pheap_ty *PHeapCreate(size_t node_offset);
+
+/*******************************************************************************
+* DESCRIPTION	Frees the heap. Elements are not freed.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+void PHeapDestroy(pheap_ty *heap);
+
+/*******************************************************************************
+* DESCRIPTION	Adds data ordered by key, linking its embedded node.
+* IMPORTANT		Undefined behavior when data is already in a heap.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+void PHeapPush(pheap_ty *heap, pheap_key_ty key, void *data);
+
+/*******************************************************************************
+* DESCRIPTION	Removes the element with the smallest key.
+* IMPORTANT		Undefined behavior when heap is empty.
+*
+* Time Complexity 	O(log(n)) amortized
+*******************************************************************************/
+void PHeapPop(pheap_ty *heap);
+
+/*******************************************************************************
+* DESCRIPTION	Get the element with the smallest key.
+* RETURN		NULL when heap is empty.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+void *PHeapPeek(const pheap_ty *heap);
+
+/*******************************************************************************
+* DESCRIPTION	Get the smallest key.
+* IMPORTANT		Undefined behavior when heap is empty.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+pheap_key_ty PHeapPeekKey(const pheap_ty *heap);
+
+/*******************************************************************************
+* DESCRIPTION	Obtain the number of elements in the heap.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+size_t PHeapSize(const pheap_ty *heap);
+
+/*******************************************************************************
+* DESCRIPTION	Checks if elements are stored in the heap.
+* RETURN		boolean => 1 EMPTY; 0 NOT EMPTY.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+int PHeapIsEmpty(const pheap_ty *heap);
+
+/*******************************************************************************
+* DESCRIPTION	Removes all elements. Their nodes are left as they are.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+void PHeapClear(pheap_ty *heap);
+
+/*******************************************************************************
+* DESCRIPTION	Removes the first element which matches is_match.
+* RETURN		The removed element; NULL when not found.
+*
+* Time Complexity 	O(n)
+*******************************************************************************/
+void *PHeapErase(pheap_ty *heap, PHeapIsMatch is_match, const void *param);
+
+/*******************************************************************************
+* DESCRIPTION	Looks for the first element which matches is_match; the heap
+*				is not changed.
+* RETURN		The element found; NULL when not found.
+*
+* Time Complexity 	O(n)
+*******************************************************************************/
+void *PHeapFind(const pheap_ty *heap, PHeapIsMatch is_match, const void *param);
+
+/*******************************************************************************
+* DESCRIPTION	Removes data through its node; its children are paired and
+*				melded back into the heap.
+* IMPORTANT		Undefined behavior when data is not in the heap.
+*
+* Time Complexity 	O(log(n)) amortized
+*******************************************************************************/
+void PHeapUnlink(pheap_ty *heap, void *data);
+
+/*******************************************************************************
+* DESCRIPTION	Changes the key of data in place. A smaller key cuts the
+*				subtree of data and melds it with the root; a bigger or
+*				equal key unlinks data and pushes it again. Either way data
+*				goes behind the elements already at key.
+* IMPORTANT		Undefined behavior when data is not in the heap.
+*
+* Time Complexity 	O(1) for a smaller key; O(log(n)) amortized for a bigger
+*					or equal one
+*******************************************************************************/
+void PHeapUpdateKey(pheap_ty *heap, void *data, pheap_key_ty key);
+
+
+/*******************************************************************************
+* The node is public so elements can embed it; its fields belong to the heap.
+*******************************************************************************/
+struct pheap_node
+{
+	pheap_key_ty key;
+	unsigned long seq;		/* push order among equal keys */
+	pheap_node_ty *child;	/* leftmost child */
+	pheap_node_ty *next;	/* right sibling */
+	pheap_node_ty *prev;	/* left sibling; the parent for a leftmost child */
+};
+
+#endif /* __PAIRING_HEAP_H__ */
@@ -10,8 +10,20 @@
 #ifndef __PQUEUE_H__
 #define __PQUEUE_H__
 
+#include <stddef.h> 	/* size_t */
+
+#include "dlinked_list.h"	/* node_ty */
+#include "dary_heap.h"		/* DHEAP_DEFAULT_ARITY */
+#include "pairing_heap.h"	/* pheap_node_ty */
+
 typedef struct pqueue pqueue_ty;
 
+/* link field embedded in elements of an intrusive pqueue */
+typedef node_ty pq_link_ty;
+
+/* node field embedded in elements of a pairing heap pqueue */
+typedef pheap_node_ty pq_heap_node_ty;
+
 /*******************************************************************************
 * DESCRIPTION	Used in Create
 * RETURN		0 SUCCESS; POSITIVE value obj1 > obj2; NEGATIVE value obj1 < obj2
@@ -28,6 +40,96 @@ typedef int (*PQCmpFunc)(const void *object1, const void *object2, const void *c
 *******************************************************************************/
 pqueue_ty *PQueueCreate(PQCmpFunc cmp_func_p, const void *cmp_param);
 
+/*******************************************************************************
+* DESCRIPTION	Creates pqueue container prioritized by an integer key (long)
+*				stored key_offset bytes inside each element, smallest first.
+*				Keys are compared inline, no comparison callback is used.
+* RETURN		NULL when memory allocation failed.
+* IMPORTANT		User needs to free the allocated list.
+*				Elements with equal keys are dequeued in insertion order.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+pqueue_ty *PQueueCreateKeyed(size_t key_offset);
+
+/*******************************************************************************
+* DESCRIPTION	Creates intrusive keyed pqueue. Every element embeds a
+*				pq_link_ty link_offset bytes from its address, so Enqueue
+*				allocates nothing and cannot fail.
+* RETURN		NULL when memory allocation failed.
+* IMPORTANT		Elements are never freed by the pqueue, Destroy and Clear
+*				only detach them.
+*				An element can be queued in one intrusive pqueue at a time.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+pqueue_ty *PQueueCreateIntrusive(size_t key_offset, size_t link_offset);
+
+/*******************************************************************************
+* DESCRIPTION	Creates keyed pqueue backed by a d-ary implicit heap
+*				(see dary_heap.h). Each heap slot packs the element's key
+*				(long, key_offset bytes inside it) next to its address.
+*				arity 4 (DHEAP_DEFAULT_ARITY) fits a sibling group in one
+*				cache line; arity 2 is a binary heap.
+* RETURN		NULL when memory allocation failed.
+* IMPORTANT		User needs to free the allocated pqueue.
+*				Elements with equal keys are dequeued in unspecified order.
+*				The key of a queued element must not change.
+*				EnqueueBack behaves as Enqueue.
+*
+* Time Complexity 	O(1); Enqueue and Dequeue O(log(pqueue_size))
+*******************************************************************************/
+pqueue_ty *PQueueCreateDAryHeap(size_t key_offset, size_t arity);
+
+/*******************************************************************************
+* DESCRIPTION	Creates a d-ary heap pqueue as PQueueCreateDAryHeap, where
+*				every element also embeds a size_t index_offset bytes from
+*				its address. The heap keeps the element position there, so
+*				PQueueUnlink does not search.
+* RETURN		NULL when memory allocation failed.
+* IMPORTANT		User needs to free the allocated pqueue.
+*				Elements with equal keys are dequeued in insertion order;
+*				PQueueUpdateKey puts the element behind the equal keys.
+*
+* Time Complexity 	O(1); Enqueue, Dequeue and Unlink O(log(pqueue_size))
+*******************************************************************************/
+pqueue_ty *PQueueCreateDAryHeapIndexed(size_t key_offset, size_t arity,
+										size_t index_offset);
+
+/*******************************************************************************
+* DESCRIPTION	Creates keyed pqueue backed by a radix heap (see radix_heap.h),
+*				for monotone keys (long, key_offset bytes inside each element)
+*				such as timers: every key enqueued must not be smaller than
+*				the key of the last peeked or dequeued element.
+* RETURN		NULL when memory allocation failed.
+* IMPORTANT		User needs to free the allocated pqueue.
+*				Enqueue of a smaller key fails; debug builds assert.
+*				Use PQueueSetFloor when the keys' clock is reset.
+*				Elements with equal keys are dequeued in insertion order.
+*				EnqueueBack behaves as Enqueue.
+*
+* Time Complexity 	O(1); Enqueue O(1), Dequeue and Peek O(log(key range))
+*					amortized
+*******************************************************************************/
+pqueue_ty *PQueueCreateRadixHeap(size_t key_offset);
+
+/*******************************************************************************
+* DESCRIPTION	Creates keyed pqueue backed by a pairing heap (see
+*				pairing_heap.h). Every element embeds a pq_heap_node_ty
+*				node_offset bytes from its address, so Enqueue allocates
+*				nothing and cannot fail, and Unlink and UpdateKey act on the
+*				element's node directly.
+* RETURN		NULL when memory allocation failed.
+* IMPORTANT		User needs to free the allocated pqueue.
+*				Elements with equal keys are dequeued in insertion order;
+*				PQueueUpdateKey puts the element behind the equal keys.
+*				EnqueueBack behaves as Enqueue.
+*
+* Time Complexity 	O(1); Enqueue and a smaller key in UpdateKey O(1),
+*					Dequeue and Unlink O(log(pqueue_size)) amortized
+*******************************************************************************/
+pqueue_ty *PQueueCreatePairingHeap(size_t key_offset, size_t node_offset);
+
 /*******************************************************************************
 * DESCRIPTION	Free priority pqueue.
 
@@ -43,6 +145,16 @@ void PQueueDestroy(pqueue_ty *pqueue);
 *******************************************************************************/
 int PQueueEnqueue(pqueue_ty *pqueue, void *data);
 
+/*******************************************************************************
+* DESCRIPTION	Add new element, searching its position from the lowest
+*				priority end of the pqueue. Suits elements expected to land
+*				near the back, e.g. periodic timers rescheduled to now + interval.
+* RETURN		status => 0 SUCCESS; non-zero value FAILURE
+
+* Time Complexity   O(distance from the back of the pqueue)
+*******************************************************************************/
+int PQueueEnqueueBack(pqueue_ty *pqueue, void *data);
+
 /*******************************************************************************
 * DESCRIPTION	Remove element from priority pqueue and frees it from memory.
 
@@ -80,7 +192,7 @@ size_t PQueueSize(const pqueue_ty *pqueue);
 void PQueueClear(pqueue_ty *pqueue);
 
 /*******************************************************************************
-* DESCRIPTION	Used in PQueueErase
+* DESCRIPTION	Used in PQueueErase and PQueueFind
 * RETURN		boolean => 1 FOUND;	0 NOT_FOUND
 *******************************************************************************/
 typedef int (*PQIsMatch)(const void *element_data, const void *param);
@@ -94,6 +206,54 @@ typedef int (*PQIsMatch)(const void *element_data, const void *param);
 *******************************************************************************/
 void *PQueueErase(pqueue_ty *pqueue, PQIsMatch match_func_p, void *cmp_param);
 
+/*******************************************************************************
+* DESCRIPTION	Get specific element in pqueue without removing it.
+* RETURN		NULL if cmp_param is not found
+				Undefined behavior when match_func_p is invalid.
+
+* Time Complexity   O(pqueue_size)
+*******************************************************************************/
+void *PQueueFind(const pqueue_ty *pqueue, PQIsMatch match_func_p, void *cmp_param);
+
+/*******************************************************************************
+* DESCRIPTION	Remove the element data points to, comparing by address.
+* IMPORTANT		Undefined behavior when data is not queued in pqueue.
+*
+* Time Complexity   O(1) for an intrusive pqueue; O(log(pqueue_size)) for an
+*					indexed d-ary heap or a pairing heap (amortized); a radix
+*					heap searches the bucket of the element's key only;
+*					O(pqueue_size) otherwise
+*******************************************************************************/
+void PQueueUnlink(pqueue_ty *pqueue, void *data);
+
+/*******************************************************************************
+* DESCRIPTION	Moves a queued element to the position of new_key and writes
+*				new_key to the element's key field, without a dequeue and
+*				enqueue of the element.
+* RETURN		status => 0 SUCCESS; non-zero value FAILURE: radix heap and
+*				new_key below its floor, the element stays queued with its
+*				old key. Nothing is allocated, so no other failure.
+* IMPORTANT		Keyed pqueues only (not PQueueCreate).
+*				Undefined behavior when data is not queued in pqueue.
+*
+* Time Complexity   O(distance moved) for an intrusive pqueue;
+*					O(log(pqueue_size)) for an indexed d-ary heap; O(1) for
+*					a smaller key in a pairing heap, O(log(pqueue_size))
+*					amortized for a bigger one; as PQueueUnlink plus Enqueue
+*					otherwise
+*******************************************************************************/
+int PQueueUpdateKey(pqueue_ty *pqueue, void *data, long new_key);
+
+/*******************************************************************************
+* DESCRIPTION	Sets the smallest key a radix heap pqueue accepts, so keys
+*				smaller than the last dequeued one can be enqueued again.
+*				No-op for the other pqueues.
+* IMPORTANT		Undefined behavior when floor is bigger than a queued key.
+*
+* Time Complexity   O(pqueue_size) for a radix heap pqueue; O(1) otherwise
+*******************************************************************************/
+void PQueueSetFloor(pqueue_ty *pqueue, long floor);
+
 
 #endif /* __PQUEUE_H__ */
 
@@ -0,0 +1,258 @@
+/*******************************************************************************
+************************* - TYPED PRIORITY QUEUE - *****************************
+*
+*	DESCRIPTION		Compile time generated, type specialized priority queue
+*	AUTHOR 			Liad Raz
+*	FILES			pqueue_typed.h pqueue_typed_test.c pqueue_bench.c
+*
+*******************************************************************************/
+
+#ifndef __PQUEUE_TYPED_H__
+#define __PQUEUE_TYPED_H__
+
+#include <stdlib.h> 	/* malloc, realloc, free, size_t */
+#include <assert.h>		/* assert */
+
+/*******************************************************************************
+* PQUEUE_DEFINE(Name, type, cmp) generates a priority queue of 'type' elements.
+*
+* Elements are copied into one contiguous array (binary heap), so there is no
+* per element allocation and no void * indirection. 'cmp' is a function or
+* macro with the PQCmpFunc contract, called directly so it can be inlined:
+*
+*		int cmp(const type *obj1, const type *obj2, const void *cmp_param);
+*		0 SUCCESS; POSITIVE value obj1 > obj2; NEGATIVE value obj1 < obj2
+*
+* Like pqueue_ty, the smallest element is the first out and elements that
+* compare equal are dequeued in insertion order.
+*
+* Generated API (Name is pasted as a prefix, e.g. TaskPQueueCreate):
+*	Name##_pqueue_ty	*Name##PQueueCreate(const void *cmp_param)		O(1)
+*	void				Name##PQueueDestroy(Name##_pqueue_ty *pq)		O(1)
+*	int					Name##PQueueEnqueue(pq, type data)				O(log n)
+*						status => 0 SUCCESS; non-zero memory allocation FAILURE
+*	void				Name##PQueueDequeue(pq)							O(log n)
+*	type				*Name##PQueuePeek(pq)							O(1)
+*						pointer is valid until the next Enqueue/Dequeue/Erase
+*	int					Name##PQueueIsEmpty(pq)							O(1)
+*	size_t				Name##PQueueSize(pq)							O(1)
+*	void				Name##PQueueClear(pq)							O(1)
+*	int					Name##PQueueErase(pq, is_match, param, type *out)	O(n)
+*						status => 0 FOUND (copied to out when not NULL);
+*						1 NOT_FOUND
+*
+* IMPORTANT		Peek and Dequeue on an empty queue are undefined behavior.
+*******************************************************************************/
+
+#ifdef __GNUC__
+	#define PQT_FUNC_IMP static __inline__ __attribute__((unused))
+#else
+	#define PQT_FUNC_IMP static
+#endif
+
+#define PQT_INIT_CAPACITY 16
+
+#define PQUEUE_DEFINE(Name, type, cmp)											\
+																				\
+typedef struct Name##_pq_slot													\
+{																				\
+	type data;																	\
+	size_t seq;		/* insertion order, breaks ties of equal elements */		\
+} Name##_pq_slot_ty;															\
+																				\
+typedef struct Name##_pqueue													\
+{																				\
+	Name##_pq_slot_ty *slots;													\
+	size_t size;																\
+	size_t capacity;															\
+	size_t next_seq;															\
+	const void *cmp_param;														\
+} Name##_pqueue_ty;																\
+																				\
+typedef int (*Name##PQIsMatch)(const type *element_data, const void *param);	\
+																				\
+/* 1 when slot 'a' must come out before slot 'b' */								\
+PQT_FUNC_IMP int Name##PQIsBeforeImp(const Name##_pqueue_ty *pq,				\
+						const Name##_pq_slot_ty *a, const Name##_pq_slot_ty *b)	\
+{																				\
+	int res = cmp(&a->data, &b->data, pq->cmp_param);							\
+																				\
+	return ((res < 0) || (0 == res && a->seq < b->seq));						\
+}																				\
+																				\
+PQT_FUNC_IMP void Name##PQSiftUpImp(Name##_pqueue_ty *pq, size_t idx)			\
+{																				\
+	Name##_pq_slot_ty to_place = pq->slots[idx];								\
+																				\
+	while (0 < idx &&															\
+		Name##PQIsBeforeImp(pq, &to_place, &pq->slots[(idx - 1) / 2]))			\
+	{																			\
+		pq->slots[idx] = pq->slots[(idx - 1) / 2];								\
+		idx = (idx - 1) / 2;													\
+	}																			\
+																				\
+	pq->slots[idx] = to_place;													\
+}																				\
+																				\
+PQT_FUNC_IMP void Name##PQSiftDownImp(Name##_pqueue_ty *pq, size_t idx)		\
+{																				\
+	Name##_pq_slot_ty to_place = pq->slots[idx];								\
+	size_t child = 0;															\
+																				\
+	while ((child = 2 * idx + 1) < pq->size)									\
+	{																			\
+		/* pick the child that comes out first */								\
+		if (child + 1 < pq->size &&												\
+			Name##PQIsBeforeImp(pq, &pq->slots[child + 1], &pq->slots[child]))	\
+		{																		\
+			++child;															\
+		}																		\
+																				\
+		if (!Name##PQIsBeforeImp(pq, &pq->slots[child], &to_place))				\
+		{																		\
+			break;																\
+		}																		\
+																				\
+		pq->slots[idx] = pq->slots[child];										\
+		idx = child;															\
+	}																			\
+																				\
+	pq->slots[idx] = to_place;													\
+}																				\
+																				\
+PQT_FUNC_IMP Name##_pqueue_ty *Name##PQueueCreate(const void *cmp_param)		\
+{																				\
+	Name##_pqueue_ty *pq = (Name##_pqueue_ty *)malloc(sizeof(Name##_pqueue_ty));\
+																				\
+	if (NULL == pq)																\
+	{																			\
+		return NULL;															\
+	}																			\
+																				\
+	pq->slots = (Name##_pq_slot_ty *)											\
+				malloc(PQT_INIT_CAPACITY * sizeof(Name##_pq_slot_ty));			\
+	if (NULL == pq->slots)														\
+	{																			\
+		free(pq);																\
+		return NULL;															\
+	}																			\
+																				\
+	pq->size = 0;																\
+	pq->capacity = PQT_INIT_CAPACITY;											\
+	pq->next_seq = 0;															\
+	pq->cmp_param = cmp_param;													\
+																				\
+	return pq;																	\
+}																				\
+																				\
+PQT_FUNC_IMP void Name##PQueueDestroy(Name##_pqueue_ty *pq)						\
+{																				\
+	assert (NULL != pq && "Typed PQueue is not allocated");						\
+																				\
+	free(pq->slots);															\
+	free(pq);																	\
+}																				\
+																				\
+PQT_FUNC_IMP int Name##PQueueEnqueue(Name##_pqueue_ty *pq, type data)			\
+{																				\
+	Name##_pq_slot_ty *grown = NULL;											\
+																				\
+	assert (NULL != pq && "Typed PQueue is not allocated");						\
+																				\
+	/* double the array when full */											\
+	if (pq->size == pq->capacity)												\
+	{																			\
+		grown = (Name##_pq_slot_ty *)realloc(pq->slots,							\
+						2 * pq->capacity * sizeof(Name##_pq_slot_ty));			\
+		if (NULL == grown)														\
+		{																		\
+			return 1;															\
+		}																		\
+		pq->slots = grown;														\
+		pq->capacity *= 2;														\
+	}																			\
+																				\
+	pq->slots[pq->size].data = data;											\
+	pq->slots[pq->size].seq = pq->next_seq++;									\
+	++pq->size;																	\
+	Name##PQSiftUpImp(pq, pq->size - 1);										\
+																				\
+	return 0;																	\
+}																				\
+																				\
+PQT_FUNC_IMP void Name##PQueueDequeue(Name##_pqueue_ty *pq)						\
+{																				\
+	assert (NULL != pq && "Typed PQueue is not allocated");						\
+	assert (0 != pq->size && "Typed PQueue: Cannot dequeue an empty queue");	\
+																				\
+	--pq->size;																	\
+	if (0 != pq->size)															\
+	{																			\
+		pq->slots[0] = pq->slots[pq->size];										\
+		Name##PQSiftDownImp(pq, 0);												\
+	}																			\
+}																				\
+																				\
+PQT_FUNC_IMP type *Name##PQueuePeek(Name##_pqueue_ty *pq)						\
+{																				\
+	assert (NULL != pq && "Typed PQueue is not allocated");						\
+	assert (0 != pq->size && "Typed PQueue: Cannot peek an empty queue");		\
+																				\
+	return &pq->slots[0].data;													\
+}																				\
+																				\
+PQT_FUNC_IMP int Name##PQueueIsEmpty(const Name##_pqueue_ty *pq)				\
+{																				\
+	assert (NULL != pq && "Typed PQueue is not allocated");						\
+																				\
+	return (0 == pq->size);														\
+}																				\
+																				\
+PQT_FUNC_IMP size_t Name##PQueueSize(const Name##_pqueue_ty *pq)				\
+{																				\
+	assert (NULL != pq && "Typed PQueue is not allocated");						\
+																				\
+	return pq->size;															\
+}																				\
+																				\
+PQT_FUNC_IMP void Name##PQueueClear(Name##_pqueue_ty *pq)						\
+{																				\
+	assert (NULL != pq && "Typed PQueue is not allocated");						\
+																				\
+	pq->size = 0;																\
+}																				\
+																				\
+PQT_FUNC_IMP int Name##PQueueErase(Name##_pqueue_ty *pq,						\
+					Name##PQIsMatch is_match, const void *param, type *out)		\
+{																				\
+	size_t idx = 0;																\
+																				\
+	assert (NULL != pq && "Typed PQueue is not allocated");						\
+	assert (NULL != is_match && "Typed PQueue: Function pointer is invalid");	\
+																				\
+	for (idx = 0; idx < pq->size; ++idx)										\
+	{																			\
+		if (is_match(&pq->slots[idx].data, param))								\
+		{																		\
+			if (NULL != out)													\
+			{																	\
+				*out = pq->slots[idx].data;										\
+			}																	\
+																				\
+			/* fill the hole with the last slot and restore heap order */		\
+			--pq->size;															\
+			if (idx != pq->size)												\
+			{																	\
+				pq->slots[idx] = pq->slots[pq->size];							\
+				Name##PQSiftUpImp(pq, idx);										\
+				Name##PQSiftDownImp(pq, idx);									\
+			}																	\
+																				\
+			return 0;															\
+		}																		\
+	}																			\
+																				\
+	return 1;																	\
+}
+
+#endif /* __PQUEUE_TYPED_H__ */
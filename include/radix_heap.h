@@ -0,0 +1,156 @@
+/*******************************************************************************
+******************************** - RADIX HEAP - *******************************
+*
+*	DESCRIPTION		API radix heap - monotone min priority queue
+*	AUTHOR 			Liad Raz
+*	FILES			radix_heap.c radix_heap_test.c radix_heap.h slot_pool.c
+*					heap_bench.c
+*
+*******************************************************************************/
+
+#ifndef __RADIX_HEAP_H__
+#define __RADIX_HEAP_H__
+
+#include <stddef.h> 	/* size_t */
+
+/*******************************************************************************
+* A radix heap accepts only keys which are not smaller than the last key it
+* handed out (the floor). Timers fit: a task popped at time t is pushed back
+* at t + interval. Elements are kept in one bucket per bit position of
+* (key XOR floor), so push is O(1) and each element moves to a lower bucket
+* at most once per bit: pop is O(log(C)) amortized, C the key range.
+*
+* Elements with equal keys are popped in insertion order.
+*******************************************************************************/
+
+/******************************************************************************
+******************************** Typedefs *************************************/
+typedef struct rheap rheap_ty;
+typedef long rheap_key_ty;
+
+/*******************************************************************************
+* DESCRIPTION	Used in RHeapFind and RHeapErase
+* RETURN		boolean => 1 FOUND;	0 NOT_FOUND
+*******************************************************************************/
+typedef int (*RHeapIsMatch)(const void *element_data, const void *param);
+
+/*******************************************************************************
+* DESCRIPTION	Creates an empty radix heap; its floor is the smallest key.
+* RETURN		NULL when memory allocation failed.
+* IMPORTANT		User needs to free the heap.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+rheap_ty *RHeapCreate(void);
+
+/*******************************************************************************
+* DESCRIPTION	Frees the heap. Elements are not freed.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+void RHeapDestroy(rheap_ty *heap);
+
+/*******************************************************************************
+* DESCRIPTION	Adds data ordered by key.
+* RETURN		status => 0 SUCCESS; non-zero value FAILURE: memory allocation
+*				failed, or key is smaller than the floor.
+* IMPORTANT		key must not be smaller than the last peeked or popped key.
+*				Debug builds assert it.
+*
+* Time Complexity 	O(1) amortized
+*******************************************************************************/
+int RHeapPush(rheap_ty *heap, rheap_key_ty key, void *data);
+
+/*******************************************************************************
+* DESCRIPTION	Removes the element with the smallest key.
+* IMPORTANT		Undefined behavior when heap is empty.
+*
+* Time Complexity 	O(log(C)) amortized
+*******************************************************************************/
+void RHeapPop(rheap_ty *heap);
+
+/*******************************************************************************
+* DESCRIPTION	Get the element with the smallest key. Raises the floor to
+*				its key.
+* RETURN		NULL when heap is empty.
+*
+* Time Complexity 	O(log(C)) amortized
+*******************************************************************************/
+void *RHeapPeek(rheap_ty *heap);
+
+/*******************************************************************************
+* DESCRIPTION	Get the smallest key. Raises the floor to it.
+* IMPORTANT		Undefined behavior when heap is empty.
+*
+* Time Complexity 	O(log(C)) amortized
+*******************************************************************************/
+rheap_key_ty RHeapPeekKey(rheap_ty *heap);
+
+/*******************************************************************************
+* DESCRIPTION	Lowers the floor, so smaller keys can be pushed again, e.g.
+*				when the clock the keys are measured by is reset.
+* IMPORTANT		Undefined behavior when floor is bigger than a queued key.
+*				No-op when floor equals the current floor.
+*
+* Time Complexity 	O(n)
+*******************************************************************************/
+void RHeapSetFloor(rheap_ty *heap, rheap_key_ty floor);
+
+/*******************************************************************************
+* DESCRIPTION	Get the floor: the smallest key RHeapPush accepts.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+rheap_key_ty RHeapGetFloor(const rheap_ty *heap);
+
+/*******************************************************************************
+* DESCRIPTION	Obtain the number of elements in the heap.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+size_t RHeapSize(const rheap_ty *heap);
+
+/*******************************************************************************
+* DESCRIPTION	Checks if elements are stored in the heap.
+* RETURN		boolean => 1 EMPTY; 0 NOT EMPTY.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+int RHeapIsEmpty(const rheap_ty *heap);
+
+/*******************************************************************************
+* DESCRIPTION	Removes all elements and resets the floor to the smallest key.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+void RHeapClear(rheap_ty *heap);
+
+/*******************************************************************************
+* DESCRIPTION	Removes the first element which matches is_match.
+* RETURN		The removed element; NULL when not found.
+*
+* Time Complexity 	O(n)
+*******************************************************************************/
+void *RHeapErase(rheap_ty *heap, RHeapIsMatch is_match, const void *param);
+
+/*******************************************************************************
+* DESCRIPTION	Removes the first element queued with key which matches
+*				is_match; only the bucket key falls in is searched.
+* RETURN		The removed element; NULL when not found.
+*
+* Time Complexity 	O(elements in the bucket of key)
+*******************************************************************************/
+void *RHeapEraseKey(rheap_ty *heap, rheap_key_ty key, RHeapIsMatch is_match,
+					const void *param);
+
+/*******************************************************************************
+* DESCRIPTION	Looks for the first element which matches is_match; the heap
+*				and its floor are not changed.
+* RETURN		The element found; NULL when not found.
+*
+* Time Complexity 	O(n)
+*******************************************************************************/
+void *RHeapFind(const rheap_ty *heap, RHeapIsMatch is_match, const void *param);
+
+
+#endif /* __RADIX_HEAP_H__ */
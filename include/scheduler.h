@@ -3,7 +3,9 @@
 *
 *	DESCRIPTION		API Project Scheduler - Tasks handling
 *	AUTHOR          Liad Raz
-*	FILES			scheduler.c scheduler_test.c scheduler.h
+*	FILES			scheduler.c sched_map.c sched_journal.c sched_shm.c
+*					sched_stats.c scheduler_test.c scheduler.h
+*					schedtop.c
 *
 *******************************************************************************/
 
@@ -11,11 +13,24 @@
 #define __SCHEDULER_H__
 
 #include <stddef.h> /* size_t */
+#include <stdio.h> /* FILE */
+#include <time.h> /* time_t */
 
-#include "uid.h" /* uid_ty, UIDGenerate, UIDIsSame */
+#include "calendar_queue.h" /* cqueue_stats_ty */
 
 typedef struct scheduler scheduler_ty;
-typedef uid_ty sched_id_ty;
+typedef struct sched_shm sched_shm_ty;
+typedef struct sched_stats_view sched_stats_view_ty;
+
+/* Task id: a slot index in the low 32 bits and the slot generation in the
+   high 32 bits. An id leads straight to its task, and once the task is freed
+   its slot generation moves on, so the old id is stale even after the slot
+   is reused, until that slot went through all 2^32 - 1 generations.
+   Builds where unsigned long is not 64 bits wide (LLP64, 32-bit targets) are
+   not supported: scheduler.c fails to compile there. */
+typedef unsigned long sched_id_ty;
+
+#define SCHED_BAD_ID ((sched_id_ty)0)
 
 enum run_status_ty
 {
@@ -23,6 +38,16 @@ enum run_status_ty
 	STOPPED = 1
 };
 
+enum sched_engine_ty
+{
+	SCHED_ENGINE_PQUEUE = 0,
+	SCHED_ENGINE_FIFO = 1,
+	SCHED_ENGINE_RADIX = 2,
+	SCHED_ENGINE_CALENDAR = 3,
+	SCHED_ENGINE_ADAPTIVE = 4,
+	SCHED_ENGINE_PAIRING = 5
+};
+
 /*******************************************************************************
 * DESCRIPTION	Creates a new scheduler.
 * RETURN		NULL when memory allocation failed.
@@ -34,7 +59,9 @@ scheduler_ty *SchedCreate(void);
 
 
 /*******************************************************************************
-* DESCRIPTION	Frees the scheduler and the tasks it contains
+* DESCRIPTION	Frees the scheduler and the tasks it contains. Tasks of a
+*				mapped scheduler (see SchedMapOpen) stay in the file, which
+*				is synced and unmapped.
 *
 * Time Complexity 	O(n)
 *******************************************************************************/
@@ -60,7 +87,7 @@ typedef int (*TaskFunc)(void *params);
 
 /*******************************************************************************
 * DESCRIPTION	Adds task to scheduler regarding its priority value
-* RETURN	 	BAD_UID when creation fails
+* RETURN	 	SCHED_BAD_ID when creation fails
 *
 * Time Complexity 	O(n)
 *******************************************************************************/
@@ -68,12 +95,93 @@ sched_id_ty SchedAdd(scheduler_ty *scheduler, TaskFunc add_task, void *params, t
 
 
 /*******************************************************************************
-* DESCRIPTION	Removes task from scheduler
-* RETURN	 	status => 0 SUCCESS; non-zero value FAILURE
+* DESCRIPTION	Removes task from scheduler. With lazy remove on (see
+*				SchedSetLazyRemove) the task is only marked cancelled.
+* RETURN	 	status => 0 SUCCESS; non-zero value FAILURE, including an id
+*				of a task which was already removed or ran for the last time
 *
-* Time Complexity 	O(n)
+* Time Complexity 	O(1) lazy remove, PQUEUE and FIFO engines; O(log(n))
+*					ADAPTIVE above 32 tasks; O(1) average CALENDAR; RADIX
+*					searches the tasks due in the same power-of-two range
+*******************************************************************************/
+int SchedRemove(scheduler_ty *scheduler, sched_id_ty to_remove);
+
+
+/*******************************************************************************
+* DESCRIPTION	Checks whether the task of id is in the scheduler.
+* RETURN	 	boolean => 1 FOUND; 0 NOT_FOUND, the task was removed (or
+*				cancelled) or returned non-zero from its last run
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+int SchedFind(const scheduler_ty *scheduler, sched_id_ty id);
+
+
+/*******************************************************************************
+* DESCRIPTION	Obtain when the task of id runs next, in seconds of scheduler
+*				time: since SchedRun started it; tasks added before SchedRun
+*				count from 0.
+* RETURN	 	status => 0 SUCCESS; non-zero value task not found, next_run
+*				is untouched
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+int SchedGetNextRun(const scheduler_ty *scheduler, sched_id_ty id, time_t *next_run);
+
+
+/*******************************************************************************
+* DESCRIPTION	Replaces the params the task of id is called with, from its
+*				next run on.
+* RETURN	 	status => 0 SUCCESS; non-zero value task not found
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+int SchedSetParams(scheduler_ty *scheduler, sched_id_ty id, void *params);
+
+
+/*******************************************************************************
+* DESCRIPTION	Moves the next run of the task of id to next_run, in scheduler
+*				time (see SchedGetNextRun); a time already passed runs it as
+*				soon as possible. The task keeps its id and its place in the
+*				engine is updated in place, e.g. to extend a timeout.
+*				Called by the running task on itself, next_run replaces
+*				now + interval once the task returns 0.
+* RETURN	 	status => 0 SUCCESS; non-zero value task not found, or
+*				the CALENDAR engine failed to allocate and removed the task
+*
+* Time Complexity 	O(1) FIFO engine; O(log(n)) ADAPTIVE above 32 tasks;
+*					O(distance moved) sorted pqueue; as SchedRemove plus
+*					SchedAdd without the allocation, otherwise
+*******************************************************************************/
+int SchedReschedule(scheduler_ty *scheduler, sched_id_ty id, time_t next_run);
+
+
+/*******************************************************************************
+* DESCRIPTION	Changes the interval of the task of id. The pending run keeps
+*				its distance from when it was scheduled: it moves by the
+*				difference between the intervals (not before now).
+*				The running task only picks up the new interval.
+* RETURN	 	status => 0 SUCCESS; non-zero value as SchedReschedule
+* IMPORTANT		interval can not be zero.
+*
+* Time Complexity 	as SchedReschedule
 *******************************************************************************/
-int SchedRemove(scheduler_ty *scheduler, uid_ty to_remove);
+int SchedSetInterval(scheduler_ty *scheduler, sched_id_ty id, time_t interval);
+
+
+/*******************************************************************************
+* DESCRIPTION	Turns lazy remove on (non-zero is_lazy) or off (default).
+*				When on, SchedRemove marks the task cancelled and leaves the
+*				queue untouched. SchedRun drops a cancelled task when it
+*				reaches the head, without waiting for its time, and once
+*				cancelled tasks exceed a quarter of the queue SchedRun and
+*				SchedAdd rebuild the queue without them.
+*				Suits timeouts which are mostly cancelled before they fire.
+* IMPORTANT		Cancelled tasks are not counted by SchedSize and SchedIsEmpty.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+void SchedSetLazyRemove(scheduler_ty *scheduler, int is_lazy);
 
 
 /*******************************************************************************
@@ -110,5 +218,495 @@ int SchedIsEmpty(scheduler_ty *scheduler);
 void SchedClear(scheduler_ty *scheduler);
 
 
+/*******************************************************************************
+* DESCRIPTION	Selects the structure which orders the scheduler tasks.
+*				SCHED_ENGINE_ADAPTIVE	(default) sorted pqueue while there are
+*									up to 32 tasks, a 4-ary heap above;
+*									back to the sorted pqueue under 16.
+*									Tasks migrate as SchedSize changes;
+*									tasks due the same second run in the
+*									order they were queued on both.
+*				SCHED_ENGINE_PQUEUE	one sorted pqueue for all tasks.
+*				SCHED_ENGINE_FIFO	one FIFO per distinct interval (up to 16
+*									with tasks at a time) and a small heap
+*									over the FIFO heads; add and reschedule
+*									are O(1). Other intervals fall back to
+*									the pqueue.
+*				SCHED_ENGINE_RADIX	radix heap over next_run; relies on the
+*									scheduler clock never going back while
+*									running. Add O(1), next task O(log(time
+*									range)) amortized.
+*				SCHED_ENGINE_CALENDAR	calendar queue over next_run; time
+*									buckets resized to the number of tasks
+*									and their spread. Add and next task O(1)
+*									average; suits millions of tasks. Tasks
+*									due the same second run in the order
+*									they were queued.
+*				SCHED_ENGINE_PAIRING	pairing heap over next_run. Add and
+*									an earlier SchedReschedule O(1), next
+*									task and remove O(log(n)) amortized;
+*									suits timeouts which are mostly
+*									extended or removed before they run.
+*									Tasks due the same second run in the
+*									order they were queued.
+* RETURN	 	status => 0 SUCCESS; non-zero value FAILURE
+* IMPORTANT		Engine can be changed only while the scheduler is empty and
+*				not running.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+int SchedSetEngine(scheduler_ty *scheduler, enum sched_engine_ty engine);
+
+
+/*******************************************************************************
+* DESCRIPTION	Copies the calendar engine geometry (buckets, width) and its
+*				resize counters to stats; see cqueue_stats_ty.
+* RETURN	 	status => 0 SUCCESS; non-zero value the engine is not
+*				SCHED_ENGINE_CALENDAR, stats is untouched.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+int SchedGetCalendarStats(const scheduler_ty *scheduler, cqueue_stats_ty *stats);
+
+
+/*******************************************************************************
+* DESCRIPTION	Used in SchedSetHooks. id and params are of the task;
+*				hook_params are of the hooks. status is what the task
+*				returned.
+*******************************************************************************/
+typedef void (*SchedHookFunc)(sched_id_ty id, void *params, void *hook_params);
+typedef void (*SchedPostHookFunc)(sched_id_ty id, void *params, int status,
+								void *hook_params);
+
+typedef struct sched_hooks
+{
+	SchedHookFunc pre_dispatch;		/* right before a task runs */
+	SchedPostHookFunc post_dispatch;	/* right after, before it is
+										   rescheduled or freed */
+	SchedHookFunc on_remove;		/* when a task is freed */
+	void *hook_params;
+} sched_hooks_ty;
+
+/*******************************************************************************
+* DESCRIPTION	Sets the hooks SchedRun calls around every task it runs, and
+*				the hook called whenever the scheduler frees a task: a task
+*				removed, one which returned non-zero, and every task on
+*				SchedClear and SchedDestroy. A lazily removed task (see
+*				SchedSetLazyRemove) is freed when it leaves the queue.
+*				on_remove is not called for the tasks SchedDestroy leaves
+*				in a mapped file, nor for the removals SchedJournalReplay
+*				applies: they were reported when they happened.
+*				A NULL member is not called; NULL hooks clears them all.
+*				The hooks are copied: nothing is allocated, and a hook not
+*				set costs SchedRun a single test.
+* IMPORTANT		pre_dispatch and post_dispatch may use the scheduler as a
+*				task does. on_remove must not add or remove tasks.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+void SchedSetHooks(scheduler_ty *scheduler, const sched_hooks_ty *hooks);
+
+
+/* Used in SchedGetTaskStats. CPU time is of the thread running SchedRun,
+   in ns, from right before the task function to right after it. */
+typedef struct sched_task_stats
+{
+	unsigned long runs;
+	unsigned long failures;		/* runs which returned non-zero */
+	unsigned long cpu_ns;
+	unsigned long max_cpu_ns;	/* of a single run */
+} sched_task_stats_ty;
+
+/*******************************************************************************
+* DESCRIPTION	Turns per task accounting on (non-zero is_on) or off
+*				(default). When on, SchedRun reads CLOCK_THREAD_CPUTIME_ID
+*				around every task and counts its runs, failures, CPU time
+*				and longest run in a table apart from the tasks, one entry
+*				per id slot. Turning it off stops counting; the counts stay.
+* IMPORTANT		Accounting adds two clock reads to every run.
+*
+* Time Complexity 	O(1); the table grows with the slots while running
+*******************************************************************************/
+void SchedSetTaskStats(scheduler_ty *scheduler, int is_on);
+
+/*******************************************************************************
+* DESCRIPTION	Copies the counts of the task of id to stats; all 0 before
+*				its first run with accounting on. The counts of a freed
+*				task (a failure, for one) are kept until another task in
+*				its slot runs.
+* RETURN	 	status => 0 SUCCESS; non-zero value FAILURE: id is stale and
+*				its counts are gone, stats is untouched.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+int SchedGetTaskStats(const scheduler_ty *scheduler, sched_id_ty id,
+					sched_task_stats_ty *stats);
+
+
+/*******************************************************************************
+* DESCRIPTION	Limits the time SchedRun runs tasks back to back after it
+*				wakes up to budget_ms; 0 (default) does not limit it. Once
+*				the budget is spent, the tasks due are deferred to the next
+*				second. They keep their time, so they run before the tasks
+*				which ran meanwhile, the earliest due first. The first task
+*				of a wakeup always runs.
+*
+* Time Complexity 	O(1); SchedRun reads a monotonic clock per task
+*******************************************************************************/
+void SchedSetBudget(scheduler_ty *scheduler, unsigned long budget_ms);
+
+/*******************************************************************************
+* DESCRIPTION	Makes SchedAdd return SCHED_BAD_ID, and drops a task added
+*				through the shared segment (see SchedShmCreate), while
+*				SchedSize is max_size or more; 0 (default) does not limit
+*				it. Tasks queued already are kept when max_size is lowered.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+void SchedSetMaxSize(scheduler_ty *scheduler, size_t max_size);
+
+/* Used in SchedGetLoadStats; counted since SchedCreate. A task deferred by
+   the budget is counted when it runs, once however many times it waited. */
+typedef struct sched_load_stats
+{
+	unsigned long num_deferred;
+	unsigned long num_rejected;		/* adds turned away by the max size */
+} sched_load_stats_ty;
+
+/*******************************************************************************
+* DESCRIPTION	Copies the counts of tasks deferred and rejected to stats.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+void SchedGetLoadStats(const scheduler_ty *scheduler, sched_load_stats_ty *stats);
+
+
+/*******************************************************************************
+* DESCRIPTION	Used in SchedSave and SchedLoad. A snapshot stores key in place
+*				of the task function; loaded tasks get task_func and params
+*				back from the entry with their key.
+*******************************************************************************/
+typedef struct sched_task_type
+{
+	unsigned long key;
+	TaskFunc task_func;
+	void *params;
+} sched_task_type_ty;
+
+/*******************************************************************************
+* DESCRIPTION	Writes the tasks of scheduler to stream in a binary snapshot:
+*				every task id, its interval, the time left to its next run
+*				and the key of its task function in types. The slot
+*				generations are saved as well, so ids of tasks removed
+*				before the save stay stale after SchedLoad.
+*				Times left are counted on the scheduler clock; the time
+*				between save and load does not count.
+* RETURN	 	status => 0 SUCCESS; non-zero value FAILURE: a task function
+*				has no entry in types, or writing failed. stream then holds
+*				a snapshot SchedLoad rejects.
+* IMPORTANT		params are not saved.
+*				Cancelled tasks (see SchedSetLazyRemove) are not saved.
+*
+* Time Complexity 	O(n * num_types)
+*******************************************************************************/
+int SchedSave(const scheduler_ty *scheduler, FILE *stream,
+				const sched_task_type_ty *types, size_t num_types);
+
+/*******************************************************************************
+* DESCRIPTION	Reads a snapshot of SchedSave from stream into scheduler.
+*				Every task keeps its id and its time left to its next run,
+*				counted from now on the scheduler clock. The tasks are
+*				sorted by next run and queued in that order, so every
+*				engine takes them at the back.
+* RETURN	 	status => 0 SUCCESS; non-zero value FAILURE: scheduler is
+*				not empty or running, the snapshot is malformed or from
+*				another version, a key has no entry in types, or memory
+*				allocation failed. Unless scheduler was not empty or
+*				running, it is left empty.
+* IMPORTANT		Loaded tasks run with the params of their types entry; use
+*				SchedSetParams to give a task its own.
+*
+* Time Complexity 	O(n * log(n) + n * num_types)
+*******************************************************************************/
+int SchedLoad(scheduler_ty *scheduler, FILE *stream,
+				const sched_task_type_ty *types, size_t num_types);
+
+/*******************************************************************************
+* DESCRIPTION	Keeps the tasks of scheduler in the file at path, mapped to
+*				memory: a header (magic, version, record size, capacity,
+*				offset of the records, checksum) and one fixed size record
+*				per task slot. Tasks live in their records, nothing is
+*				allocated per task. Every add, run, reschedule and remove
+*				updates the record of its task, which holds the slot
+*				generation, the type key, the interval and the wall clock
+*				time of the next run, with a checksum.
+*				An empty or new file is created with capacity records. An
+*				existing file keeps its own capacity; every record is
+*				validated and its live tasks are queued again with their
+*				ids, so restarting is mapping the file back. A record
+*				whose checksum does not match, torn by a process killed
+*				while writing it, is lost: its slot is freed and its id
+*				stays stale.
+*				Time while no process had the file open counts: a task
+*				whose time passed runs as soon as SchedRun starts.
+* RETURN	 	status => 0 SUCCESS; non-zero value FAILURE: scheduler is
+*				not empty, running or mapped already, the file cannot be
+*				opened or mapped, it is from another version or build, a
+*				key has no entry in types, or memory allocation failed.
+* IMPORTANT		types must stay valid until SchedDestroy; tasks whose
+*				function has no entry in it cannot be added.
+*				SchedAdd fails once capacity tasks are in the scheduler.
+*				The file is in the byte order and layout of the build; use
+*				SchedSave to move tasks between machines.
+*				Only one scheduler may map a file at a time.
+*				Mapped schedulers cannot SchedLoad.
+*
+* Time Complexity 	O(capacity + n * log(n) + n * num_types)
+*******************************************************************************/
+int SchedMapOpen(scheduler_ty *scheduler, const char *path, size_t capacity,
+				const sched_task_type_ty *types, size_t num_types);
+
+/*******************************************************************************
+* DESCRIPTION	Writes the mapped records of scheduler to disk and waits.
+*				Without it the system writes them back in its own time,
+*				which survives a crash of the process but not of the system.
+* RETURN	 	status => 0 SUCCESS; non-zero value FAILURE: scheduler is not
+*				mapped, or writing failed.
+*
+* Time Complexity 	O(capacity)
+*******************************************************************************/
+int SchedMapSync(scheduler_ty *scheduler);
+
+
+/*******************************************************************************
+* DESCRIPTION	Appends every change to the tasks of scheduler to stream, a
+*				binary journal: SchedAdd (id, key of the task function in
+*				types, interval, time left), SchedRemove and tasks which
+*				returned non-zero, SchedReschedule and SchedSetInterval, and
+*				SchedClear, each in a fixed size record with a checksum.
+*				Records are buffered and committed (fflush, then fsync) once
+*				group_size of them are pending, and whenever SchedRun sleeps
+*				until its next task; a bigger group trades the events a
+*				system crash may lose for fewer fsyncs.
+*				A stream at position 0 gets the journal header first; any
+*				other is appended to.
+* RETURN	 	status => 0 SUCCESS; non-zero value FAILURE: a journal is
+*				started already, writing the header failed or memory
+*				allocation failed.
+* IMPORTANT		Start the journal right after SchedSave (or after SchedLoad
+*				and SchedJournalReplay), with a new stream: SchedJournalReplay
+*				expects the journal to begin where the snapshot ends.
+*				types and stream must stay valid until SchedJournalStop or
+*				SchedDestroy; the stream is not closed.
+*				While journaling, SchedAdd fails for a task function without
+*				an entry in types and SchedLoad fails.
+*				Runs are not journaled; a replayed task has the time left of
+*				its last add or reschedule.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+int SchedJournalStart(scheduler_ty *scheduler, FILE *stream,
+					const sched_task_type_ty *types, size_t num_types,
+					size_t group_size);
+
+/*******************************************************************************
+* DESCRIPTION	Commits the pending records of the journal now.
+* RETURN	 	status => 0 SUCCESS, every record since SchedJournalStart is
+*				on disk; non-zero value FAILURE: no journal is started, or a
+*				record could not be written or committed.
+*
+* Time Complexity 	O(1), one fsync
+*******************************************************************************/
+int SchedJournalSync(scheduler_ty *scheduler);
+
+/*******************************************************************************
+* DESCRIPTION	Commits the pending records and stops journaling. The stream
+*				is not closed.
+* RETURN	 	status => as SchedJournalSync; journaling stops either way.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+int SchedJournalStop(scheduler_ty *scheduler);
+
+/*******************************************************************************
+* DESCRIPTION	Applies the records of a journal read from stream to
+*				scheduler, usually right after SchedLoad of the snapshot the
+*				journal was started after. Added tasks take the slot of
+*				their id and get task_func and params of the entry with
+*				their key, as SchedLoad does. Times left count from now on
+*				the scheduler clock.
+*				The journal ends at the first record cut short or not
+*				matching its checksum: the one a crash stopped writing.
+*				Tasks the records remove or clear are freed without the
+*				on_remove hook (see SchedSetHooks).
+* RETURN	 	status => 0 SUCCESS; non-zero value FAILURE: scheduler is
+*				running, mapped or journaling, the header is not a journal
+*				of this version, a key has no entry in types, or memory
+*				allocation failed. scheduler then holds the records applied
+*				before the failure.
+*
+* Time Complexity 	O(r * num_types) records, plus the engine work per record
+*******************************************************************************/
+int SchedJournalReplay(scheduler_ty *scheduler, FILE *stream,
+						const sched_task_type_ty *types, size_t num_types);
+
+
+/*******************************************************************************
+* DESCRIPTION	Makes scheduler the dispatcher of a POSIX shared memory
+*				segment called name (see shm_open), so other processes add
+*				and remove its tasks with SchedShmAttach, SchedShmAdd and
+*				SchedShmRemove, without a round trip to the dispatcher.
+*				The segment holds the id table of capacity slots (generation
+*				and state) and a ring of pending requests, under a process
+*				shared, robust mutex. Ids come from the shared table, the
+*				tasks themselves stay in the dispatcher. SchedRun takes the
+*				pending requests before every task, and waits on a process
+*				shared condition instead of sleeping, so a client adding an
+*				earlier task wakes it.
+*				Client tasks get task_func and params of the entry of types
+*				with their key; their interval counts from when SchedRun
+*				takes them.
+* RETURN	 	status => 0 SUCCESS; non-zero value FAILURE: scheduler is
+*				not empty, running, mapped or shared already, capacity is 0,
+*				the segment exists already or cannot be made, or memory
+*				allocation failed.
+* IMPORTANT		SchedAdd fails once capacity tasks are in the scheduler, its
+*				own and clients' alike.
+*				types must stay valid until SchedDestroy, which unlinks the
+*				segment; attached clients keep their mapping until detached.
+*				SchedLoad, SchedMapOpen and SchedJournalReplay fail while
+*				shared.
+*				Link with -pthread (and -lrt before glibc 2.34).
+*
+* Time Complexity 	O(capacity)
+*******************************************************************************/
+int SchedShmCreate(scheduler_ty *scheduler, const char *name, size_t capacity,
+					const sched_task_type_ty *types, size_t num_types);
+
+/*******************************************************************************
+* DESCRIPTION	Maps the segment of a dispatcher, from any process.
+* RETURN		NULL when there is no such segment, it is not a scheduler
+*				segment of this version, or memory allocation failed.
+* IMPORTANT		User needs to detach the segment.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+sched_shm_ty *SchedShmAttach(const char *name);
+
+/*******************************************************************************
+* DESCRIPTION	Unmaps the segment; tasks added through it stay.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+void SchedShmDetach(sched_shm_ty *shm);
+
+/*******************************************************************************
+* DESCRIPTION	Takes an id from the shared table and queues a request to
+*				add a task of type key, run every interval seconds.
+* RETURN		The task id; SCHED_BAD_ID when every slot is taken or the
+*				ring of requests is full.
+* IMPORTANT		A key without an entry in the dispatcher's types is dropped
+*				when the dispatcher takes the request; its id goes stale.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+sched_id_ty SchedShmAdd(sched_shm_ty *shm, unsigned long key, time_t interval);
+
+/*******************************************************************************
+* DESCRIPTION	Queues a request to remove the task of id, added by any
+*				process. The dispatcher removes it when it takes the
+*				request, as SchedRemove does.
+* RETURN	 	status => 0 SUCCESS; non-zero value FAILURE: id is stale, it
+*				is being removed already, or the ring of requests is full.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+int SchedShmRemove(sched_shm_ty *shm, sched_id_ty id);
+
+
+/* Live statistics, see SchedStatsCreate. Lateness is from the time a task
+   was due to its start, in ms; percentiles are over every task run since
+   the segment was made, rounded up to a power of 2 less 1. */
+typedef struct sched_stats
+{
+	unsigned long	capacity;		/* entries for the runs of tasks */
+	unsigned long	num_tasks;		/* tasks with an entry */
+	unsigned long	is_running;
+	unsigned long	queue_depth;	/* tasks queued, the running one aside */
+	unsigned long	num_dispatched;	/* tasks run */
+	unsigned long	num_failed;		/* tasks run which returned non-zero */
+	unsigned long	num_deferred;	/* see sched_load_stats_ty */
+	unsigned long	num_rejected;
+	unsigned long	dispatch_rate;	/* tasks run in the whole second before
+									   the one of updated */
+	unsigned long	late_p50;
+	unsigned long	late_p90;
+	unsigned long	late_p99;
+	unsigned long	late_max;
+	time_t			started;		/* wall clock time SchedRun last started */
+	time_t			updated;		/* wall clock time of the last update */
+} sched_stats_ty;
+
+typedef struct sched_task_runs
+{
+	sched_id_ty		id;
+	unsigned long	runs;
+} sched_task_runs_ty;
+
+/*******************************************************************************
+* DESCRIPTION	Publishes live statistics of scheduler in a POSIX shared
+*				memory segment called name (see shm_open), for monitors in
+*				other processes: see SchedStatsAttach and tools/schedtop.c.
+*				SchedRun updates them after every task it runs, and when it
+*				starts and stops. Tasks get an entry of runs by the slot of
+*				their id, while it is below capacity; the entry is dropped
+*				when the task is freed.
+*				Updates take no lock and make no system call but reading the
+*				clock: the dispatcher makes a sequence counter odd while it
+*				writes, and readers retry a read it changed (a seqlock).
+* RETURN	 	status => 0 SUCCESS; non-zero value FAILURE: scheduler is
+*				running or publishes already, the segment exists already or
+*				cannot be made, or memory allocation failed.
+* IMPORTANT		SchedDestroy unlinks the segment; attached monitors keep
+*				their mapping until detached.
+*				Adds and removes update the queue depth on the next run.
+*				Link with -lrt before glibc 2.34.
+*
+* Time Complexity 	O(capacity); updates O(1)
+*******************************************************************************/
+int SchedStatsCreate(scheduler_ty *scheduler, const char *name, size_t capacity);
+
+/*******************************************************************************
+* DESCRIPTION	Maps the statistics segment of a scheduler read only, from
+*				any process.
+* RETURN		NULL when there is no such segment, it is not a statistics
+*				segment of this version, or memory allocation failed.
+* IMPORTANT		User needs to detach the segment.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+sched_stats_view_ty *SchedStatsAttach(const char *name);
+
+/*******************************************************************************
+* DESCRIPTION	Unmaps the segment.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+void SchedStatsDetach(sched_stats_view_ty *view);
+
+/*******************************************************************************
+* DESCRIPTION	Copies a consistent snapshot of the statistics to stats, and
+*				up to num_tasks entries of runs to tasks, in slot order.
+*				stats->num_tasks tells how many there are.
+* RETURN	 	status => 0 SUCCESS; non-zero value FAILURE: the dispatcher
+*				kept changing the statistics while they were read, or died
+*				while changing them.
+*
+* Time Complexity 	O(capacity) per try
+*******************************************************************************/
+int SchedStatsRead(const sched_stats_view_ty *view, sched_stats_ty *stats,
+					sched_task_runs_ty *tasks, size_t num_tasks);
+
+
 #endif /* __SCHEDULER_H__ */
 
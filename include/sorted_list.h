@@ -32,6 +32,8 @@ typedef int (*CmpFunc)(const void *object1, const void *object2, const void *cmp
 
 /*******************************************************************************
 * DESCRIPTION	Creates a sorted list container.
+*				The list is a skip list: express levels over the elements
+*				make Insert, Find and Remove logarithmic on average.
 * RETURN		NULL when memory allocation failed.
 				Undefined behavior
 				- when p_cmp_func pointer is invalid.
@@ -42,15 +44,61 @@ typedef int (*CmpFunc)(const void *object1, const void *object2, const void *cmp
 sortl_ty *SortLCreate(CmpFunc p_cmp_func, const void *cmp_param);
 
 
+/*******************************************************************************
+* DESCRIPTION	Creates a sorted list ordered by an integer key (dlist_key_ty)
+*				stored key_offset bytes inside each element.
+*				Insert and Find compare keys inline, without CmpFunc calls.
+* RETURN		NULL when memory allocation failed.
+* IMPORTANT	 	User needs to free the allocated container.
+*				Elements with equal keys keep their insertion order.
+
+* Time Complexity 	O(1)
+*******************************************************************************/
+sortl_ty *SortLCreateKeyed(size_t key_offset);
+
+
+/*******************************************************************************
+* DESCRIPTION	Creates an intrusive keyed sorted list. Each element embeds its
+*				own node_ty, link_offset bytes from the element address, so
+*				Insert allocates nothing and never fails.
+* RETURN		NULL when memory allocation failed.
+* IMPORTANT	 	Remove elements with SortLUnlink only; SortLRemove frees the
+*				node and is undefined behavior on intrusive lists.
+*				Merge is defined only between lists of the same layout.
+*				Destroy detaches the remaining elements, it never frees them.
+*				Embedded nodes have no express levels, so Insert and Find
+*				are O(number_of_elements); prefer SortLInsertHint.
+
+* Time Complexity 	O(1)
+*******************************************************************************/
+sortl_ty *SortLCreateIntrusive(size_t key_offset, size_t link_offset);
+
+
 /*******************************************************************************
 * DESCRIPTION	Add and sort a new element to a relevant position.
 * RETURN		On failure return iterator to end of range
 
-* Time Complexity 	O(number_of_elements)
+* Time Complexity 	O(log(number_of_elements)) average
 *******************************************************************************/
 sortl_itr_ty SortLInsert(sortl_ty *list, void *data);
 
 
+/*******************************************************************************
+* DESCRIPTION	Add and sort a new element, searching its position from 'hint'
+*				instead of the beginning of the list. The search moves
+*				backward or forward from hint as needed, so any valid
+*				iterator (including END) gives a correct result.
+*				Pass SortLEnd to insert elements expected near the tail.
+*				Non-intrusive lists ignore hint and insert like SortLInsert.
+* RETURN		On failure return iterator to end of range
+* IMPORTANT		Undefined behavior when hint belongs to another list.
+
+* Time Complexity 	O(distance between hint and the inserted position)
+*					intrusive lists; O(log(number_of_elements)) otherwise
+*******************************************************************************/
+sortl_itr_ty SortLInsertHint(sortl_ty *list, sortl_itr_ty hint, void *data);
+
+
 /*******************************************************************************
 * DESCRIPTION	Get data of a specifiec element.
 * IMPORTANT		Undefined behavior when iterator is out of list range.
@@ -71,7 +119,7 @@ void SortLDestroy(sortl_ty *list);
 /*******************************************************************************
 * DESCRIPTION	Obtain the number of elements in the sorted list.
 
-* Time Complexity 	O(number_of_elements)
+* Time Complexity 	O(1)
 *******************************************************************************/
 size_t SortLCount(const sortl_ty *list);
 
@@ -128,6 +176,7 @@ int SortLIsSameIter(sortl_itr_ty iter1, sortl_itr_ty iter2);
 
 /*******************************************************************************
 * DESCRIPTION	Merge elements from donor list and sort them in dest.
+*				Nodes are moved, not copied; donor is left empty.
 * IMPORTANT:	Undefined behavior
 *				- when lists are not exist.
 *
@@ -140,7 +189,7 @@ void SortLMerge(sortl_ty *dest, sortl_ty *donor);
 * DESCRIPTION	Match element's data in list with data provided by the user.
 * RETURN		Iterator to the first found; If not found iterator to the end.
 
-* Time Complexity 	O(n)
+* Time Complexity 	O(log(n)) average; O(n) for intrusive lists
 *******************************************************************************/
 sortl_itr_ty SortLFind(const sortl_ty *list, const void *data);
 
@@ -158,12 +207,48 @@ int SortLIsEmpty(const sortl_ty *list);
 * DESCRIPTION	Remove element from sort list and frees it from memory.
 * RETURN		An iterator to the following item which has been removed.
 * IMPORTANT		The original iterator will be invalidate.
+*				Undefined behavior on intrusive lists, use SortLUnlink.
 
-* Time Complexity 	O(number_of_elements)
+* Time Complexity 	O(log(number_of_elements)) average
 *******************************************************************************/
 sortl_itr_ty SortLRemove(sortl_itr_ty iter);
 
 
+/*******************************************************************************
+* DESCRIPTION	Detach element from intrusive sort list; its node is not freed.
+* RETURN		An iterator to the following item which has been detached.
+
+* Time Complexity 	O(1)
+*******************************************************************************/
+sortl_itr_ty SortLUnlink(sortl_itr_ty iter);
+
+
+/*******************************************************************************
+* DESCRIPTION	Moves the element of iter to the position its order gives
+*				now, after its key (or what cmp_func compares) changed. The
+*				element keeps its node: nothing is allocated, it can not
+*				fail. Equal elements stay before it, as on insert.
+* RETURN		An iterator to the element at its new position.
+* IMPORTANT		The original iterator will be invalidate.
+*				The rest of the list must still be sorted.
+
+* Time Complexity 	O(distance moved) intrusive lists;
+*					O(log(number_of_elements)) average otherwise
+*******************************************************************************/
+sortl_itr_ty SortLReposition(sortl_itr_ty iter);
+
+
+/*******************************************************************************
+* DESCRIPTION	Get an iterator to an element of an intrusive list from the
+*				element itself, through its embedded node.
+* IMPORTANT		Undefined behavior when data is not linked in list, or the
+*				list is not intrusive.
+
+* Time Complexity 	O(1)
+*******************************************************************************/
+sortl_itr_ty SortLItrOf(sortl_ty *list, void *data);
+
+
 /*******************************************************************************
 * DESCRIPTION	Used in SortLFindIf function
 * RETURN		boolean => 1 FOUND;	0 NOT_FOUND
@@ -184,6 +269,7 @@ sortl_itr_ty SortLFindIf(sortl_itr_ty from, sortl_itr_ty to, IsMatchFunc is_matc
 struct sortl_itr
 {
     dlist_itr_ty dlist_itr;
+    sortl_ty *sortl;		/* owner; Remove updates its express levels */
 };
 
 
@@ -20,6 +20,9 @@ static const uid_ty BAD_UID;
 
 /*******************************************************************************
 * DESCRIPTION	Creates UID handle.
+*				Thread safe and lock free: the counter is advanced with an
+*				atomic add, the pid is cached and refreshed after fork.
+* IMPORTANT		Link with -pthread.
 
 * Time Complexity   O(1)
 *******************************************************************************/
@@ -0,0 +1,495 @@
+/*******************************************************************************
+****************************** - CALENDAR QUEUE - ******************************
+*
+*	DESCRIPTION		Implementation of calendar queue
+*	AUTHOR 			Liad Raz
+*
+*******************************************************************************/
+
+#include <stdlib.h>			/* malloc, free */
+#include <assert.h>			/* assert */
+
+#include "utilities.h"
+#include "calendar_queue.h"
+#include "slot_pool.h"
+
+#define CQASSERT_NOT_NULL(ptr)									\
+		assert (NULL != ptr && "Calendar queue is not allocated");
+
+#define CQUEUE_MIN_BUCKETS 		16		/* power of 2 */
+#define CQUEUE_INIT_CAPACITY 	64
+#define CQUEUE_SAMPLE 			25		/* earliest keys used to pick a width */
+
+/* a resize relinks the slots into the new days, see slot_pool.h */
+struct cqueue
+{
+	slot_pool_ty pool;
+	pool_chain_ty *buckets;	/* one sorted chain per day */
+	size_t num_buckets;
+	unsigned long width;
+	size_t last_bucket;		/* day the minimum was last found in */
+	unsigned long bucket_top;	/* end of that day; no key is below its start */
+	cqueue_stats_ty stats;
+};
+
+static size_t BucketOfImp(const cqueue_ty *cqueue, unsigned long key);
+static void InsertImp(cqueue_ty *cqueue, size_t slot);
+static void SetDayImp(cqueue_ty *cqueue, unsigned long key);
+static size_t FindMinBucketImp(cqueue_ty *cqueue);
+static void ResizeIfNeededImp(cqueue_ty *cqueue);
+static void ResizeImp(cqueue_ty *cqueue, size_t num_buckets);
+static unsigned long NewWidthImp(const cqueue_ty *cqueue);
+static void *EraseInBucketImp(cqueue_ty *cqueue, size_t bucket_idx,
+								CQueueIsMatch is_match, const void *param);
+
+
+/*******************************************************************************
+***************************** CQueue Create ***********************************/
+cqueue_ty *CQueueCreate(void)
+{
+	cqueue_ty *cqueue = (cqueue_ty *)malloc(sizeof(cqueue_ty));
+	size_t i = 0;
+
+	/* check allocation failure */
+	if (NULL == cqueue)
+	{
+		return NULL;
+	}
+
+	cqueue->buckets = (pool_chain_ty *)malloc(CQUEUE_MIN_BUCKETS * sizeof(pool_chain_ty));
+
+	/* check allocation failure */
+	if (NULL == cqueue->buckets)
+	{
+		free(cqueue);
+		return NULL;
+	}
+	if (SlotPoolInit(&cqueue->pool, CQUEUE_INIT_CAPACITY))
+	{
+		free(cqueue->buckets);
+		free(cqueue);
+		return NULL;
+	}
+
+	for (i = 0; i < CQUEUE_MIN_BUCKETS; ++i)
+	{
+		SlotChainReset(&cqueue->buckets[i]);
+	}
+
+	cqueue->num_buckets = CQUEUE_MIN_BUCKETS;
+	cqueue->width = 1;
+	cqueue->last_bucket = 0;
+	cqueue->bucket_top = 1;
+
+	cqueue->stats.num_buckets = CQUEUE_MIN_BUCKETS;
+	cqueue->stats.width = 1;
+	cqueue->stats.resizes = 0;
+	cqueue->stats.grows = 0;
+	cqueue->stats.shrinks = 0;
+	cqueue->stats.last_resize_size = 0;
+	cqueue->stats.direct_searches = 0;
+
+	return cqueue;
+}
+
+/*******************************************************************************
+***************************** CQueue Destroy **********************************/
+void CQueueDestroy(cqueue_ty *cqueue)
+{
+	CQASSERT_NOT_NULL(cqueue);
+
+	SlotPoolFree(&cqueue->pool);
+	free(cqueue->buckets);
+
+	/* break queue fields */
+	DEBUG_MODE
+	(
+		cqueue->buckets = INVALID_PTR;
+	)
+	free(cqueue);
+}
+
+/*******************************************************************************
+***************************** CQueue Push *************************************/
+int CQueuePush(cqueue_ty *cqueue, cqueue_key_ty key, void *data)
+{
+	unsigned long ukey = SLOT_POOL_TO_UKEY(key);
+	size_t slot = 0;
+
+	CQASSERT_NOT_NULL(cqueue);
+
+	/* a key before the current day moves the scan back to it */
+	if (0 == cqueue->pool.size || ukey < cqueue->bucket_top - cqueue->width)
+	{
+		SetDayImp(cqueue, ukey);
+	}
+
+	slot = SlotPoolAcquire(&cqueue->pool, ukey, data);
+	if (SLOT_POOL_NIL == slot)
+	{
+		return 1;
+	}
+
+	InsertImp(cqueue, slot);
+	ResizeIfNeededImp(cqueue);
+
+	return 0;
+}
+
+/*******************************************************************************
+***************************** CQueue Pop **************************************/
+void CQueuePop(cqueue_ty *cqueue)
+{
+	size_t bucket = 0;
+
+	CQASSERT_NOT_NULL(cqueue);
+	assert (0 != cqueue->pool.size && "CQueuePop: Cannot pop an empty queue");
+
+	bucket = FindMinBucketImp(cqueue);
+	SlotPoolRelease(&cqueue->pool, SlotChainPopHead(&cqueue->pool, &cqueue->buckets[bucket]));
+	ResizeIfNeededImp(cqueue);
+}
+
+/*******************************************************************************
+***************************** CQueue Peek *************************************/
+void *CQueuePeek(cqueue_ty *cqueue)
+{
+	CQASSERT_NOT_NULL(cqueue);
+
+	if (0 == cqueue->pool.size)
+	{
+		return NULL;
+	}
+
+	return cqueue->pool.slots[cqueue->buckets[FindMinBucketImp(cqueue)].head].data;
+}
+
+/*******************************************************************************
+***************************** CQueue Size *************************************/
+size_t CQueueSize(const cqueue_ty *cqueue)
+{
+	CQASSERT_NOT_NULL(cqueue);
+
+	return cqueue->pool.size;
+}
+
+/*******************************************************************************
+***************************** CQueue IsEmpty **********************************/
+int CQueueIsEmpty(const cqueue_ty *cqueue)
+{
+	CQASSERT_NOT_NULL(cqueue);
+
+	return (0 == cqueue->pool.size);
+}
+
+/*******************************************************************************
+***************************** CQueue Erase ************************************/
+void *CQueueErase(cqueue_ty *cqueue, CQueueIsMatch is_match, const void *param)
+{
+	void *data = NULL;
+	size_t i = 0;
+
+	CQASSERT_NOT_NULL(cqueue);
+	assert (NULL != is_match && "CQueueErase: Function pointer is invalid");
+
+	for (i = 0; i < cqueue->num_buckets && NULL == data; ++i)
+	{
+		data = EraseInBucketImp(cqueue, i, is_match, param);
+	}
+
+	return data;
+}
+
+/*******************************************************************************
+***************************** CQueue EraseKey *********************************/
+void *CQueueEraseKey(cqueue_ty *cqueue, cqueue_key_ty key, CQueueIsMatch is_match,
+					const void *param)
+{
+	CQASSERT_NOT_NULL(cqueue);
+	assert (NULL != is_match && "CQueueEraseKey: Function pointer is invalid");
+
+	/* an element is always chained in the day of its key */
+	return EraseInBucketImp(cqueue, BucketOfImp(cqueue, SLOT_POOL_TO_UKEY(key)),
+							is_match, param);
+}
+
+/*******************************************************************************
+***************************** CQueue Find *************************************/
+void *CQueueFind(const cqueue_ty *cqueue, CQueueIsMatch is_match, const void *param)
+{
+	void *data = NULL;
+	size_t i = 0;
+
+	CQASSERT_NOT_NULL(cqueue);
+	assert (NULL != is_match && "CQueueFind: Function pointer is invalid");
+
+	for (i = 0; i < cqueue->num_buckets && NULL == data; ++i)
+	{
+		data = SlotChainFind(&cqueue->pool, &cqueue->buckets[i], is_match, param);
+	}
+
+	return data;
+}
+
+/*******************************************************************************
+***************************** CQueue GetStats *********************************/
+void CQueueGetStats(const cqueue_ty *cqueue, cqueue_stats_ty *stats)
+{
+	CQASSERT_NOT_NULL(cqueue);
+	assert (NULL != stats && "CQueueGetStats: stats is not allocated");
+
+	*stats = cqueue->stats;
+}
+
+
+/*******************************************************************************
+***************************** Side Functions **********************************/
+static size_t BucketOfImp(const cqueue_ty *cqueue, unsigned long key)
+{
+	return (size_t)(key / cqueue->width) & (cqueue->num_buckets - 1);
+}
+
+/* keeps the day sorted; equal keys go after the ones already queued. A
+   rescheduled timer is usually the latest of its day, so try the tail first */
+static void InsertImp(cqueue_ty *cqueue, size_t slot)
+{
+	pool_chain_ty *bucket = &cqueue->buckets[BucketOfImp(cqueue, cqueue->pool.slots[slot].key)];
+	unsigned long key = cqueue->pool.slots[slot].key;
+	size_t prev = SLOT_POOL_NIL;
+	size_t curr = bucket->head;
+
+	if (SLOT_POOL_NIL == bucket->tail || cqueue->pool.slots[bucket->tail].key <= key)
+	{
+		SlotChainAppend(&cqueue->pool, bucket, slot);
+
+		return;
+	}
+
+	while (cqueue->pool.slots[curr].key <= key)
+	{
+		prev = curr;
+		curr = cqueue->pool.slots[curr].next;
+	}
+
+	cqueue->pool.slots[slot].next = curr;
+
+	if (SLOT_POOL_NIL == prev)
+	{
+		bucket->head = slot;
+	}
+	else
+	{
+		cqueue->pool.slots[prev].next = slot;
+	}
+}
+
+static void SetDayImp(cqueue_ty *cqueue, unsigned long key)
+{
+	cqueue->last_bucket = BucketOfImp(cqueue, key);
+	cqueue->bucket_top = (key / cqueue->width) * cqueue->width + cqueue->width;
+}
+
+/* walks the days from the last minimum on; a day's first key counts only
+   when it falls in the current year. After a whole year with no hit, the
+   heads of all days are compared directly. */
+static size_t FindMinBucketImp(cqueue_ty *cqueue)
+{
+	size_t bucket = cqueue->last_bucket;
+	unsigned long top = cqueue->bucket_top;
+	size_t min_bucket = SLOT_POOL_NIL;
+	size_t head = 0;
+	size_t i = 0;
+
+	for (i = 0; i < cqueue->num_buckets; ++i)
+	{
+		head = cqueue->buckets[bucket].head;
+		if (SLOT_POOL_NIL != head && cqueue->pool.slots[head].key < top)
+		{
+			cqueue->last_bucket = bucket;
+			cqueue->bucket_top = top;
+
+			return bucket;
+		}
+
+		/* the last day of the key range; finish with a direct search */
+		if (top > ~0UL - cqueue->width)
+		{
+			break;
+		}
+
+		bucket = (bucket + 1) & (cqueue->num_buckets - 1);
+		top += cqueue->width;
+	}
+
+	++cqueue->stats.direct_searches;
+
+	for (i = 0; i < cqueue->num_buckets; ++i)
+	{
+		head = cqueue->buckets[i].head;
+		if (SLOT_POOL_NIL != head && (SLOT_POOL_NIL == min_bucket ||
+			cqueue->pool.slots[head].key < cqueue->pool.slots[cqueue->buckets[min_bucket].head].key))
+		{
+			min_bucket = i;
+		}
+	}
+
+	assert (SLOT_POOL_NIL != min_bucket && "FindMinBucket: queue is empty");
+	SetDayImp(cqueue, cqueue->pool.slots[cqueue->buckets[min_bucket].head].key);
+
+	return min_bucket;
+}
+
+/* two elements per day on average at most, one per two days at least */
+static void ResizeIfNeededImp(cqueue_ty *cqueue)
+{
+	if (cqueue->pool.size > 2 * cqueue->num_buckets)
+	{
+		ResizeImp(cqueue, 2 * cqueue->num_buckets);
+	}
+	else if (CQUEUE_MIN_BUCKETS < cqueue->num_buckets &&
+			cqueue->pool.size < cqueue->num_buckets / 2)
+	{
+		ResizeImp(cqueue, cqueue->num_buckets / 2);
+	}
+}
+
+static void ResizeImp(cqueue_ty *cqueue, size_t num_buckets)
+{
+	pool_chain_ty *old_buckets = cqueue->buckets;
+	size_t old_num = cqueue->num_buckets;
+	pool_chain_ty *buckets = (pool_chain_ty *)malloc(num_buckets *
+												sizeof(pool_chain_ty));
+	unsigned long width = 0;
+	unsigned long min_key = ~0UL;
+	size_t slot = 0;
+	size_t next = 0;
+	size_t i = 0;
+
+	/* keep the current calendar; the next push or pop tries again */
+	if (NULL == buckets)
+	{
+		return;
+	}
+
+	width = NewWidthImp(cqueue);
+
+	for (i = 0; i < num_buckets; ++i)
+	{
+		SlotChainReset(&buckets[i]);
+	}
+
+	cqueue->buckets = buckets;
+	cqueue->num_buckets = num_buckets;
+	cqueue->width = width;
+
+	/* every old day is sorted and holds equal keys in queue order, so
+	   re-inserting day by day keeps equal keys FIFO */
+	for (i = 0; i < old_num; ++i)
+	{
+		for (slot = old_buckets[i].head; SLOT_POOL_NIL != slot; slot = next)
+		{
+			next = cqueue->pool.slots[slot].next;
+			if (cqueue->pool.slots[slot].key < min_key)
+			{
+				min_key = cqueue->pool.slots[slot].key;
+			}
+			InsertImp(cqueue, slot);
+		}
+	}
+
+	free(old_buckets);
+
+	/* restart the scan from the minimum */
+	SetDayImp(cqueue, min_key);
+
+	if (num_buckets > old_num)
+	{
+		++cqueue->stats.grows;
+	}
+	else
+	{
+		++cqueue->stats.shrinks;
+	}
+
+	++cqueue->stats.resizes;
+	cqueue->stats.last_resize_size = cqueue->pool.size;
+	cqueue->stats.num_buckets = num_buckets;
+	cqueue->stats.width = width;
+}
+
+/* Brown's estimate: the average separation of the earliest keys, again
+   without the separations bigger than twice the average, times three */
+static unsigned long NewWidthImp(const cqueue_ty *cqueue)
+{
+	unsigned long sample[CQUEUE_SAMPLE];
+	unsigned long total = 0;
+	unsigned long average = 0;
+	unsigned long gap = 0;
+	size_t num_sample = 0;
+	size_t num_gaps = 0;
+	size_t slot = 0;
+	size_t i = 0;
+	size_t j = 0;
+
+	/* keep the CQUEUE_SAMPLE smallest keys, sorted */
+	for (i = 0; i < cqueue->num_buckets; ++i)
+	{
+		for (slot = cqueue->buckets[i].head; SLOT_POOL_NIL != slot; slot = cqueue->pool.slots[slot].next)
+		{
+			if (CQUEUE_SAMPLE == num_sample &&
+				cqueue->pool.slots[slot].key >= sample[CQUEUE_SAMPLE - 1])
+			{
+				/* the rest of the day is bigger still */
+				break;
+			}
+
+			j = (CQUEUE_SAMPLE == num_sample) ? CQUEUE_SAMPLE - 1 : num_sample++;
+			for (; 0 < j && sample[j - 1] > cqueue->pool.slots[slot].key; --j)
+			{
+				sample[j] = sample[j - 1];
+			}
+			sample[j] = cqueue->pool.slots[slot].key;
+		}
+	}
+
+	if (2 > num_sample || sample[num_sample - 1] == sample[0])
+	{
+		return cqueue->width;
+	}
+
+	average = (sample[num_sample - 1] - sample[0]) / (num_sample - 1);
+
+	for (i = 1; i < num_sample; ++i)
+	{
+		gap = sample[i] - sample[i - 1];
+		if (gap <= 2 * average)
+		{
+			total += gap;
+			++num_gaps;
+		}
+	}
+
+	average = (0 == num_gaps) ? average : total / num_gaps;
+
+	if (0 == average)
+	{
+		return 1;
+	}
+
+	return (average > ~0UL / 3) ? ~0UL / 3 : 3 * average;
+}
+
+/* a smaller queue may need fewer days */
+static void *EraseInBucketImp(cqueue_ty *cqueue, size_t bucket_idx,
+								CQueueIsMatch is_match, const void *param)
+{
+	void *data = SlotChainErase(&cqueue->pool, &cqueue->buckets[bucket_idx],
+								is_match, param);
+
+	if (NULL != data)
+	{
+		ResizeIfNeededImp(cqueue);
+	}
+
+	return data;
+}
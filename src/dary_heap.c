@@ -0,0 +1,471 @@
+/*******************************************************************************
+******************************** - D-ARY HEAP - *******************************
+*
+*	DESCRIPTION		Implementation of d-ary implicit min heap
+*	AUTHOR 			Liad Raz
+*
+*******************************************************************************/
+
+#include <stdlib.h>			/* malloc, free */
+#include <string.h>			/* memcpy */
+#include <assert.h>			/* assert */
+
+#include "utilities.h"
+#include "dary_heap.h"
+
+#define DHASSERT_NOT_NULL(ptr)									\
+		assert (NULL != ptr && "D-ary heap is not allocated");
+
+#define DHEAP_INIT_CAPACITY 64
+#define DHEAP_CACHE_LINE 64
+#define DHEAP_NO_INDEX 		((size_t)-1)
+
+typedef struct dheap_slot
+{
+	dheap_key_ty key;
+	void *data;
+} dheap_slot_ty;
+
+struct dheap
+{
+	dheap_slot_ty *slots;	/* slots[1] is cache line aligned */
+	void *raw;				/* allocated block, slots points inside it */
+	unsigned long *seqs;	/* push order of each slot; indexed heaps only */
+	size_t size;
+	size_t capacity;
+	size_t arity;
+	size_t index_offset;	/* DHEAP_NO_INDEX unless created indexed */
+	unsigned long next_seq;
+};
+
+#define PARENT_OF(heap, idx)		(((idx) - 1) / (heap)->arity)
+#define FIRST_CHILD_OF(heap, idx)	((idx) * (heap)->arity + 1)
+#define SEQ_OF(heap, idx)			((NULL != (heap)->seqs) ? (heap)->seqs[idx] : 0)
+
+/* smaller key first; equal keys by push order, all 0 in a plain heap */
+#define IS_BEFORE(key1, seq1, key2, seq2)								\
+		((key1) < (key2) || ((key1) == (key2) && (seq1) < (seq2)))
+
+static int GrowImp(dheap_ty *heap, size_t new_capacity);
+static void SiftUpImp(dheap_ty *heap, size_t idx);
+static void SiftDownImp(dheap_ty *heap, size_t idx);
+static void PlaceImp(dheap_ty *heap, size_t idx, dheap_slot_ty slot,
+						unsigned long seq);
+static void CopyImp(dheap_ty *heap, size_t to, size_t from);
+static void RemoveAtImp(dheap_ty *heap, size_t idx);
+
+
+/*******************************************************************************
+***************************** DHeap Create ************************************/
+dheap_ty *DHeapCreate(size_t arity)
+{
+	dheap_ty *heap = NULL;
+
+	assert (2 <= arity && "DHeapCreate: arity must be at least 2");
+
+	heap = (dheap_ty *)malloc(sizeof(dheap_ty));
+
+	/* check allocation failure */
+	if (NULL == heap)
+	{
+		return NULL;
+	}
+
+	heap->slots = NULL;
+	heap->raw = NULL;
+	heap->seqs = NULL;
+	heap->size = 0;
+	heap->capacity = 0;
+	heap->arity = arity;
+	heap->index_offset = DHEAP_NO_INDEX;
+	heap->next_seq = 0;
+
+	if (0 != GrowImp(heap, DHEAP_INIT_CAPACITY))
+	{
+		free(heap);
+		return NULL;
+	}
+
+	return heap;
+}
+
+/*******************************************************************************
+***************************** DHeap CreateIndexed *****************************/
+dheap_ty *DHeapCreateIndexed(size_t arity, size_t index_offset)
+{
+	dheap_ty *heap = DHeapCreate(arity);
+
+	if (NULL == heap)
+	{
+		return NULL;
+	}
+
+	/* it writes to the elements anyway; the push order costs one more
+	   array, and keeps equal keys FIFO */
+	heap->seqs = (unsigned long *)malloc(heap->capacity * sizeof(unsigned long));
+	if (NULL == heap->seqs)
+	{
+		DHeapDestroy(heap);
+		return NULL;
+	}
+
+	heap->index_offset = index_offset;
+
+	return heap;
+}
+
+/*******************************************************************************
+***************************** DHeap Destroy ***********************************/
+void DHeapDestroy(dheap_ty *heap)
+{
+	DHASSERT_NOT_NULL(heap);
+
+	free(heap->raw);
+	free(heap->seqs);
+
+	/* break heap fields */
+	DEBUG_MODE
+	(
+		heap->raw = INVALID_PTR;
+		heap->slots = INVALID_PTR;
+		heap->seqs = INVALID_PTR;
+	)
+	free(heap);
+}
+
+/*******************************************************************************
+***************************** DHeap Push **************************************/
+int DHeapPush(dheap_ty *heap, dheap_key_ty key, void *data)
+{
+	DHASSERT_NOT_NULL(heap);
+
+	/* double the array when full */
+	if (heap->size == heap->capacity && 0 != GrowImp(heap, 2 * heap->capacity))
+	{
+		return 1;
+	}
+
+	heap->slots[heap->size].key = key;
+	heap->slots[heap->size].data = data;
+	if (NULL != heap->seqs)
+	{
+		heap->seqs[heap->size] = heap->next_seq++;
+	}
+	++heap->size;
+
+	SiftUpImp(heap, heap->size - 1);
+
+	return 0;
+}
+
+/*******************************************************************************
+***************************** DHeap Pop ***************************************/
+void DHeapPop(dheap_ty *heap)
+{
+	DHASSERT_NOT_NULL(heap);
+	assert (0 != heap->size && "DHeapPop: Cannot pop an empty heap");
+
+	--heap->size;
+	if (0 != heap->size)
+	{
+		CopyImp(heap, 0, heap->size);
+		SiftDownImp(heap, 0);
+	}
+}
+
+/*******************************************************************************
+***************************** DHeap Peek **************************************/
+void *DHeapPeek(const dheap_ty *heap)
+{
+	DHASSERT_NOT_NULL(heap);
+
+	return (0 == heap->size) ? NULL : heap->slots[0].data;
+}
+
+/*******************************************************************************
+***************************** DHeap PeekKey ***********************************/
+dheap_key_ty DHeapPeekKey(const dheap_ty *heap)
+{
+	DHASSERT_NOT_NULL(heap);
+	assert (0 != heap->size && "DHeapPeekKey: heap is empty");
+
+	return heap->slots[0].key;
+}
+
+/*******************************************************************************
+***************************** DHeap Size **************************************/
+size_t DHeapSize(const dheap_ty *heap)
+{
+	DHASSERT_NOT_NULL(heap);
+
+	return heap->size;
+}
+
+/*******************************************************************************
+***************************** DHeap IsEmpty ***********************************/
+int DHeapIsEmpty(const dheap_ty *heap)
+{
+	DHASSERT_NOT_NULL(heap);
+
+	return (0 == heap->size);
+}
+
+/*******************************************************************************
+***************************** DHeap Clear *************************************/
+void DHeapClear(dheap_ty *heap)
+{
+	DHASSERT_NOT_NULL(heap);
+
+	heap->size = 0;
+}
+
+/*******************************************************************************
+***************************** DHeap Erase *************************************/
+void *DHeapErase(dheap_ty *heap, DHeapIsMatch is_match, const void *param)
+{
+	void *ret_data = NULL;
+	size_t idx = 0;
+
+	DHASSERT_NOT_NULL(heap);
+	assert (NULL != is_match && "DHeapErase: Function pointer is invalid");
+
+	for (idx = 0; idx < heap->size; ++idx)
+	{
+		if (is_match(heap->slots[idx].data, param))
+		{
+			ret_data = heap->slots[idx].data;
+			RemoveAtImp(heap, idx);
+
+			return ret_data;
+		}
+	}
+
+	return NULL;
+}
+
+/*******************************************************************************
+***************************** DHeap Unlink ************************************/
+void DHeapUnlink(dheap_ty *heap, void *data)
+{
+	size_t idx = 0;
+
+	DHASSERT_NOT_NULL(heap);
+	assert (DHEAP_NO_INDEX != heap->index_offset && "DHeapUnlink: heap is not indexed");
+
+	idx = *(size_t *)((char *)data + heap->index_offset);
+	assert (idx < heap->size && data == heap->slots[idx].data
+	&& "DHeapUnlink: data is not in the heap");
+
+	RemoveAtImp(heap, idx);
+}
+
+/*******************************************************************************
+***************************** DHeap Find **************************************/
+void *DHeapFind(const dheap_ty *heap, DHeapIsMatch is_match, const void *param)
+{
+	size_t idx = 0;
+
+	DHASSERT_NOT_NULL(heap);
+	assert (NULL != is_match && "DHeapFind: Function pointer is invalid");
+
+	for (idx = 0; idx < heap->size; ++idx)
+	{
+		if (is_match(heap->slots[idx].data, param))
+		{
+			return heap->slots[idx].data;
+		}
+	}
+
+	return NULL;
+}
+
+
+/*******************************************************************************
+***************************** DHeap UpdateKey *********************************/
+void DHeapUpdateKey(dheap_ty *heap, void *data, dheap_key_ty key)
+{
+	dheap_key_ty old_key = 0;
+	size_t idx = 0;
+
+	DHASSERT_NOT_NULL(heap);
+
+	/* a plain heap searches for data, keys do not tell where it is */
+	if (DHEAP_NO_INDEX == heap->index_offset)
+	{
+		while (idx < heap->size && data != heap->slots[idx].data)
+		{
+			++idx;
+		}
+	}
+	else
+	{
+		idx = *(size_t *)((char *)data + heap->index_offset);
+	}
+
+	assert (idx < heap->size && data == heap->slots[idx].data
+	&& "DHeapUpdateKey: data is not in the heap");
+
+	old_key = heap->slots[idx].key;
+	heap->slots[idx].key = key;
+
+	/* goes behind the elements already at key, as a new push would */
+	if (NULL != heap->seqs)
+	{
+		heap->seqs[idx] = heap->next_seq++;
+	}
+
+	if (key < old_key)
+	{
+		SiftUpImp(heap, idx);
+	}
+	else
+	{
+		SiftDownImp(heap, idx);
+	}
+}
+
+
+/*******************************************************************************
+***************************** Side Functions **********************************/
+static int GrowImp(dheap_ty *heap, size_t new_capacity)
+{
+	void *raw = NULL;
+	dheap_slot_ty *slots = NULL;
+	unsigned long *seqs = NULL;
+	size_t misalign = 0;
+
+	/* a bigger push order array is harmless when the slots fail */
+	if (NULL != heap->seqs)
+	{
+		seqs = (unsigned long *)realloc(heap->seqs, new_capacity * sizeof(unsigned long));
+		if (NULL == seqs)
+		{
+			return 1;
+		}
+		heap->seqs = seqs;
+	}
+
+	/* realloc may move the block off the alignment, allocate a new one */
+	raw = malloc(new_capacity * sizeof(dheap_slot_ty) + DHEAP_CACHE_LINE);
+	if (NULL == raw)
+	{
+		return 1;
+	}
+
+	/* children of node i start at slot i * arity + 1; align slot 1 */
+	slots = (dheap_slot_ty *)raw + 1;
+	misalign = (size_t)slots % DHEAP_CACHE_LINE;
+	if (0 != misalign)
+	{
+		slots = (dheap_slot_ty *)((char *)slots + DHEAP_CACHE_LINE - misalign);
+	}
+	slots -= 1;
+
+	if (NULL != heap->slots)
+	{
+		memcpy(slots, heap->slots, heap->size * sizeof(dheap_slot_ty));
+	}
+	free(heap->raw);
+
+	heap->raw = raw;
+	heap->slots = slots;
+	heap->capacity = new_capacity;
+
+	return 0;
+}
+
+static void SiftUpImp(dheap_ty *heap, size_t idx)
+{
+	dheap_slot_ty to_place = heap->slots[idx];
+	unsigned long seq = SEQ_OF(heap, idx);
+	size_t parent = 0;
+
+	while (0 < idx)
+	{
+		parent = PARENT_OF(heap, idx);
+		if (!IS_BEFORE(to_place.key, seq, heap->slots[parent].key, SEQ_OF(heap, parent)))
+		{
+			break;
+		}
+
+		PlaceImp(heap, idx, heap->slots[parent], SEQ_OF(heap, parent));
+		idx = parent;
+	}
+
+	PlaceImp(heap, idx, to_place, seq);
+}
+
+static void SiftDownImp(dheap_ty *heap, size_t idx)
+{
+	dheap_slot_ty to_place = heap->slots[idx];
+	unsigned long seq = SEQ_OF(heap, idx);
+	size_t child = 0;
+	size_t last_child = 0;
+	size_t min_child = 0;
+
+	while ((child = FIRST_CHILD_OF(heap, idx)) < heap->size)
+	{
+		/* smallest of the sibling group; keys are consecutive in memory */
+		last_child = child + heap->arity;
+		if (last_child > heap->size)
+		{
+			last_child = heap->size;
+		}
+
+		for (min_child = child++; child < last_child; ++child)
+		{
+			if (IS_BEFORE(heap->slots[child].key, SEQ_OF(heap, child),
+						heap->slots[min_child].key, SEQ_OF(heap, min_child)))
+			{
+				min_child = child;
+			}
+		}
+
+		if (!IS_BEFORE(heap->slots[min_child].key, SEQ_OF(heap, min_child),
+						to_place.key, seq))
+		{
+			break;
+		}
+
+		PlaceImp(heap, idx, heap->slots[min_child], SEQ_OF(heap, min_child));
+		idx = min_child;
+	}
+
+	PlaceImp(heap, idx, to_place, seq);
+}
+
+/* an indexed heap tells the element where it moved */
+static void PlaceImp(dheap_ty *heap, size_t idx, dheap_slot_ty slot,
+						unsigned long seq)
+{
+	heap->slots[idx] = slot;
+
+	if (DHEAP_NO_INDEX != heap->index_offset)
+	{
+		heap->seqs[idx] = seq;
+		*(size_t *)((char *)slot.data + heap->index_offset) = idx;
+	}
+}
+
+/* the sift which follows places the slot and tells the element */
+static void CopyImp(dheap_ty *heap, size_t to, size_t from)
+{
+	heap->slots[to] = heap->slots[from];
+
+	if (NULL != heap->seqs)
+	{
+		heap->seqs[to] = heap->seqs[from];
+	}
+}
+
+/* fill the hole with the last slot and restore heap order */
+static void RemoveAtImp(dheap_ty *heap, size_t idx)
+{
+	--heap->size;
+	if (idx != heap->size)
+	{
+		CopyImp(heap, idx, heap->size);
+		SiftUpImp(heap, idx);
+		SiftDownImp(heap, idx);
+	}
+}
@@ -20,12 +20,7 @@
 
 #define IS_END(pointer) (pointer != INVALID_PTR)
 
-struct node
-{
-    void *data;
-    node_ty *next;
-    node_ty *prev;
-};
+#define KEY_OF(data, offset) (*(const dlist_key_ty *)((const char *)(data) + (offset)))
 
 struct dlist
 {
@@ -118,8 +113,6 @@ int DListIsSameIter(dlist_itr_ty itr1, dlist_itr_ty itr2)
 dlist_itr_ty DListInsert(dlist_itr_ty where, void *data)
 {
 	node_ty *new_node = NULL;
-	node_ty *current = NULL;
-	dlist_itr_ty ret_itr = {NULL};
 
 	assert (NULL != where.to_node && "Iterator is invalid");
 
@@ -131,21 +124,78 @@ dlist_itr_ty DListInsert(dlist_itr_ty where, void *data)
 		return ItrToDummyImp(where);
 	}
 
+	/* return the iterator refered to new_node */
+	return DListLink(where, new_node, data);
+}
+
+
+/*******************************************************************************
+***************************** DList Link **************************************/
+dlist_itr_ty DListLink(dlist_itr_ty where, node_ty *node, void *data)
+{
+	node_ty *current = NULL;
+	dlist_itr_ty ret_itr = {NULL};
+
+	assert (NULL != where.to_node && "DListLink: Iterator is invalid");
+	assert (NULL != node && "DListLink: Node is invalid");
+
+	node->data = data;
 	current = where.to_node;
 
-	/* connect one node before current with new_node */
-	ConnectNodesImp(current->prev, new_node);
-	/* connect new_node with current node */
-	ConnectNodesImp(new_node, current);
+	/* connect one node before current with node */
+	ConnectNodesImp(current->prev, node);
+	/* connect node with current node */
+	ConnectNodesImp(node, current);
 
 	/* iterators validation checks */
-	assert (new_node->next->prev == new_node);
+	assert (node->next->prev == node);
 	assert (current->next->prev == current);
 
-	ret_itr.to_node =  new_node;
+	ret_itr.to_node = node;
 	DEBUG_MODE(ret_itr.dlist = where.dlist);
 
-	/* return the iterator refered to new_node */
+	return ret_itr;
+}
+
+
+/*******************************************************************************
+***************************** DList Unlink ************************************/
+dlist_itr_ty DListUnlink(dlist_itr_ty where)
+{
+	dlist_itr_ty ret_itr = {NULL};
+
+	assert (NULL != where.to_node
+	&& "DListUnlink: Iterator is invalid");
+
+	ASSERT_NOT_DUMMY(where);
+
+	/* returned iterator will be the one following the element to detach */
+	ret_itr = DListNext(where);
+
+	/* Connect the iterators located before and after the one to detach */
+	ConnectNodesImp((where.to_node)->prev, (where.to_node)->next);
+
+	DEBUG_MODE(
+		where.to_node->next = INVALID_PTR;
+		where.to_node->prev = INVALID_PTR;
+	)
+
+	return ret_itr;
+}
+
+
+/*******************************************************************************
+***************************** DList ItrOf *************************************/
+dlist_itr_ty DListItrOf(dlist_ty *dlist, node_ty *node)
+{
+	dlist_itr_ty ret_itr = {NULL};
+
+	assert (NULL != node && "DListItrOf: Node is invalid");
+	(void)dlist;
+
+	ret_itr.to_node = node;
+	DEBUG_MODE(ret_itr.dlist = dlist);
+
 	return ret_itr;
 }
 
@@ -274,6 +324,41 @@ dlist_itr_ty DListFind(dlist_itr_ty from, dlist_itr_ty to, IsMatchFunc match_fun
 }
 
 
+/*******************************************************************************
+***************************** DList FindKey ***********************************/
+dlist_itr_ty DListFindKey(dlist_itr_ty from, dlist_itr_ty to, size_t key_offset,
+											dlist_key_ty key, int is_upper)
+{
+	node_ty *runner = from.to_node;
+	node_ty *end_of_range = to.to_node;
+	dlist_itr_ty ret_itr = {NULL};
+
+	assert (from.dlist == to.dlist
+	&& "FindKey: Iterators come from the same list");
+
+	/* upper bound skips equal keys, so new elements keep insertion order */
+	if (is_upper)
+	{
+		while (runner != end_of_range && KEY_OF(runner->data, key_offset) <= key)
+		{
+			runner = runner->next;
+		}
+	}
+	else
+	{
+		while (runner != end_of_range && KEY_OF(runner->data, key_offset) < key)
+		{
+			runner = runner->next;
+		}
+	}
+
+	ret_itr.to_node = runner;
+	DEBUG_MODE(ret_itr.dlist = from.dlist);
+
+	return ret_itr;
+}
+
+
 /*******************************************************************************
 ***************************** DList CountMatch ********************************/
 size_t DListCountMatch(dlist_itr_ty from, dlist_itr_ty to, IsMatchFunc match_func_p, void *param)
@@ -0,0 +1,388 @@
+/*******************************************************************************
+******************************* - PAIRING HEAP - *******************************
+*
+*	DESCRIPTION		Implementation of intrusive pairing min heap
+*	AUTHOR 			Liad Raz
+*
+*******************************************************************************/
+
+#include <stdlib.h>			/* malloc, free */
+#include <assert.h>			/* assert */
+
+#include "utilities.h"
+#include "pairing_heap.h"
+
+#define PHASSERT_NOT_NULL(ptr)									\
+		assert (NULL != ptr && "Pairing heap is not allocated");
+
+struct pheap
+{
+	pheap_node_ty *root;
+	size_t size;
+	size_t node_offset;		/* node position inside every element */
+	unsigned long next_seq;	/* push order, the tie break of equal keys */
+};
+
+#define NODE_OF_IMP(heap, data)											\
+		((pheap_node_ty *)((char *)(data) + (heap)->node_offset))
+#define DATA_OF_IMP(heap, node)											\
+		((void *)((char *)(node) - (heap)->node_offset))
+#define IS_BEFORE_IMP(node1, node2)										\
+		((node1)->key < (node2)->key ||									\
+		((node1)->key == (node2)->key && (node1)->seq < (node2)->seq))
+
+static pheap_node_ty *MeldImp(pheap_node_ty *first, pheap_node_ty *second);
+static pheap_node_ty *PairChildrenImp(pheap_node_ty *node);
+static void CutImp(pheap_node_ty *node);
+static void RemoveImp(pheap_ty *heap, pheap_node_ty *node);
+static pheap_node_ty *FindImp(const pheap_ty *heap, PHeapIsMatch is_match,
+								const void *param);
+
+
+/*******************************************************************************
+***************************** PHeap Create ************************************/
+pheap_ty *PHeapCreate(size_t node_offset)
+{
+	pheap_ty *heap = (pheap_ty *)malloc(sizeof(pheap_ty));
+
+	/* check allocation failure */
+	if (NULL == heap)
+	{
+		return NULL;
+	}
+
+	heap->root = NULL;
+	heap->size = 0;
+	heap->node_offset = node_offset;
+	heap->next_seq = 0;
+
+	return heap;
+}
+
+/*******************************************************************************
+***************************** PHeap Destroy ***********************************/
+void PHeapDestroy(pheap_ty *heap)
+{
+	PHASSERT_NOT_NULL(heap);
+
+	/* break heap fields */
+	DEBUG_MODE
+	(
+		heap->root = INVALID_PTR;
+	)
+	free(heap);
+}
+
+/*******************************************************************************
+***************************** PHeap Push **************************************/
+void PHeapPush(pheap_ty *heap, pheap_key_ty key, void *data)
+{
+	pheap_node_ty *node = NULL;
+
+	PHASSERT_NOT_NULL(heap);
+	assert (NULL != data && "PHeapPush: data is NULL");
+
+	node = NODE_OF_IMP(heap, data);
+	node->key = key;
+	node->seq = heap->next_seq++;
+	node->child = NULL;
+	node->next = NULL;
+	node->prev = NULL;
+
+	heap->root = MeldImp(heap->root, node);
+	++heap->size;
+}
+
+/*******************************************************************************
+***************************** PHeap Pop ***************************************/
+void PHeapPop(pheap_ty *heap)
+{
+	PHASSERT_NOT_NULL(heap);
+	assert (0 != heap->size && "PHeapPop: heap is empty");
+
+	RemoveImp(heap, heap->root);
+}
+
+/*******************************************************************************
+***************************** PHeap Peek **************************************/
+void *PHeapPeek(const pheap_ty *heap)
+{
+	PHASSERT_NOT_NULL(heap);
+
+	return (NULL == heap->root) ? NULL : DATA_OF_IMP(heap, heap->root);
+}
+
+/*******************************************************************************
+***************************** PHeap PeekKey ***********************************/
+pheap_key_ty PHeapPeekKey(const pheap_ty *heap)
+{
+	PHASSERT_NOT_NULL(heap);
+	assert (0 != heap->size && "PHeapPeekKey: heap is empty");
+
+	return heap->root->key;
+}
+
+/*******************************************************************************
+***************************** PHeap Size **************************************/
+size_t PHeapSize(const pheap_ty *heap)
+{
+	PHASSERT_NOT_NULL(heap);
+
+	return heap->size;
+}
+
+/*******************************************************************************
+***************************** PHeap IsEmpty ***********************************/
+int PHeapIsEmpty(const pheap_ty *heap)
+{
+	PHASSERT_NOT_NULL(heap);
+
+	return (0 == heap->size);
+}
+
+/*******************************************************************************
+***************************** PHeap Clear *************************************/
+void PHeapClear(pheap_ty *heap)
+{
+	PHASSERT_NOT_NULL(heap);
+
+	/* the nodes belong to the elements, nothing to free */
+	heap->root = NULL;
+	heap->size = 0;
+}
+
+/*******************************************************************************
+***************************** PHeap Erase *************************************/
+void *PHeapErase(pheap_ty *heap, PHeapIsMatch is_match, const void *param)
+{
+	pheap_node_ty *found = NULL;
+
+	PHASSERT_NOT_NULL(heap);
+	assert (NULL != is_match && "PHeapErase: Function pointer is invalid");
+
+	found = FindImp(heap, is_match, param);
+	if (NULL == found)
+	{
+		return NULL;
+	}
+
+	RemoveImp(heap, found);
+
+	return DATA_OF_IMP(heap, found);
+}
+
+/*******************************************************************************
+***************************** PHeap Find **************************************/
+void *PHeapFind(const pheap_ty *heap, PHeapIsMatch is_match, const void *param)
+{
+	pheap_node_ty *found = NULL;
+
+	PHASSERT_NOT_NULL(heap);
+	assert (NULL != is_match && "PHeapFind: Function pointer is invalid");
+
+	found = FindImp(heap, is_match, param);
+
+	return (NULL == found) ? NULL : DATA_OF_IMP(heap, found);
+}
+
+/*******************************************************************************
+***************************** PHeap Unlink ************************************/
+void PHeapUnlink(pheap_ty *heap, void *data)
+{
+	PHASSERT_NOT_NULL(heap);
+	assert (0 != heap->size && "PHeapUnlink: heap is empty");
+
+	RemoveImp(heap, NODE_OF_IMP(heap, data));
+}
+
+/*******************************************************************************
+***************************** PHeap UpdateKey *********************************/
+void PHeapUpdateKey(pheap_ty *heap, void *data, pheap_key_ty key)
+{
+	pheap_node_ty *node = NULL;
+
+	PHASSERT_NOT_NULL(heap);
+	assert (0 != heap->size && "PHeapUpdateKey: heap is empty");
+
+	node = NODE_OF_IMP(heap, data);
+
+	/* a bigger key may break the order with the children; an equal one
+	   goes behind the elements already at key, as a new push would */
+	if (key >= node->key)
+	{
+		RemoveImp(heap, node);
+		PHeapPush(heap, key, data);
+		return;
+	}
+
+	node->key = key;
+	node->seq = heap->next_seq++;
+
+	/* the subtree stays ordered; only its link to the parent may not */
+	if (node != heap->root)
+	{
+		CutImp(node);
+		heap->root = MeldImp(heap->root, node);
+	}
+}
+
+
+/*******************************************************************************
+***************************** Side Functions **********************************/
+/* both are roots (or NULL); the later becomes the leftmost child of the
+   earlier, by key and then push order */
+static pheap_node_ty *MeldImp(pheap_node_ty *first, pheap_node_ty *second)
+{
+	pheap_node_ty *swap = NULL;
+
+	if (NULL == first)
+	{
+		return second;
+	}
+	if (NULL == second)
+	{
+		return first;
+	}
+
+	if (IS_BEFORE_IMP(second, first))
+	{
+		swap = first;
+		first = second;
+		second = swap;
+	}
+
+	second->prev = first;
+	second->next = first->child;
+	if (NULL != first->child)
+	{
+		first->child->prev = second;
+	}
+	first->child = second;
+
+	return first;
+}
+
+/* two pass pairing of the sibling list starting at node: meld pairs left
+   to right, then meld the pairs right to left into one root */
+static pheap_node_ty *PairChildrenImp(pheap_node_ty *node)
+{
+	pheap_node_ty *pairs = NULL;	/* melded pairs, last one first */
+	pheap_node_ty *first = NULL;
+	pheap_node_ty *second = NULL;
+	pheap_node_ty *root = NULL;
+
+	while (NULL != node)
+	{
+		first = node;
+		second = node->next;
+		node = (NULL == second) ? NULL : second->next;
+
+		first->next = NULL;
+		first->prev = NULL;
+		if (NULL != second)
+		{
+			second->next = NULL;
+			second->prev = NULL;
+		}
+
+		first = MeldImp(first, second);
+		first->next = pairs;
+		pairs = first;
+	}
+
+	while (NULL != pairs)
+	{
+		first = pairs;
+		pairs = pairs->next;
+		first->next = NULL;
+
+		root = MeldImp(root, first);
+	}
+
+	return root;
+}
+
+/* detaches node and its subtree from its parent and siblings */
+static void CutImp(pheap_node_ty *node)
+{
+	if (node->prev->child == node)
+	{
+		node->prev->child = node->next;
+	}
+	else
+	{
+		node->prev->next = node->next;
+	}
+
+	if (NULL != node->next)
+	{
+		node->next->prev = node->prev;
+	}
+
+	node->next = NULL;
+	node->prev = NULL;
+}
+
+static void RemoveImp(pheap_ty *heap, pheap_node_ty *node)
+{
+	pheap_node_ty *children = PairChildrenImp(node->child);
+
+	if (node == heap->root)
+	{
+		heap->root = children;
+	}
+	else
+	{
+		CutImp(node);
+		heap->root = MeldImp(heap->root, children);
+	}
+
+	--heap->size;
+
+	/* break node fields */
+	DEBUG_MODE
+	(
+		node->child = INVALID_PTR;
+		node->next = INVALID_PTR;
+		node->prev = INVALID_PTR;
+	)
+}
+
+/* preorder walk: down to the leftmost child, else right, else up until a
+   node with a right sibling */
+static pheap_node_ty *FindImp(const pheap_ty *heap, PHeapIsMatch is_match,
+								const void *param)
+{
+	pheap_node_ty *node = heap->root;
+
+	while (NULL != node)
+	{
+		if (is_match(DATA_OF_IMP(heap, node), param))
+		{
+			return node;
+		}
+
+		if (NULL != node->child)
+		{
+			node = node->child;
+			continue;
+		}
+
+		while (NULL != node && NULL == node->next)
+		{
+			/* back to the leftmost sibling, whose prev is the parent */
+			while (NULL != node->prev && node->prev->child != node)
+			{
+				node = node->prev;
+			}
+			node = node->prev;
+		}
+
+		if (NULL != node)
+		{
+			node = node->next;
+		}
+	}
+
+	return NULL;
+}
@@ -11,16 +11,43 @@
 
 #include "utilities.h"
 #include "sorted_list.h"
+#include "dary_heap.h"
+#include "radix_heap.h"
+#include "pairing_heap.h"
 #include "pqueue.h"
 
 #define PQASSERT_NOT_NULL(ptr)									\
 		assert (NULL != ptr && "Priority Queue is not allocated");
 
+enum pq_backend_ty
+{
+	PQ_BACKEND_SORTL = 0,
+	PQ_BACKEND_DHEAP = 1,
+	PQ_BACKEND_RHEAP = 2,
+	PQ_BACKEND_PHEAP = 3
+};
+
 struct pqueue
 {
     sortl_ty *sortl;
+    int is_intrusive;		/* elements embed their list link or heap index */
+    enum pq_backend_ty backend;
+    dheap_ty *dheap;
+    rheap_ty *rheap;
+    pheap_ty *pheap;
+    size_t key_offset;
+    int is_keyed;			/* key read at key_offset, see PQueueUpdateKey */
 };
 
+#define KEY_OF_IMP(pqueue, data)										\
+		(*(const long *)((const char *)(data) + (pqueue)->key_offset))
+#define KEY_REF_IMP(pqueue, data)										\
+		(*(long *)((char *)(data) + (pqueue)->key_offset))
+
+static sortl_itr_ty RemoveImp(const pqueue_ty *pqueue, sortl_itr_ty where);
+static pqueue_ty *AllocImp(void);
+static int IsSameDataImp(const void *element_data, const void *param);
+
 
 /*******************************************************************************
 ***************************** PQueue Create ***********************************/
@@ -31,7 +58,7 @@ pqueue_ty *PQueueCreate(PQCmpFunc cmp_func_p, const void *cmp_param)
 	assert (NULL != cmp_func_p && "PQueueCreate: Function pointer is invalid");
 
 	/* allocate pqueue */
-	priority_queue = (pqueue_ty *)malloc(sizeof(pqueue_ty));
+	priority_queue = AllocImp();
 
 	/* check allocation failure */
 	if (NULL == priority_queue)
@@ -52,19 +79,215 @@ pqueue_ty *PQueueCreate(PQCmpFunc cmp_func_p, const void *cmp_param)
 	return priority_queue;
 }
 
+/*******************************************************************************
+***************************** PQueue CreateKeyed ******************************/
+pqueue_ty *PQueueCreateKeyed(size_t key_offset)
+{
+	pqueue_ty *priority_queue = AllocImp();
+
+	/* check allocation failure */
+	if (NULL == priority_queue)
+	{
+		return NULL;
+	}
+
+	/* allocate keyed sortl */
+	priority_queue->sortl = SortLCreateKeyed(key_offset);
+
+	/* check handle allocation failure */
+	if (NULL == priority_queue->sortl)
+	{
+		free(priority_queue);
+		return NULL;
+	}
+
+	priority_queue->key_offset = key_offset;
+	priority_queue->is_keyed = 1;
+
+	return priority_queue;
+}
+
+/*******************************************************************************
+***************************** PQueue CreateIntrusive ***************************/
+pqueue_ty *PQueueCreateIntrusive(size_t key_offset, size_t link_offset)
+{
+	pqueue_ty *priority_queue = AllocImp();
+
+	/* check allocation failure */
+	if (NULL == priority_queue)
+	{
+		return NULL;
+	}
+
+	/* allocate intrusive sortl */
+	priority_queue->sortl = SortLCreateIntrusive(key_offset, link_offset);
+
+	/* check handle allocation failure */
+	if (NULL == priority_queue->sortl)
+	{
+		free(priority_queue);
+		return NULL;
+	}
+
+	priority_queue->is_intrusive = 1;
+	priority_queue->key_offset = key_offset;
+	priority_queue->is_keyed = 1;
+
+	return priority_queue;
+}
+
+/*******************************************************************************
+***************************** PQueue CreateDAryHeap ***************************/
+pqueue_ty *PQueueCreateDAryHeap(size_t key_offset, size_t arity)
+{
+	pqueue_ty *priority_queue = AllocImp();
+
+	/* check allocation failure */
+	if (NULL == priority_queue)
+	{
+		return NULL;
+	}
+
+	/* allocate heap array */
+	priority_queue->dheap = DHeapCreate(arity);
+
+	/* check handle allocation failure */
+	if (NULL == priority_queue->dheap)
+	{
+		free(priority_queue);
+		return NULL;
+	}
+
+	priority_queue->backend = PQ_BACKEND_DHEAP;
+	priority_queue->key_offset = key_offset;
+	priority_queue->is_keyed = 1;
+
+	return priority_queue;
+}
+
+/*******************************************************************************
+************************** PQueue CreateDAryHeapIndexed ***********************/
+pqueue_ty *PQueueCreateDAryHeapIndexed(size_t key_offset, size_t arity,
+										size_t index_offset)
+{
+	pqueue_ty *priority_queue = AllocImp();
+
+	/* check allocation failure */
+	if (NULL == priority_queue)
+	{
+		return NULL;
+	}
+
+	/* allocate heap array */
+	priority_queue->dheap = DHeapCreateIndexed(arity, index_offset);
+
+	/* check handle allocation failure */
+	if (NULL == priority_queue->dheap)
+	{
+		free(priority_queue);
+		return NULL;
+	}
+
+	priority_queue->backend = PQ_BACKEND_DHEAP;
+	priority_queue->is_intrusive = 1;
+	priority_queue->key_offset = key_offset;
+	priority_queue->is_keyed = 1;
+
+	return priority_queue;
+}
+
+/*******************************************************************************
+***************************** PQueue CreateRadixHeap **************************/
+pqueue_ty *PQueueCreateRadixHeap(size_t key_offset)
+{
+	pqueue_ty *priority_queue = AllocImp();
+
+	/* check allocation failure */
+	if (NULL == priority_queue)
+	{
+		return NULL;
+	}
+
+	/* allocate radix heap */
+	priority_queue->rheap = RHeapCreate();
+
+	/* check handle allocation failure */
+	if (NULL == priority_queue->rheap)
+	{
+		free(priority_queue);
+		return NULL;
+	}
+
+	priority_queue->backend = PQ_BACKEND_RHEAP;
+	priority_queue->key_offset = key_offset;
+	priority_queue->is_keyed = 1;
+
+	return priority_queue;
+}
+
+/*******************************************************************************
+***************************** PQueue CreatePairingHeap ************************/
+pqueue_ty *PQueueCreatePairingHeap(size_t key_offset, size_t node_offset)
+{
+	pqueue_ty *priority_queue = AllocImp();
+
+	/* check allocation failure */
+	if (NULL == priority_queue)
+	{
+		return NULL;
+	}
+
+	/* allocate pairing heap */
+	priority_queue->pheap = PHeapCreate(node_offset);
+
+	/* check handle allocation failure */
+	if (NULL == priority_queue->pheap)
+	{
+		free(priority_queue);
+		return NULL;
+	}
+
+	priority_queue->backend = PQ_BACKEND_PHEAP;
+	priority_queue->is_intrusive = 1;
+	priority_queue->key_offset = key_offset;
+	priority_queue->is_keyed = 1;
+
+	return priority_queue;
+}
+
 /*******************************************************************************
 ***************************** PQueue Destroy **********************************/
 void PQueueDestroy(pqueue_ty *pqueue)
 {
 	PQASSERT_NOT_NULL(pqueue);
 
-	/* free pqueue */
-	SortLDestroy(pqueue->sortl);
+	/* free backend */
+	switch (pqueue->backend)
+	{
+		case PQ_BACKEND_DHEAP:
+			DHeapDestroy(pqueue->dheap);
+			break;
+
+		case PQ_BACKEND_RHEAP:
+			RHeapDestroy(pqueue->rheap);
+			break;
+
+		case PQ_BACKEND_PHEAP:
+			PHeapDestroy(pqueue->pheap);
+			break;
+
+		default:
+			SortLDestroy(pqueue->sortl);
+			break;
+	}
 
 	/* break pqueue fields */
     DEBUG_MODE
     (
     	pqueue->sortl = INVALID_PTR;
+    	pqueue->dheap = INVALID_PTR;
+    	pqueue->rheap = INVALID_PTR;
+    	pqueue->pheap = INVALID_PTR;
     )
 	free(pqueue);
 }
@@ -77,12 +300,49 @@ int PQueueEnqueue(pqueue_ty *pqueue, void *data)
 
 	PQASSERT_NOT_NULL(pqueue);
 
+	switch (pqueue->backend)
+	{
+		case PQ_BACKEND_DHEAP:
+			return DHeapPush(pqueue->dheap, KEY_OF_IMP(pqueue, data), data);
+
+		case PQ_BACKEND_RHEAP:
+			return RHeapPush(pqueue->rheap, KEY_OF_IMP(pqueue, data), data);
+
+		case PQ_BACKEND_PHEAP:
+			PHeapPush(pqueue->pheap, KEY_OF_IMP(pqueue, data), data);
+			return 0;
+
+		default:
+			break;
+	}
+
 	ret_itr = SortLInsert(pqueue->sortl, data);
 
 	/* check if insertion faild */
 	return (SortLIsSameIter(ret_itr, SortLEnd(pqueue->sortl)));
 }
 
+/*******************************************************************************
+***************************** PQueue EnqueueBack ******************************/
+int PQueueEnqueueBack(pqueue_ty *pqueue, void *data)
+{
+	sortl_itr_ty ret_itr = {NULL};
+
+	PQASSERT_NOT_NULL(pqueue);
+
+	/* heaps have no position to search */
+	if (PQ_BACKEND_SORTL != pqueue->backend)
+	{
+		return PQueueEnqueue(pqueue, data);
+	}
+
+	/* search the position starting from the tail */
+	ret_itr = SortLInsertHint(pqueue->sortl, SortLEnd(pqueue->sortl), data);
+
+	/* check if insertion faild */
+	return (SortLIsSameIter(ret_itr, SortLEnd(pqueue->sortl)));
+}
+
 /*******************************************************************************
 ***************************** PQueue Dequeue **********************************/
 void PQueueDequeue(pqueue_ty *pqueue)
@@ -91,11 +351,29 @@ void PQueueDequeue(pqueue_ty *pqueue)
 
  	PQASSERT_NOT_NULL(pqueue);
 
+	switch (pqueue->backend)
+	{
+		case PQ_BACKEND_DHEAP:
+			DHeapPop(pqueue->dheap);
+			return;
+
+		case PQ_BACKEND_RHEAP:
+			RHeapPop(pqueue->rheap);
+			return;
+
+		case PQ_BACKEND_PHEAP:
+			PHeapPop(pqueue->pheap);
+			return;
+
+		default:
+			break;
+	}
+
  	/* get the first valid iterator in list */
  	high_priority = SortLBegin(pqueue->sortl);
 
  	/* remove the result */
- 	SortLRemove(high_priority);
+ 	RemoveImp(pqueue, high_priority);
 }
 
 /*******************************************************************************
@@ -104,6 +382,21 @@ void *PQueuePeek(const pqueue_ty *pqueue)
 {
  	PQASSERT_NOT_NULL(pqueue);
 
+	switch (pqueue->backend)
+	{
+		case PQ_BACKEND_DHEAP:
+			return DHeapPeek(pqueue->dheap);
+
+		case PQ_BACKEND_RHEAP:
+			return RHeapPeek(pqueue->rheap);
+
+		case PQ_BACKEND_PHEAP:
+			return PHeapPeek(pqueue->pheap);
+
+		default:
+			break;
+	}
+
 	return SortLGetData(SortLBegin(pqueue->sortl));
 }
 
@@ -113,7 +406,7 @@ int PQueueIsEmpty(const pqueue_ty *pqueue)
 {
  	PQASSERT_NOT_NULL(pqueue);
 
- 	return SortLIsEmpty(pqueue->sortl);
+ 	return (0 == PQueueSize(pqueue));
 
 }
 
@@ -123,6 +416,21 @@ size_t PQueueSize(const pqueue_ty *pqueue)
 {
  	PQASSERT_NOT_NULL(pqueue);
 
+	switch (pqueue->backend)
+	{
+		case PQ_BACKEND_DHEAP:
+			return DHeapSize(pqueue->dheap);
+
+		case PQ_BACKEND_RHEAP:
+			return RHeapSize(pqueue->rheap);
+
+		case PQ_BACKEND_PHEAP:
+			return PHeapSize(pqueue->pheap);
+
+		default:
+			break;
+	}
+
 	return SortLCount(pqueue->sortl);
 }
 
@@ -132,6 +440,24 @@ void PQueueClear(pqueue_ty *pqueue)
 {
  	PQASSERT_NOT_NULL(pqueue);
 
+	switch (pqueue->backend)
+	{
+		case PQ_BACKEND_DHEAP:
+			DHeapClear(pqueue->dheap);
+			return;
+
+		case PQ_BACKEND_RHEAP:
+			RHeapClear(pqueue->rheap);
+			return;
+
+		case PQ_BACKEND_PHEAP:
+			PHeapClear(pqueue->pheap);
+			return;
+
+		default:
+			break;
+	}
+
 	/* traverse pqueue and dequeue each element until it gets empty */
 	while (!PQueueIsEmpty(pqueue))
 	{
@@ -151,6 +477,21 @@ void *PQueueErase(pqueue_ty *pqueue, const PQIsMatch match_func, void *param)
  	PQASSERT_NOT_NULL(pqueue);
 	assert (NULL != match_func && "PQueueErase: Function pointer is invalid");
 
+	switch (pqueue->backend)
+	{
+		case PQ_BACKEND_DHEAP:
+			return DHeapErase(pqueue->dheap, match_func, param);
+
+		case PQ_BACKEND_RHEAP:
+			return RHeapErase(pqueue->rheap, match_func, param);
+
+		case PQ_BACKEND_PHEAP:
+			return PHeapErase(pqueue->pheap, match_func, param);
+
+		default:
+			break;
+	}
+
 	begin = SortLBegin(pqueue->sortl);
 	end = SortLEnd(pqueue->sortl);
 
@@ -167,11 +508,187 @@ void *PQueueErase(pqueue_ty *pqueue, const PQIsMatch match_func, void *param)
 	ret_data = SortLGetData(to_erase);
 
 	/* remove the founded element */
-	SortLRemove(to_erase);
+	RemoveImp(pqueue, to_erase);
 
 	return ret_data;
 }
 
+/*******************************************************************************
+***************************** PQueue Find *************************************/
+void *PQueueFind(const pqueue_ty *pqueue, const PQIsMatch match_func, void *param)
+{
+ 	sortl_itr_ty end = {NULL};
+ 	sortl_itr_ty found = {NULL};
+
+ 	PQASSERT_NOT_NULL(pqueue);
+	assert (NULL != match_func && "PQueueFind: Function pointer is invalid");
+
+	switch (pqueue->backend)
+	{
+		case PQ_BACKEND_DHEAP:
+			return DHeapFind(pqueue->dheap, match_func, param);
+
+		case PQ_BACKEND_RHEAP:
+			return RHeapFind(pqueue->rheap, match_func, param);
+
+		case PQ_BACKEND_PHEAP:
+			return PHeapFind(pqueue->pheap, match_func, param);
+
+		default:
+			break;
+	}
+
+	end = SortLEnd(pqueue->sortl);
+	found = SortLFindIf(SortLBegin(pqueue->sortl), end, match_func, param);
+
+	return (SortLIsSameIter(found, end) ? NULL : SortLGetData(found));
+}
+
+/*******************************************************************************
+***************************** PQueue Unlink ***********************************/
+void PQueueUnlink(pqueue_ty *pqueue, void *data)
+{
+ 	PQASSERT_NOT_NULL(pqueue);
+
+	switch (pqueue->backend)
+	{
+		case PQ_BACKEND_DHEAP:
+			if (pqueue->is_intrusive)
+			{
+				DHeapUnlink(pqueue->dheap, data);
+			}
+			else
+			{
+				DHeapErase(pqueue->dheap, IsSameDataImp, data);
+			}
+			return;
+
+		case PQ_BACKEND_RHEAP:
+			RHeapEraseKey(pqueue->rheap, KEY_OF_IMP(pqueue, data),
+							IsSameDataImp, data);
+			return;
+
+		case PQ_BACKEND_PHEAP:
+			PHeapUnlink(pqueue->pheap, data);
+			return;
+
+		default:
+			break;
+	}
+
+	/* the element holds its own node, no search is needed */
+	if (pqueue->is_intrusive)
+	{
+		SortLUnlink(SortLItrOf(pqueue->sortl, data));
+		return;
+	}
+
+	PQueueErase(pqueue, IsSameDataImp, data);
+}
+
+/*******************************************************************************
+***************************** PQueue UpdateKey ********************************/
+int PQueueUpdateKey(pqueue_ty *pqueue, void *data, long new_key)
+{
+	sortl_itr_ty where = {NULL};
+
+ 	PQASSERT_NOT_NULL(pqueue);
+	assert (pqueue->is_keyed && "PQueueUpdateKey: pqueue is not keyed");
+
+	switch (pqueue->backend)
+	{
+		case PQ_BACKEND_DHEAP:
+			KEY_REF_IMP(pqueue, data) = new_key;
+			DHeapUpdateKey(pqueue->dheap, data, new_key);
+			return 0;
+
+		case PQ_BACKEND_RHEAP:
+			if (new_key < RHeapGetFloor(pqueue->rheap))
+			{
+				return 1;
+			}
+
+			/* the erased slot is reused, push does not allocate */
+			RHeapEraseKey(pqueue->rheap, KEY_OF_IMP(pqueue, data),
+							IsSameDataImp, data);
+			KEY_REF_IMP(pqueue, data) = new_key;
+			return RHeapPush(pqueue->rheap, new_key, data);
+
+		case PQ_BACKEND_PHEAP:
+			KEY_REF_IMP(pqueue, data) = new_key;
+			PHeapUpdateKey(pqueue->pheap, data, new_key);
+			return 0;
+
+		default:
+			break;
+	}
 
+	/* the element keeps its node, so the move can not fail */
+	if (pqueue->is_intrusive)
+	{
+		where = SortLItrOf(pqueue->sortl, data);
+	}
+	else
+	{
+		where = SortLFindIf(SortLBegin(pqueue->sortl), SortLEnd(pqueue->sortl),
+							IsSameDataImp, data);
+	}
 
+	KEY_REF_IMP(pqueue, data) = new_key;
+	SortLReposition(where);
 
+	return 0;
+}
+
+/*******************************************************************************
+***************************** PQueue SetFloor *********************************/
+void PQueueSetFloor(pqueue_ty *pqueue, long floor)
+{
+ 	PQASSERT_NOT_NULL(pqueue);
+
+	/* only the radix heap depends on keys being monotone */
+	if (PQ_BACKEND_RHEAP == pqueue->backend)
+	{
+		RHeapSetFloor(pqueue->rheap, floor);
+	}
+}
+
+
+/*******************************************************************************
+***************************** Side Functions **********************************/
+static sortl_itr_ty RemoveImp(const pqueue_ty *pqueue, sortl_itr_ty where)
+{
+	/* intrusive nodes belong to the elements, only detach them */
+	if (pqueue->is_intrusive)
+	{
+		return SortLUnlink(where);
+	}
+
+	return SortLRemove(where);
+}
+
+static pqueue_ty *AllocImp(void)
+{
+	pqueue_ty *priority_queue = (pqueue_ty *)malloc(sizeof(pqueue_ty));
+
+	if (NULL == priority_queue)
+	{
+		return NULL;
+	}
+
+	priority_queue->sortl = NULL;
+	priority_queue->is_intrusive = 0;
+	priority_queue->backend = PQ_BACKEND_SORTL;
+	priority_queue->dheap = NULL;
+	priority_queue->rheap = NULL;
+	priority_queue->pheap = NULL;
+	priority_queue->key_offset = 0;
+	priority_queue->is_keyed = 0;
+
+	return priority_queue;
+}
+
+static int IsSameDataImp(const void *element_data, const void *param)
+{
+	return (element_data == param);
+}
@@ -0,0 +1,364 @@
+/*******************************************************************************
+******************************** - RADIX HEAP - *******************************
+*
+*	DESCRIPTION		Implementation of radix heap
+*	AUTHOR 			Liad Raz
+*
+*******************************************************************************/
+
+#include <stdlib.h>			/* malloc, free */
+#include <limits.h>			/* CHAR_BIT */
+#include <assert.h>			/* assert */
+
+#include "utilities.h"
+#include "radix_heap.h"
+#include "slot_pool.h"
+
+#define RHASSERT_NOT_NULL(ptr)									\
+		assert (NULL != ptr && "Radix heap is not allocated");
+
+/* bucket 0 holds keys equal to the floor, bucket b keys whose highest bit
+   different from the floor is bit b - 1 */
+#define RHEAP_BUCKETS 		(sizeof(unsigned long) * CHAR_BIT + 1)
+#define RHEAP_INIT_CAPACITY 64
+
+/* moving an element to another bucket relinks its slot, see slot_pool.h */
+struct rheap
+{
+	slot_pool_ty pool;
+	unsigned long floor;
+	pool_chain_ty buckets[RHEAP_BUCKETS];
+};
+
+static size_t BucketOfImp(unsigned long key, unsigned long floor);
+static void RefillImp(rheap_ty *heap);
+static void ResetBucketsImp(rheap_ty *heap);
+
+
+/*******************************************************************************
+***************************** RHeap Create ************************************/
+rheap_ty *RHeapCreate(void)
+{
+	rheap_ty *heap = (rheap_ty *)malloc(sizeof(rheap_ty));
+
+	/* check allocation failure */
+	if (NULL == heap)
+	{
+		return NULL;
+	}
+
+	/* check allocation failure */
+	if (SlotPoolInit(&heap->pool, RHEAP_INIT_CAPACITY))
+	{
+		free(heap);
+		return NULL;
+	}
+
+	RHeapClear(heap);
+
+	return heap;
+}
+
+/*******************************************************************************
+***************************** RHeap Destroy ***********************************/
+void RHeapDestroy(rheap_ty *heap)
+{
+	RHASSERT_NOT_NULL(heap);
+
+	SlotPoolFree(&heap->pool);
+	free(heap);
+}
+
+/*******************************************************************************
+***************************** RHeap Push **************************************/
+int RHeapPush(rheap_ty *heap, rheap_key_ty key, void *data)
+{
+	unsigned long ukey = SLOT_POOL_TO_UKEY(key);
+	size_t slot = 0;
+
+	RHASSERT_NOT_NULL(heap);
+	assert (ukey >= heap->floor
+	&& "RHeapPush: key is smaller than the last peeked or popped key");
+
+	if (ukey < heap->floor)
+	{
+		return 1;
+	}
+
+	slot = SlotPoolAcquire(&heap->pool, ukey, data);
+	if (SLOT_POOL_NIL == slot)
+	{
+		return 1;
+	}
+
+	SlotChainAppend(&heap->pool, &heap->buckets[BucketOfImp(ukey, heap->floor)], slot);
+
+	return 0;
+}
+
+/*******************************************************************************
+***************************** RHeap Pop ***************************************/
+void RHeapPop(rheap_ty *heap)
+{
+	RHASSERT_NOT_NULL(heap);
+	assert (0 != heap->pool.size && "RHeapPop: Cannot pop an empty heap");
+
+	RefillImp(heap);
+
+	/* detach the head of bucket 0 and release its slot */
+	SlotPoolRelease(&heap->pool, SlotChainPopHead(&heap->pool, &heap->buckets[0]));
+}
+
+/*******************************************************************************
+***************************** RHeap Peek **************************************/
+void *RHeapPeek(rheap_ty *heap)
+{
+	RHASSERT_NOT_NULL(heap);
+
+	if (0 == heap->pool.size)
+	{
+		return NULL;
+	}
+
+	RefillImp(heap);
+
+	return heap->pool.slots[heap->buckets[0].head].data;
+}
+
+/*******************************************************************************
+***************************** RHeap PeekKey ***********************************/
+rheap_key_ty RHeapPeekKey(rheap_ty *heap)
+{
+	RHASSERT_NOT_NULL(heap);
+	assert (0 != heap->pool.size && "RHeapPeekKey: heap is empty");
+
+	RefillImp(heap);
+
+	return SLOT_POOL_TO_KEY(heap->floor);
+}
+
+/*******************************************************************************
+***************************** RHeap SetFloor **********************************/
+void RHeapSetFloor(rheap_ty *heap, rheap_key_ty floor)
+{
+	pool_chain_ty all = {SLOT_POOL_NIL, SLOT_POOL_NIL};
+	size_t slot = 0;
+	size_t next = 0;
+	size_t bucket = 0;
+
+	RHASSERT_NOT_NULL(heap);
+
+	if (SLOT_POOL_TO_UKEY(floor) == heap->floor)
+	{
+		return;
+	}
+
+	/* chain all buckets in bucket order; equal keys share a bucket, so
+	   their insertion order is kept */
+	for (bucket = 0; bucket < RHEAP_BUCKETS; ++bucket)
+	{
+		if (SLOT_POOL_NIL == heap->buckets[bucket].head)
+		{
+			continue;
+		}
+
+		if (SLOT_POOL_NIL == all.head)
+		{
+			all.head = heap->buckets[bucket].head;
+		}
+		else
+		{
+			heap->pool.slots[all.tail].next = heap->buckets[bucket].head;
+		}
+		all.tail = heap->buckets[bucket].tail;
+	}
+
+	ResetBucketsImp(heap);
+	heap->floor = SLOT_POOL_TO_UKEY(floor);
+
+	/* distribute again relative to the new floor */
+	for (slot = all.head; SLOT_POOL_NIL != slot; slot = next)
+	{
+		next = heap->pool.slots[slot].next;
+
+		assert (heap->pool.slots[slot].key >= heap->floor
+		&& "RHeapSetFloor: floor is bigger than a queued key");
+
+		SlotChainAppend(&heap->pool,
+						&heap->buckets[BucketOfImp(heap->pool.slots[slot].key, heap->floor)],
+						slot);
+	}
+}
+
+/*******************************************************************************
+***************************** RHeap GetFloor **********************************/
+rheap_key_ty RHeapGetFloor(const rheap_ty *heap)
+{
+	RHASSERT_NOT_NULL(heap);
+
+	return SLOT_POOL_TO_KEY(heap->floor);
+}
+
+/*******************************************************************************
+***************************** RHeap Size **************************************/
+size_t RHeapSize(const rheap_ty *heap)
+{
+	RHASSERT_NOT_NULL(heap);
+
+	return heap->pool.size;
+}
+
+/*******************************************************************************
+***************************** RHeap IsEmpty ***********************************/
+int RHeapIsEmpty(const rheap_ty *heap)
+{
+	RHASSERT_NOT_NULL(heap);
+
+	return (0 == heap->pool.size);
+}
+
+/*******************************************************************************
+***************************** RHeap Clear *************************************/
+void RHeapClear(rheap_ty *heap)
+{
+	RHASSERT_NOT_NULL(heap);
+
+	SlotPoolClear(&heap->pool);
+	heap->floor = 0;
+	ResetBucketsImp(heap);
+}
+
+/*******************************************************************************
+***************************** RHeap Erase *************************************/
+void *RHeapErase(rheap_ty *heap, RHeapIsMatch is_match, const void *param)
+{
+	void *ret_data = NULL;
+	size_t i = 0;
+
+	RHASSERT_NOT_NULL(heap);
+	assert (NULL != is_match && "RHeapErase: Function pointer is invalid");
+
+	for (i = 0; i < RHEAP_BUCKETS && NULL == ret_data; ++i)
+	{
+		ret_data = SlotChainErase(&heap->pool, &heap->buckets[i], is_match, param);
+	}
+
+	return ret_data;
+}
+
+/*******************************************************************************
+***************************** RHeap EraseKey **********************************/
+void *RHeapEraseKey(rheap_ty *heap, rheap_key_ty key, RHeapIsMatch is_match,
+					const void *param)
+{
+	RHASSERT_NOT_NULL(heap);
+	assert (NULL != is_match && "RHeapEraseKey: Function pointer is invalid");
+
+	/* every element sits in the bucket of its key relative to the floor */
+	if (SLOT_POOL_TO_UKEY(key) < heap->floor)
+	{
+		return NULL;
+	}
+
+	return SlotChainErase(&heap->pool,
+						&heap->buckets[BucketOfImp(SLOT_POOL_TO_UKEY(key), heap->floor)],
+						is_match, param);
+}
+
+/*******************************************************************************
+***************************** RHeap Find **************************************/
+void *RHeapFind(const rheap_ty *heap, RHeapIsMatch is_match, const void *param)
+{
+	void *ret_data = NULL;
+	size_t i = 0;
+
+	RHASSERT_NOT_NULL(heap);
+	assert (NULL != is_match && "RHeapFind: Function pointer is invalid");
+
+	for (i = 0; i < RHEAP_BUCKETS && NULL == ret_data; ++i)
+	{
+		ret_data = SlotChainFind(&heap->pool, &heap->buckets[i], is_match, param);
+	}
+
+	return ret_data;
+}
+
+
+/*******************************************************************************
+***************************** Side Functions **********************************/
+static size_t BucketOfImp(unsigned long key, unsigned long floor)
+{
+	unsigned long diff = key ^ floor;
+	size_t bucket = 0;
+
+	if (0 == diff)
+	{
+		return 0;
+	}
+
+#ifdef __GNUC__
+	bucket = sizeof(unsigned long) * CHAR_BIT - (size_t)__builtin_clzl(diff);
+#else
+	while (0 != diff)
+	{
+		diff >>= 1;
+		++bucket;
+	}
+#endif
+
+	return bucket;
+}
+
+/* when bucket 0 is empty, raise the floor to the smallest key of the first
+   non-empty bucket and spread that bucket over the lower ones */
+static void RefillImp(rheap_ty *heap)
+{
+	pool_chain_ty to_spread = {SLOT_POOL_NIL, SLOT_POOL_NIL};
+	size_t bucket = 1;
+	size_t slot = 0;
+	size_t next = 0;
+	unsigned long min_key = 0;
+
+	if (SLOT_POOL_NIL != heap->buckets[0].head)
+	{
+		return;
+	}
+
+	while (SLOT_POOL_NIL == heap->buckets[bucket].head)
+	{
+		++bucket;
+	}
+
+	to_spread = heap->buckets[bucket];
+	SlotChainReset(&heap->buckets[bucket]);
+
+	min_key = heap->pool.slots[to_spread.head].key;
+	for (slot = to_spread.head; SLOT_POOL_NIL != slot; slot = heap->pool.slots[slot].next)
+	{
+		if (heap->pool.slots[slot].key < min_key)
+		{
+			min_key = heap->pool.slots[slot].key;
+		}
+	}
+
+	heap->floor = min_key;
+
+	/* every key of the bucket now differs from the floor below bit bucket - 1 */
+	for (slot = to_spread.head; SLOT_POOL_NIL != slot; slot = next)
+	{
+		next = heap->pool.slots[slot].next;
+		SlotChainAppend(&heap->pool,
+						&heap->buckets[BucketOfImp(heap->pool.slots[slot].key, min_key)],
+						slot);
+	}
+}
+
+static void ResetBucketsImp(rheap_ty *heap)
+{
+	size_t bucket = 0;
+
+	for (bucket = 0; bucket < RHEAP_BUCKETS; ++bucket)
+	{
+		SlotChainReset(&heap->buckets[bucket]);
+	}
+}
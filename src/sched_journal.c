@@ -0,0 +1,349 @@
+/*******************************************************************************
+*************************** - SCHEDULER JOURNAL - ******************************
+*
+*	DESCRIPTION		Impl of the journal of task events
+*	AUTHOR 			Liad Raz
+*
+*******************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L	/* fsync, fileno */
+
+#include <stdio.h>			/* FILE, fread, fwrite, fflush, ftell */
+#include <stdlib.h>			/* malloc, free */
+#include <string.h>			/* memcmp, memcpy */
+#include <time.h>			/* time_t */
+#include <unistd.h>			/* fsync */
+#include <assert.h>			/* assert */
+
+#include "pqueue.h"			/* PQueueSetFloor */
+#include "scheduler.h"
+#include "scheduler_internal.h"
+#include "sched_journal.h"
+
+/* journal, little endian: header (magic, version, record size), then one
+   record per event: kind, id, type key, interval, time left (64 bit) and
+   the checksum of them (32 bit) */
+#define JRNL_MAGIC 			"SCHEDJNL"
+#define JRNL_VERSION 		1
+#define JRNL_HEADER_SIZE 	16
+#define JRNL_RECORD_SIZE 	40
+
+/* events are buffered by stream and made durable a group at a time */
+struct journal
+{
+    FILE			*stream;
+    const sched_task_type_ty *types;
+    size_t			num_types;
+    size_t			group_size;		/* events per fsync */
+    size_t			num_pending;	/* events since the last fsync */
+    int				has_failed;		/* an event or a commit was lost */
+};
+
+static int ReplayIMP(scheduler_ty *sched, const unsigned char *record,
+					const sched_task_type_ty *types, size_t num_types);
+static int ReplayAddIMP(scheduler_ty *sched, sched_id_ty id, time_t interval,
+						time_t left, const sched_task_type_ty *type);
+static void DropTaskIMP(scheduler_ty *sched, task_ty *task);
+
+/*******************************************************************************
+*************************** SchedJournalStart *********************************/
+int SchedJournalStart(scheduler_ty *scheduler, FILE *stream,
+					const sched_task_type_ty *types, size_t num_types,
+					size_t group_size)
+{
+	unsigned char header[JRNL_HEADER_SIZE];
+	journal_ty *journal = NULL;
+
+	SC_ASSERT_NOT_NULL(scheduler);
+	assert (NULL != stream && "SchedJournalStart: stream is NULL");
+	assert (0 != group_size && "SchedJournalStart: group_size can not be zero");
+
+	if (NULL != scheduler->journal)
+	{
+		return 1;
+	}
+
+	journal = (journal_ty *)malloc(sizeof(journal_ty));
+	if (NULL == journal)
+	{
+		return 1;
+	}
+
+	journal->stream = stream;
+	journal->types = types;
+	journal->num_types = num_types;
+	journal->group_size = group_size;
+	journal->num_pending = 0;
+	journal->has_failed = 0;
+
+	/* a new journal starts with its header; an old one is appended to */
+	if (0 == ftell(stream))
+	{
+		memcpy(header, JRNL_MAGIC, 8);
+		PutIMP(header + 8, JRNL_VERSION, 4);
+		PutIMP(header + 12, JRNL_RECORD_SIZE, 4);
+		if (1 != fwrite(header, JRNL_HEADER_SIZE, 1, stream) ||
+			0 != fflush(stream) || 0 != fsync(fileno(stream)))
+		{
+			free(journal);
+			return 1;
+		}
+	}
+
+	scheduler->journal = journal;
+
+	return 0;
+}
+
+/*******************************************************************************
+*************************** SchedJournalSync **********************************/
+int SchedJournalSync(scheduler_ty *scheduler)
+{
+	SC_ASSERT_NOT_NULL(scheduler);
+
+	if (NULL == scheduler->journal)
+	{
+		return 1;
+	}
+
+	return (CommitIMP(scheduler->journal) || scheduler->journal->has_failed);
+}
+
+/*******************************************************************************
+*************************** SchedJournalStop **********************************/
+int SchedJournalStop(scheduler_ty *scheduler)
+{
+	int status = 0;
+
+	SC_ASSERT_NOT_NULL(scheduler);
+
+	status = SchedJournalSync(scheduler);
+	free(scheduler->journal);
+	scheduler->journal = NULL;
+
+	return status;
+}
+
+/*******************************************************************************
+************************** SchedJournalReplay *********************************/
+int SchedJournalReplay(scheduler_ty *scheduler, FILE *stream,
+						const sched_task_type_ty *types, size_t num_types)
+{
+	unsigned char record[JRNL_RECORD_SIZE];
+	SchedHookFunc on_remove = NULL;
+	int status = 0;
+
+	SC_ASSERT_NOT_NULL(scheduler);
+	assert (NULL != stream && "SchedJournalReplay: stream is NULL");
+
+	/* replayed events must not be journaled again */
+	if (scheduler->should_run || NULL != scheduler->map ||
+		NULL != scheduler->journal || NULL != scheduler->shm)
+	{
+		return 1;
+	}
+
+	if (1 != fread(record, JRNL_HEADER_SIZE, 1, stream) ||
+		0 != memcmp(record, JRNL_MAGIC, 8) ||
+		JRNL_VERSION != GetIMP(record + 8, 4) ||
+		JRNL_RECORD_SIZE != GetIMP(record + 12, 4))
+	{
+		return 1;
+	}
+
+	/* times left count from a clock of 0, like SchedLoad */
+	PQueueSetFloor(scheduler->tasks, 0);
+
+	/* the removals replayed were reported when they happened */
+	on_remove = scheduler->hooks.on_remove;
+	scheduler->hooks.on_remove = NULL;
+
+	/* a record cut short or not matching its checksum is where a crash
+	   stopped writing: the journal ends before it */
+	while (0 == status && 1 == fread(record, JRNL_RECORD_SIZE, 1, stream) &&
+			GetIMP(record + 36, 4) == ChecksumIMP(record, 36))
+	{
+		status = ReplayIMP(scheduler, record, types, num_types);
+	}
+
+	scheduler->hooks.on_remove = on_remove;
+
+	/* replayed adds took their slots straight, not from the free list */
+	ChainFreeSlotsIMP(scheduler);
+
+	return status;
+}
+
+/*******************************************************************************
+***************************** Side Functions **********************************/
+void JournalIMP(scheduler_ty *sched, enum journal_kind kind,
+				sched_id_ty id, const task_ty *task)
+{
+	journal_ty *journal = sched->journal;
+	const sched_task_type_ty *type = NULL;
+	unsigned char record[JRNL_RECORD_SIZE] = {0};
+
+	if (NULL == journal)
+	{
+		return;
+	}
+
+	PutIMP(record, kind, 4);
+	PutIMP(record + 4, id, 8);
+	if (NULL != task)
+	{
+		/* SchedAdd checked the type; a client of a shared segment did not */
+		type = TypeOfFuncIMP(journal->types, journal->num_types, task->task_func_p);
+		if (NULL == type)
+		{
+			journal->has_failed = 1;
+			return;
+		}
+
+		PutIMP(record + 12, type->key, 8);
+		PutIMP(record + 20, (unsigned long)task->interval, 8);
+		PutIMP(record + 28, (unsigned long)TimeLeftIMP(sched, task), 8);
+	}
+	PutIMP(record + 36, ChecksumIMP(record, 36), 4);
+
+	if (1 != fwrite(record, JRNL_RECORD_SIZE, 1, journal->stream))
+	{
+		journal->has_failed = 1;
+	}
+
+	if (++journal->num_pending >= journal->group_size)
+	{
+		CommitIMP(journal);
+	}
+}
+
+int CommitIMP(journal_ty *journal)
+{
+	if (0 == journal->num_pending)
+	{
+		return 0;
+	}
+
+	journal->num_pending = 0;
+	if (0 != fflush(journal->stream) || 0 != fsync(fileno(journal->stream)))
+	{
+		journal->has_failed = 1;
+		return 1;
+	}
+
+	return 0;
+}
+
+int JournalHasTypeIMP(const journal_ty *journal, TaskFunc func)
+{
+	return (NULL != TypeOfFuncIMP(journal->types, journal->num_types, func));
+}
+
+static int ReplayIMP(scheduler_ty *sched, const unsigned char *record,
+					const sched_task_type_ty *types, size_t num_types)
+{
+	const sched_task_type_ty *type = NULL;
+	sched_id_ty id = GetIMP(record + 4, 8);
+	time_t interval = (time_t)GetIMP(record + 20, 8);
+	time_t left = (time_t)GetIMP(record + 28, 8);
+	task_ty *task = NULL;
+
+	switch (GetIMP(record, 4))
+	{
+		case JRNL_ADD:
+			type = TypeOfKeyIMP(types, num_types, GetIMP(record + 12, 8));
+			if (NULL == type || 0 == (id >> SLOT_BITS) || 0 == interval)
+			{
+				return 1;
+			}
+			return ReplayAddIMP(sched, id, interval, left, type);
+
+		/* the task may be gone already: the snapshot was taken after */
+		case JRNL_REMOVE:
+			task = LookupIMP(sched, id);
+			if (NULL != task)
+			{
+				DropTaskIMP(sched, task);
+			}
+			return 0;
+
+		case JRNL_RESCHEDULE:
+			task = LookupIMP(sched, id);
+			return (NULL != task && 0 != interval &&
+					RepositionIMP(sched, task, left, interval));
+
+		case JRNL_CLEAR:
+			ClearTasksIMP(sched);
+			return 0;
+
+		default:
+			return 1;
+	}
+}
+
+/* the task takes the slot of its id, replacing the one there: then the
+   add was in the snapshot already */
+static int ReplayAddIMP(scheduler_ty *sched, sched_id_ty id, time_t interval,
+						time_t left, const sched_task_type_ty *type)
+{
+	size_t idx = (size_t)(id & SLOT_MASK);
+	size_t num_slots = 2 * sched->num_slots;
+	task_ty *task = NULL;
+
+	/* doubling, as adding does, keeps replaying many adds linear */
+	if (idx >= sched->num_slots)
+	{
+		num_slots = (idx >= num_slots) ? idx + 1 : num_slots;
+		if (num_slots - 1 > SLOT_MASK)
+		{
+			num_slots = (size_t)SLOT_MASK + 1;
+		}
+		if (GrowSlotsIMP(sched, num_slots))
+		{
+			return 1;
+		}
+	}
+
+	if (NULL != sched->slots[idx].task)
+	{
+		DropTaskIMP(sched, sched->slots[idx].task);
+	}
+
+	task = (task_ty *)malloc(sizeof(task_ty));
+	if (NULL == task)
+	{
+		return 1;
+	}
+
+	task->task_func_p = type->task_func;
+	task->params = type->params;
+	task->interval = interval;
+	task->next_run = left;
+	task->id = id;
+	task->is_cancelled = 0;
+	task->is_in_fifo = 0;
+	task->is_rescheduled = 0;
+
+	sched->slots[idx].task = task;
+	sched->slots[idx].generation = id >> SLOT_BITS;
+
+	if (EnqueueIMP(sched, task))
+	{
+		FreeTaskIMP(sched, task);
+		return 1;
+	}
+
+	return 0;
+}
+
+/* removes a queued task, a cancelled one included */
+static void DropTaskIMP(scheduler_ty *sched, task_ty *task)
+{
+	if (task->is_cancelled)
+	{
+		--sched->num_cancelled;
+	}
+
+	UnlinkIMP(sched, task);
+	FreeTaskIMP(sched, task);
+}
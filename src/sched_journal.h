@@ -0,0 +1,34 @@
+/*******************************************************************************
+*************************** - SCHEDULER JOURNAL - ******************************
+*
+*	DESCRIPTION		Internal - the journal of task events, SchedJournalStart
+*	AUTHOR 			Liad Raz
+*	FILES			sched_journal.c sched_journal.h scheduler.c
+*
+*******************************************************************************/
+
+#ifndef __SCHED_JOURNAL_H__
+#define __SCHED_JOURNAL_H__
+
+#include "scheduler_internal.h"	/* journal_ty, task_ty, scheduler_ty */
+
+enum journal_kind
+{
+	JRNL_ADD = 1,
+	JRNL_REMOVE = 2,
+	JRNL_RESCHEDULE = 3,
+	JRNL_CLEAR = 4
+};
+
+/* appends one event; it is durable once its group is committed. A lost
+   event fails the next SchedJournalSync. No-op when sched has no journal */
+void JournalIMP(scheduler_ty *sched, enum journal_kind kind,
+				sched_id_ty id, const task_ty *task);
+
+/* one fsync for the whole group of pending events */
+int CommitIMP(journal_ty *journal);
+
+/* a task of func can be journaled: it has an entry in the types */
+int JournalHasTypeIMP(const journal_ty *journal, TaskFunc func);
+
+#endif /* __SCHED_JOURNAL_H__ */
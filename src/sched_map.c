@@ -0,0 +1,385 @@
+/*******************************************************************************
+***************************** - SCHEDULER MAP - ********************************
+*
+*	DESCRIPTION		Impl of the tasks kept in a mapped file
+*	AUTHOR 			Liad Raz
+*
+*******************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L	/* ftruncate, msync */
+
+#include <stdlib.h>			/* malloc, free */
+#include <string.h>			/* memcmp, memcpy */
+#include <time.h>			/* time_t, time */
+#include <unistd.h>			/* ftruncate, close */
+#include <fcntl.h>			/* open */
+#include <sys/stat.h>		/* fstat */
+#include <sys/mman.h>		/* mmap, msync, munmap */
+#include <assert.h>			/* assert */
+
+#include "utilities.h"		/* DEBUG_MODE, OFFSETOF_SIZE_T, INVALID_PTR */
+#include "scheduler.h"
+#include "scheduler_internal.h"
+#include "sched_map.h"
+
+/* mapped file, in the byte order of the build: header, then one record per
+   slot at records_offset. The checksums are FNV-1a, 32 bit */
+#define MAP_MAGIC 			"SCHEDMAP"
+#define MAP_VERSION 		1
+#define MAP_RECORDS_OFFSET 	64		/* a cache line, past the header */
+
+/* Only the fields before checksum persist. The task is rebuilt from them on
+   open: its pointers and engine links are valid in one process only. */
+typedef struct map_record
+{
+    unsigned long	generation;	/* of the slot; the task id while is_live */
+    unsigned long	is_live;
+    unsigned long	type_key;	/* sched_task_type_ty.key of task_func_p */
+    time_t			interval;
+    time_t			deadline;	/* wall clock time of the next run */
+    unsigned long	checksum;	/* of the fields above */
+    task_ty			task;
+} map_record_ty;
+
+typedef struct map_header
+{
+    char			magic[8];
+    unsigned long	version;
+    unsigned long	record_size;
+    unsigned long	capacity;		/* records, and slots */
+    unsigned long	records_offset;	/* from the start of the file */
+    unsigned long	checksum;		/* of the fields above */
+} map_header_ty;
+
+struct task_map
+{
+    int				fd;
+    void			*base;
+    size_t			length;
+    map_record_ty	*records;		/* record i belongs to slot i */
+    const sched_task_type_ty *types;
+    size_t			num_types;
+};
+
+static int MapAttachIMP(task_map_ty *map, size_t capacity);
+static void MapInitIMP(task_map_ty *map, size_t capacity);
+static size_t MapCapacityIMP(const task_map_ty *map);
+static int MapLoadIMP(const task_map_ty *map, task_slot_ty *slots,
+					task_ty **loaded, size_t *num_tasks);
+
+/*******************************************************************************
+****************************** SchedMapOpen ***********************************/
+int SchedMapOpen(scheduler_ty *scheduler, const char *path, size_t capacity,
+				const sched_task_type_ty *types, size_t num_types)
+{
+	task_map_ty *map = NULL;
+	task_slot_ty *slots = NULL;
+	task_ty **loaded = NULL;
+	size_t num_tasks = 0;
+
+	SC_ASSERT_NOT_NULL(scheduler);
+	assert (NULL != path && "SchedMapOpen: path is NULL");
+
+	if (scheduler->should_run || 0 != SchedSize(scheduler) ||
+		NULL != scheduler->map || NULL != scheduler->shm)
+	{
+		return 1;
+	}
+
+	/* only cancelled tasks may be left; their slots go with the table */
+	ClearTasksIMP(scheduler);
+
+	map = (task_map_ty *)malloc(sizeof(task_map_ty));
+	if (NULL == map)
+	{
+		return 1;
+	}
+
+	map->types = types;
+	map->num_types = num_types;
+	map->fd = open(path, O_RDWR | O_CREAT, 0644);
+	if (-1 == map->fd)
+	{
+		free(map);
+		return 1;
+	}
+
+	if (MapAttachIMP(map, capacity))
+	{
+		close(map->fd);
+		free(map);
+		return 1;
+	}
+
+	/* the file may be of another capacity than asked for */
+	capacity = MapCapacityIMP(map);
+	slots = (task_slot_ty *)malloc(capacity * sizeof(task_slot_ty));
+	loaded = (task_ty **)malloc(capacity * sizeof(task_ty *));
+	if (NULL == slots || NULL == loaded ||
+		MapLoadIMP(map, slots, loaded, &num_tasks))
+	{
+		free(slots);
+		free(loaded);
+		MapCloseIMP(map);
+		return 1;
+	}
+
+	InstallSlotsIMP(scheduler, slots, capacity);
+	scheduler->map = map;
+
+	/* a heap could not grow: the records are left as they are */
+	if (QueueLoadedIMP(scheduler, loaded, num_tasks) < num_tasks)
+	{
+		DetachTasksIMP(scheduler);
+		MapCloseIMP(map);
+		scheduler->map = NULL;
+		InstallSlotsIMP(scheduler, NULL, 0);
+		free(loaded);
+		return 1;
+	}
+
+	free(loaded);
+
+	return 0;
+}
+
+/*******************************************************************************
+****************************** SchedMapSync ***********************************/
+int SchedMapSync(scheduler_ty *scheduler)
+{
+	SC_ASSERT_NOT_NULL(scheduler);
+
+	if (NULL == scheduler->map)
+	{
+		return 1;
+	}
+
+	return (0 != msync(scheduler->map->base, scheduler->map->length, MS_SYNC));
+}
+
+/*******************************************************************************
+***************************** Side Functions **********************************/
+/* the record of slot idx holds the task; func must be of a known type */
+task_ty *MapTaskIMP(const task_map_ty *map, size_t idx, TaskFunc func)
+{
+	if (NULL == TypeOfFuncIMP(map->types, map->num_types, func))
+	{
+		return NULL;
+	}
+
+	return &map->records[idx].task;
+}
+
+/* maps the file of map->fd; an empty file is sized to capacity records and
+   initialized, any other is validated by its header */
+static int MapAttachIMP(task_map_ty *map, size_t capacity)
+{
+	const map_header_ty *header = NULL;
+	struct stat file_stat;
+	int is_new = 0;
+
+	if (-1 == fstat(map->fd, &file_stat))
+	{
+		return 1;
+	}
+
+	is_new = (0 == file_stat.st_size);
+	if (is_new)
+	{
+		if (0 == capacity || capacity - 1 > SLOT_MASK)
+		{
+			return 1;
+		}
+
+		map->length = MAP_RECORDS_OFFSET + capacity * sizeof(map_record_ty);
+		if (-1 == ftruncate(map->fd, (off_t)map->length))
+		{
+			return 1;
+		}
+	}
+	else if ((size_t)file_stat.st_size < sizeof(map_header_ty))
+	{
+		return 1;
+	}
+	else
+	{
+		map->length = (size_t)file_stat.st_size;
+	}
+
+	map->base = mmap(NULL, map->length, PROT_READ | PROT_WRITE, MAP_SHARED,
+					map->fd, 0);
+	if (MAP_FAILED == map->base)
+	{
+		/* the next open must find the file empty, not half made */
+		if (is_new)
+		{
+			ftruncate(map->fd, 0);
+		}
+		return 1;
+	}
+
+	if (is_new)
+	{
+		MapInitIMP(map, capacity);
+		return 0;
+	}
+
+	/* the layout must be the one of this build, records inside the file */
+	header = (const map_header_ty *)map->base;
+	if (0 != memcmp(header->magic, MAP_MAGIC, 8) ||
+		MAP_VERSION != header->version ||
+		sizeof(map_record_ty) != header->record_size ||
+		header->checksum != ChecksumIMP(header, OFFSETOF_SIZE_T(map_header_ty, checksum)) ||
+		0 == header->capacity || header->capacity - 1 > SLOT_MASK ||
+		sizeof(map_header_ty) > header->records_offset ||
+		0 != header->records_offset % MAP_RECORDS_OFFSET ||
+		map->length != header->records_offset +
+						header->capacity * sizeof(map_record_ty))
+	{
+		munmap(map->base, map->length);
+		return 1;
+	}
+
+	map->records = (map_record_ty *)((char *)map->base + header->records_offset);
+
+	return 0;
+}
+
+/* every record starts free at generation 1, like a new slot */
+static void MapInitIMP(task_map_ty *map, size_t capacity)
+{
+	map_header_ty *header = (map_header_ty *)map->base;
+	map_record_ty *record = NULL;
+	size_t idx = 0;
+
+	memcpy(header->magic, MAP_MAGIC, 8);
+	header->version = MAP_VERSION;
+	header->record_size = sizeof(map_record_ty);
+	header->capacity = capacity;
+	header->records_offset = MAP_RECORDS_OFFSET;
+	header->checksum = ChecksumIMP(header, OFFSETOF_SIZE_T(map_header_ty, checksum));
+
+	map->records = (map_record_ty *)((char *)map->base + MAP_RECORDS_OFFSET);
+	for (idx = 0; idx < capacity; ++idx)
+	{
+		record = &map->records[idx];
+		record->generation = 1;
+		record->is_live = 0;
+		record->checksum = ChecksumIMP(record, OFFSETOF_SIZE_T(map_record_ty, checksum));
+	}
+}
+
+static size_t MapCapacityIMP(const task_map_ty *map)
+{
+	return ((const map_header_ty *)map->base)->capacity;
+}
+
+/* fills slots from the records, the live tasks rebuilt in place and listed
+   in loaded. A record which does not check out, torn by a process killed
+   while writing it, is lost: it is written back free, a generation on */
+static int MapLoadIMP(const task_map_ty *map, task_slot_ty *slots,
+					task_ty **loaded, size_t *num_tasks)
+{
+	const sched_task_type_ty *type = NULL;
+	map_record_ty *record = NULL;
+	task_ty *task = NULL;
+	size_t capacity = MapCapacityIMP(map);
+	time_t now = time(NULL);
+	size_t idx = 0;
+
+	*num_tasks = 0;
+	for (idx = 0; idx < capacity; ++idx)
+	{
+		record = &map->records[idx];
+		if (record->checksum != ChecksumIMP(record, OFFSETOF_SIZE_T(map_record_ty, checksum)) ||
+			0 == record->generation || SLOT_MASK < record->generation ||
+			1 < record->is_live)
+		{
+			/* the generation is written first, so it is the newest one */
+			record->generation = NextGenerationIMP(record->generation);
+			record->is_live = 0;
+			record->checksum = ChecksumIMP(record, OFFSETOF_SIZE_T(map_record_ty, checksum));
+		}
+
+		slots[idx].task = NULL;
+		slots[idx].generation = record->generation;
+		slots[idx].next_free = SLOT_NIL;
+		if (!record->is_live)
+		{
+			continue;
+		}
+
+		type = TypeOfKeyIMP(map->types, map->num_types, record->type_key);
+		if (NULL == type)
+		{
+			return 1;
+		}
+
+		/* runs missed while the file was closed are due now */
+		task = &record->task;
+		task->task_func_p = type->task_func;
+		task->params = type->params;
+		task->interval = record->interval;
+		task->next_run = (record->deadline > now) ? record->deadline - now : 0;
+		task->id = (record->generation << SLOT_BITS) | (sched_id_ty)idx;
+		task->is_cancelled = 0;
+		task->is_in_fifo = 0;
+		task->is_rescheduled = 0;
+
+		slots[idx].task = task;
+		loaded[(*num_tasks)++] = task;
+	}
+
+	return 0;
+}
+
+void MapCloseIMP(task_map_ty *map)
+{
+	msync(map->base, map->length, MS_SYNC);
+	munmap(map->base, map->length);
+	close(map->fd);
+
+	DEBUG_MODE
+	(
+		map->base = INVALID_PTR;
+		map->records = INVALID_PTR;
+	) /* DEBUG ONLY */
+	free(map);
+}
+
+/* writes the record of slot idx from the slot and its task, checksum last.
+   A cancelled task is written as freed already: its id is stale */
+void PersistIMP(const scheduler_ty *sched, size_t idx)
+{
+	const task_slot_ty *slot = NULL;
+	const task_ty *task = NULL;
+	map_record_ty *record = NULL;
+	time_t start = 0;
+
+	if (NULL == sched->map)
+	{
+		return;
+	}
+
+	slot = &sched->slots[idx];
+	task = slot->task;
+	record = &sched->map->records[idx];
+
+	record->generation = slot->generation;
+	record->is_live = (NULL != task && !task->is_cancelled);
+	if (record->is_live)
+	{
+		/* SchedAdd checked the type; next_run counts from start */
+		start = sched->should_run ? sched->initial_time : time(NULL);
+		record->type_key = TypeOfFuncIMP(sched->map->types, sched->map->num_types,
+										task->task_func_p)->key;
+		record->interval = task->interval;
+		record->deadline = start + task->next_run;
+	}
+	else if (NULL != task)
+	{
+		record->generation = NextGenerationIMP(slot->generation);
+	}
+
+	record->checksum = ChecksumIMP(record, OFFSETOF_SIZE_T(map_record_ty, checksum));
+}
@@ -0,0 +1,29 @@
+/*******************************************************************************
+***************************** - SCHEDULER MAP - ********************************
+*
+*	DESCRIPTION		Internal - tasks kept in a file mapped to memory,
+*					SchedMapOpen
+*	AUTHOR 			Liad Raz
+*	FILES			sched_map.c sched_map.h scheduler.c
+*
+*******************************************************************************/
+
+#ifndef __SCHED_MAP_H__
+#define __SCHED_MAP_H__
+
+#include <stddef.h> 		/* size_t */
+
+#include "scheduler_internal.h"	/* task_map_ty, task_ty, scheduler_ty */
+
+/* the task in the record of slot idx, for a new task of func; NULL when func
+   has no entry in the types of the map */
+task_ty *MapTaskIMP(const task_map_ty *map, size_t idx, TaskFunc func);
+
+/* writes the record of slot idx from the slot and its task, checksum last;
+   no-op when sched is not mapped */
+void PersistIMP(const scheduler_ty *sched, size_t idx);
+
+/* syncs and unmaps the file, and frees map */
+void MapCloseIMP(task_map_ty *map);
+
+#endif /* __SCHED_MAP_H__ */
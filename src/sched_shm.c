@@ -0,0 +1,574 @@
+/*******************************************************************************
+**************************** - SCHEDULER SHM - *********************************
+*
+*	DESCRIPTION		Impl of the segment shared with client processes
+*	AUTHOR 			Liad Raz
+*
+*******************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L	/* ftruncate, pthread_mutexattr_setrobust */
+
+#include <stdlib.h>			/* malloc, free */
+#include <string.h>			/* memcmp, memcpy, strcpy, strlen */
+#include <time.h>			/* time_t, struct timespec */
+#include <unistd.h>			/* ftruncate, close */
+#include <fcntl.h>			/* O_RDWR, O_CREAT, O_EXCL */
+#include <sys/stat.h>		/* fstat */
+#include <sys/mman.h>		/* mmap, munmap, shm_open, shm_unlink */
+#include <pthread.h>		/* pthread_mutex_lock, pthread_cond_timedwait */
+#include <errno.h>			/* EOWNERDEAD */
+#include <assert.h>			/* assert */
+
+#include "utilities.h"		/* DEBUG_MODE, INVALID_PTR */
+#include "pqueue.h"			/* PQueueSetFloor */
+#include "scheduler.h"
+#include "scheduler_internal.h"
+#include "sched_journal.h"	/* JournalIMP */
+#include "sched_shm.h"
+
+/* shared segment: header, one slot per task id, then the ring of requests
+   from other processes. Every field is under the header lock */
+#define SHM_MAGIC 			"SCHEDSHM"
+#define SHM_VERSION 		1
+#define SHM_ALIGN 			64
+#define SHM_SLOTS_OFFSET 	((sizeof(shm_header_ty) + SHM_ALIGN - 1) / \
+							SHM_ALIGN * SHM_ALIGN)
+
+enum shm_state
+{
+	SHM_FREE = 0,
+	SHM_QUEUED = 1,			/* added by a client, not drained yet */
+	SHM_LIVE = 2,
+	SHM_CANCELLING = 3		/* removed by a client, not drained yet */
+};
+
+enum shm_op
+{
+	SHM_ADD = 1,
+	SHM_REMOVE = 2
+};
+
+typedef struct shm_slot
+{
+    unsigned long	generation;
+    unsigned long	state;			/* enum shm_state */
+    unsigned long	next_free;
+    unsigned long	type_key;		/* of a queued add */
+    time_t			interval;		/* of a queued add */
+} shm_slot_ty;
+
+typedef struct shm_request
+{
+    unsigned long	op;				/* enum shm_op */
+    sched_id_ty		id;
+} shm_request_ty;
+
+typedef struct shm_header
+{
+    char			magic[8];
+    unsigned long	version;
+    unsigned long	capacity;		/* slots; the ring holds twice as many */
+    pthread_mutex_t	lock;			/* process shared and robust */
+    pthread_cond_t	wake;			/* signalled on every request */
+    unsigned long	free_slot;		/* head of the free slots list */
+    unsigned long	ring_head;		/* oldest request */
+    unsigned long	ring_count;
+} shm_header_ty;
+
+/* the dispatcher's or a client's view of a segment */
+struct sched_shm
+{
+    shm_header_ty	*header;
+    shm_slot_ty		*slots;
+    shm_request_ty	*ring;
+    size_t			length;
+    /* dispatcher only */
+    shm_request_ty	*drained;		/* requests taken from the ring */
+    char			*name;
+    const sched_task_type_ty *types;
+    size_t			num_types;
+};
+
+static sched_shm_ty *ShmMapIMP(int fd, size_t capacity);
+static size_t ShmLengthIMP(size_t capacity);
+static void ShmUnmapIMP(sched_shm_ty *shm);
+static void ShmLockIMP(sched_shm_ty *shm);
+static void ShmUnlockIMP(sched_shm_ty *shm);
+static int ShmPushIMP(sched_shm_ty *shm, enum shm_op op, sched_id_ty id);
+static size_t ShmTakeIMP(sched_shm_ty *shm, enum shm_state state);
+static void ShmFreeIMP(sched_shm_ty *shm, size_t idx, sched_id_ty generation);
+static void ShmAddIMP(scheduler_ty *sched, sched_id_ty id);
+
+/*******************************************************************************
+***************************** SchedShmCreate **********************************/
+int SchedShmCreate(scheduler_ty *scheduler, const char *name, size_t capacity,
+					const sched_task_type_ty *types, size_t num_types)
+{
+	pthread_mutexattr_t lock_attr;
+	pthread_condattr_t wake_attr;
+	task_slot_ty *slots = NULL;
+	sched_shm_ty *shm = NULL;
+	shm_header_ty *header = NULL;
+	size_t idx = 0;
+	int fd = -1;
+	int status = 0;
+
+	SC_ASSERT_NOT_NULL(scheduler);
+	assert (NULL != name && "SchedShmCreate: name is NULL");
+
+	if (scheduler->should_run || 0 != SchedSize(scheduler) ||
+		NULL != scheduler->map || NULL != scheduler->shm ||
+		0 == capacity || capacity - 1 > SLOT_MASK)
+	{
+		return 1;
+	}
+
+	/* only cancelled tasks may be left; their slots go with the table */
+	ClearTasksIMP(scheduler);
+
+	/* a segment of another dispatcher is never taken over */
+	fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+	if (-1 == fd)
+	{
+		return 1;
+	}
+
+	if (0 == ftruncate(fd, (off_t)ShmLengthIMP(capacity)))
+	{
+		shm = ShmMapIMP(fd, capacity);
+	}
+	close(fd);
+
+	if (NULL != shm)
+	{
+		shm->name = (char *)malloc(strlen(name) + 1);
+		shm->drained = (shm_request_ty *)malloc(2 * capacity * sizeof(shm_request_ty));
+		slots = (task_slot_ty *)malloc(capacity * sizeof(task_slot_ty));
+	}
+
+	if (NULL == shm || NULL == shm->name || NULL == shm->drained || NULL == slots)
+	{
+		if (NULL != shm)
+		{
+			free(shm->name);
+			free(shm->drained);
+			ShmUnmapIMP(shm);
+		}
+		free(slots);
+		shm_unlink(name);
+		return 1;
+	}
+
+	strcpy(shm->name, name);
+	shm->types = types;
+	shm->num_types = num_types;
+
+	/* the segment starts zeroed: every slot free at generation 1 */
+	header = shm->header;
+	header->version = SHM_VERSION;
+	header->capacity = capacity;
+	header->free_slot = 0;
+	header->ring_head = 0;
+	header->ring_count = 0;
+	for (idx = 0; idx < capacity; ++idx)
+	{
+		shm->slots[idx].generation = 1;
+		shm->slots[idx].state = SHM_FREE;
+		shm->slots[idx].next_free = (idx + 1 < capacity) ? idx + 1 : SLOT_NIL;
+		slots[idx].task = NULL;
+		slots[idx].generation = 1;
+	}
+
+	/* a client which died holding the lock does not block the others */
+	status = (0 != pthread_mutexattr_init(&lock_attr));
+	if (0 == status)
+	{
+		status = (0 != pthread_mutexattr_setpshared(&lock_attr, PTHREAD_PROCESS_SHARED) ||
+				0 != pthread_mutexattr_setrobust(&lock_attr, PTHREAD_MUTEX_ROBUST) ||
+				0 != pthread_mutex_init(&header->lock, &lock_attr));
+		pthread_mutexattr_destroy(&lock_attr);
+	}
+	if (0 == status && 0 == pthread_condattr_init(&wake_attr))
+	{
+		status = (0 != pthread_condattr_setpshared(&wake_attr, PTHREAD_PROCESS_SHARED) ||
+				0 != pthread_cond_init(&header->wake, &wake_attr));
+		pthread_condattr_destroy(&wake_attr);
+	}
+	if (0 != status)
+	{
+		free(shm->name);
+		free(shm->drained);
+		ShmUnmapIMP(shm);
+		free(slots);
+		shm_unlink(name);
+		return 1;
+	}
+
+	/* clients attach once the magic is there */
+	memcpy(header->magic, SHM_MAGIC, 8);
+
+	InstallSlotsIMP(scheduler, slots, capacity);
+	scheduler->shm = shm;
+
+	return 0;
+}
+
+/*******************************************************************************
+***************************** SchedShmAttach **********************************/
+sched_shm_ty *SchedShmAttach(const char *name)
+{
+	struct stat file_stat;
+	sched_shm_ty *shm = NULL;
+	size_t capacity = 0;
+	int fd = -1;
+
+	assert (NULL != name && "SchedShmAttach: name is NULL");
+
+	fd = shm_open(name, O_RDWR, 0);
+	if (-1 == fd)
+	{
+		return NULL;
+	}
+
+	/* the size tells the capacity; the header must agree */
+	if (0 == fstat(fd, &file_stat) && (size_t)file_stat.st_size > SHM_SLOTS_OFFSET)
+	{
+		capacity = ((size_t)file_stat.st_size - SHM_SLOTS_OFFSET) /
+					(sizeof(shm_slot_ty) + 2 * sizeof(shm_request_ty));
+		if (ShmLengthIMP(capacity) == (size_t)file_stat.st_size)
+		{
+			shm = ShmMapIMP(fd, capacity);
+		}
+	}
+	close(fd);
+
+	if (NULL != shm &&
+		(0 != memcmp(shm->header->magic, SHM_MAGIC, 8) ||
+		SHM_VERSION != shm->header->version || capacity != shm->header->capacity))
+	{
+		ShmUnmapIMP(shm);
+		return NULL;
+	}
+
+	return shm;
+}
+
+/*******************************************************************************
+***************************** SchedShmDetach **********************************/
+void SchedShmDetach(sched_shm_ty *shm)
+{
+	assert (NULL != shm && "SchedShmDetach: shm is NULL");
+
+	ShmUnmapIMP(shm);
+}
+
+/*******************************************************************************
+****************************** SchedShmAdd ************************************/
+sched_id_ty SchedShmAdd(sched_shm_ty *shm, unsigned long key, time_t interval)
+{
+	sched_id_ty id = SCHED_BAD_ID;
+	size_t idx = 0;
+
+	assert (NULL != shm && "SchedShmAdd: shm is NULL");
+	assert (0 != interval && "SchedShmAdd: interval can not be zero");
+
+	ShmLockIMP(shm);
+
+	/* the ring is checked first, a slot taken is not given back */
+	if (2 * shm->header->capacity != shm->header->ring_count)
+	{
+		idx = ShmTakeIMP(shm, SHM_QUEUED);
+	}
+	else
+	{
+		idx = SLOT_NIL;
+	}
+
+	if (SLOT_NIL != idx)
+	{
+		shm->slots[idx].type_key = key;
+		shm->slots[idx].interval = interval;
+		id = (shm->slots[idx].generation << SLOT_BITS) | (sched_id_ty)idx;
+		ShmPushIMP(shm, SHM_ADD, id);
+	}
+
+	ShmUnlockIMP(shm);
+
+	return id;
+}
+
+/*******************************************************************************
+***************************** SchedShmRemove **********************************/
+int SchedShmRemove(sched_shm_ty *shm, sched_id_ty id)
+{
+	shm_slot_ty *slot = NULL;
+	int status = 1;
+
+	assert (NULL != shm && "SchedShmRemove: shm is NULL");
+
+	ShmLockIMP(shm);
+
+	/* removing it twice fails, it is cancelling already */
+	if ((id & SLOT_MASK) < shm->header->capacity)
+	{
+		slot = &shm->slots[id & SLOT_MASK];
+		status = (slot->generation != (id >> SLOT_BITS) ||
+				(SHM_QUEUED != slot->state && SHM_LIVE != slot->state) ||
+				ShmPushIMP(shm, SHM_REMOVE, id));
+		if (0 == status)
+		{
+			slot->state = SHM_CANCELLING;
+		}
+	}
+
+	ShmUnlockIMP(shm);
+
+	return status;
+}
+
+/*******************************************************************************
+***************************** Side Functions **********************************/
+size_t ShmAcquireIMP(sched_shm_ty *shm, sched_id_ty *generation)
+{
+	size_t idx = 0;
+
+	ShmLockIMP(shm);
+	idx = ShmTakeIMP(shm, SHM_LIVE);
+	if (SLOT_NIL != idx)
+	{
+		*generation = shm->slots[idx].generation;
+	}
+	ShmUnlockIMP(shm);
+
+	return idx;
+}
+
+void ShmReleaseIMP(sched_shm_ty *shm, size_t idx, sched_id_ty generation)
+{
+	ShmLockIMP(shm);
+	ShmFreeIMP(shm, idx, generation);
+	ShmUnlockIMP(shm);
+}
+
+void ShmDestroyIMP(sched_shm_ty *shm)
+{
+	shm_unlink(shm->name);
+	free(shm->name);
+	free(shm->drained);
+	ShmUnmapIMP(shm);
+}
+
+/* header, slots at SHM_SLOTS_OFFSET, then the ring */
+static sched_shm_ty *ShmMapIMP(int fd, size_t capacity)
+{
+	sched_shm_ty *shm = (sched_shm_ty *)malloc(sizeof(sched_shm_ty));
+	char *base = NULL;
+
+	if (NULL == shm)
+	{
+		return NULL;
+	}
+
+	shm->length = ShmLengthIMP(capacity);
+	base = (char *)mmap(NULL, shm->length, PROT_READ | PROT_WRITE, MAP_SHARED,
+						fd, 0);
+	if (MAP_FAILED == (void *)base)
+	{
+		free(shm);
+		return NULL;
+	}
+
+	shm->header = (shm_header_ty *)base;
+	shm->slots = (shm_slot_ty *)(base + SHM_SLOTS_OFFSET);
+	shm->ring = (shm_request_ty *)(shm->slots + capacity);
+	shm->drained = NULL;
+	shm->name = NULL;
+	shm->types = NULL;
+	shm->num_types = 0;
+
+	return shm;
+}
+
+static size_t ShmLengthIMP(size_t capacity)
+{
+	return SHM_SLOTS_OFFSET + capacity * sizeof(shm_slot_ty) +
+			2 * capacity * sizeof(shm_request_ty);
+}
+
+static void ShmUnmapIMP(sched_shm_ty *shm)
+{
+	munmap(shm->header, shm->length);
+
+	DEBUG_MODE
+	(
+		shm->header = INVALID_PTR;
+		shm->slots = INVALID_PTR;
+		shm->ring = INVALID_PTR;
+	) /* DEBUG ONLY */
+	free(shm);
+}
+
+/* the owner died inside a few field updates; what it left is used as is */
+static void ShmLockIMP(sched_shm_ty *shm)
+{
+	if (EOWNERDEAD == pthread_mutex_lock(&shm->header->lock))
+	{
+		pthread_mutex_consistent(&shm->header->lock);
+	}
+}
+
+static void ShmUnlockIMP(sched_shm_ty *shm)
+{
+	pthread_mutex_unlock(&shm->header->lock);
+}
+
+/* the lock is held; wakes the dispatcher */
+static int ShmPushIMP(sched_shm_ty *shm, enum shm_op op, sched_id_ty id)
+{
+	shm_header_ty *header = shm->header;
+	shm_request_ty *request = NULL;
+
+	if (2 * header->capacity == header->ring_count)
+	{
+		return 1;
+	}
+
+	request = &shm->ring[(header->ring_head + header->ring_count) %
+						(2 * header->capacity)];
+	request->op = op;
+	request->id = id;
+	++header->ring_count;
+	pthread_cond_signal(&header->wake);
+
+	return 0;
+}
+
+/* the lock is held; SLOT_NIL when every slot is taken */
+static size_t ShmTakeIMP(sched_shm_ty *shm, enum shm_state state)
+{
+	size_t idx = shm->header->free_slot;
+
+	if (SLOT_NIL != idx)
+	{
+		shm->header->free_slot = shm->slots[idx].next_free;
+		shm->slots[idx].state = state;
+	}
+
+	return idx;
+}
+
+/* the lock is held */
+static void ShmFreeIMP(sched_shm_ty *shm, size_t idx, sched_id_ty generation)
+{
+	shm->slots[idx].generation = generation;
+	shm->slots[idx].state = SHM_FREE;
+	shm->slots[idx].next_free = shm->header->free_slot;
+	shm->header->free_slot = idx;
+}
+
+/* the requests are copied out first: adding and removing take the lock
+   again to free slots */
+void ShmDrainIMP(scheduler_ty *sched)
+{
+	sched_shm_ty *shm = sched->shm;
+	shm_header_ty *header = shm->header;
+	size_t num_drained = 0;
+	size_t i = 0;
+
+	ShmLockIMP(shm);
+	while (0 != header->ring_count)
+	{
+		shm->drained[num_drained++] = shm->ring[header->ring_head];
+		header->ring_head = (header->ring_head + 1) % (2 * header->capacity);
+		--header->ring_count;
+	}
+	ShmUnlockIMP(shm);
+
+	for (i = 0; i < num_drained; ++i)
+	{
+		if (SHM_ADD == shm->drained[i].op)
+		{
+			ShmAddIMP(sched, shm->drained[i].id);
+		}
+		else if (NULL != LookupIMP(sched, shm->drained[i].id))
+		{
+			SchedRemove(sched, shm->drained[i].id);
+		}
+	}
+}
+
+/* the queued slot becomes a task; one cancelled meanwhile, or of a key
+   without a type, is freed and its id goes stale */
+static void ShmAddIMP(scheduler_ty *sched, sched_id_ty id)
+{
+	sched_shm_ty *shm = sched->shm;
+	size_t idx = (size_t)(id & SLOT_MASK);
+	const sched_task_type_ty *type = NULL;
+	task_ty *task = NULL;
+	time_t interval = 0;
+	int is_queued = 0;
+
+	ShmLockIMP(shm);
+	is_queued = (SHM_QUEUED == shm->slots[idx].state);
+	if (is_queued)
+	{
+		shm->slots[idx].state = SHM_LIVE;
+		interval = shm->slots[idx].interval;
+		type = TypeOfKeyIMP(shm->types, shm->num_types, shm->slots[idx].type_key);
+	}
+	ShmUnlockIMP(shm);
+
+	if (NULL != type && !IsFullIMP(sched))
+	{
+		task = (task_ty *)malloc(sizeof(task_ty));
+	}
+
+	if (NULL == task)
+	{
+		ShmLockIMP(shm);
+		ShmFreeIMP(shm, idx, NextGenerationIMP(shm->slots[idx].generation));
+		ShmUnlockIMP(shm);
+		return;
+	}
+
+	task->task_func_p = type->task_func;
+	task->params = type->params;
+	task->interval = interval;
+	task->next_run = ClockIMP(sched) + interval;
+	task->id = id;
+	task->is_cancelled = 0;
+	task->is_in_fifo = 0;
+	task->is_rescheduled = 0;
+
+	sched->slots[idx].task = task;
+	sched->slots[idx].generation = id >> SLOT_BITS;
+
+	/* peeking while waiting raised the radix floor to the head's time; a
+	   shorter interval is due before it, so lower the floor to now */
+	PQueueSetFloor(sched->tasks, ClockIMP(sched));
+
+	if (EnqueueIMP(sched, task))
+	{
+		FreeTaskIMP(sched, task);
+		return;
+	}
+
+	JournalIMP(sched, JRNL_ADD, id, task);
+}
+
+void ShmWaitIMP(sched_shm_ty *shm, time_t until)
+{
+	struct timespec deadline;
+
+	deadline.tv_sec = until;
+	deadline.tv_nsec = 0;
+
+	ShmLockIMP(shm);
+	if (0 == shm->header->ring_count &&
+		EOWNERDEAD == pthread_cond_timedwait(&shm->header->wake,
+											&shm->header->lock, &deadline))
+	{
+		pthread_mutex_consistent(&shm->header->lock);
+	}
+	ShmUnlockIMP(shm);
+}
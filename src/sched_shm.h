@@ -0,0 +1,36 @@
+/*******************************************************************************
+**************************** - SCHEDULER SHM - *********************************
+*
+*	DESCRIPTION		Internal - task ids and requests shared with other
+*					processes, SchedShmCreate
+*	AUTHOR 			Liad Raz
+*	FILES			sched_shm.c sched_shm.h scheduler.c
+*
+*******************************************************************************/
+
+#ifndef __SCHED_SHM_H__
+#define __SCHED_SHM_H__
+
+#include <stddef.h> 		/* size_t */
+#include <time.h>			/* time_t */
+
+#include "scheduler_internal.h"	/* scheduler_ty, sched_shm_ty */
+
+/* takes a free slot of the segment for a task of the dispatcher, and its
+   generation; SLOT_NIL when none is free */
+size_t ShmAcquireIMP(sched_shm_ty *shm, sched_id_ty *generation);
+
+/* hands slot idx back to the segment, at generation */
+void ShmReleaseIMP(sched_shm_ty *shm, size_t idx, sched_id_ty generation);
+
+/* carries out the requests clients queued in the ring */
+void ShmDrainIMP(scheduler_ty *sched);
+
+/* until the time, or until a client queues a request */
+void ShmWaitIMP(sched_shm_ty *shm, time_t until);
+
+/* unlinks the segment name and unmaps it; attached clients keep their
+   mapping */
+void ShmDestroyIMP(sched_shm_ty *shm);
+
+#endif /* __SCHED_SHM_H__ */
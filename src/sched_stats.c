@@ -0,0 +1,417 @@
+/*******************************************************************************
+*************************** - SCHEDULER STATS - ********************************
+*
+*	DESCRIPTION		Impl of the statistics segment read by monitors
+*	AUTHOR 			Liad Raz
+*
+*******************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L	/* ftruncate, clock_gettime */
+
+#include <stdlib.h>			/* malloc, free */
+#include <string.h>			/* memcmp, memcpy, strcpy, strlen */
+#include <time.h>			/* time_t, time, clock_gettime */
+#include <unistd.h>			/* ftruncate, close */
+#include <fcntl.h>			/* O_RDWR, O_RDONLY, O_CREAT, O_EXCL */
+#include <sys/stat.h>		/* fstat */
+#include <sys/mman.h>		/* mmap, munmap, shm_open, shm_unlink */
+#include <sched.h>			/* sched_yield */
+#include <assert.h>			/* assert */
+
+#include "utilities.h"		/* DEBUG_MODE, INVALID_PTR */
+#include "scheduler.h"
+#include "scheduler_internal.h"
+#include "sched_stats.h"
+
+/* statistics segment: header, then the runs entry of each slot. Lateness
+   bucket b > 0 counts runs late by [2^(b-1), 2^b) ms, bucket 0 by none */
+#define STATS_MAGIC 		"SCHEDSTA"
+#define STATS_VERSION 		2
+#define STATS_ALIGN 		64
+#define STATS_RUNS_OFFSET 	((sizeof(stats_header_ty) + STATS_ALIGN - 1) / \
+							STATS_ALIGN * STATS_ALIGN)
+#define STATS_LATE_BUCKETS 	32
+#define STATS_RETRIES 		100		/* torn reads before SchedStatsRead fails */
+
+/* orders the sequence counter with the statistics, for the compiler and
+   the CPU */
+#if defined(__GNUC__)
+#define STATS_BARRIER() 	__sync_synchronize()
+#else
+#define STATS_BARRIER()
+#endif
+
+/* the sequence is odd while the dispatcher writes */
+typedef struct stats_header
+{
+    char			magic[8];
+    unsigned long	version;
+    volatile unsigned long sequence;
+    sched_stats_ty	stats;
+    unsigned long	late_hist[STATS_LATE_BUCKETS];
+} stats_header_ty;
+
+/* the dispatcher's or a monitor's view of a statistics segment */
+struct sched_stats_view
+{
+    stats_header_ty	*header;
+    sched_task_runs_ty *runs;		/* entry i belongs to slot i */
+    size_t			capacity;
+    size_t			length;
+    /* dispatcher only */
+    char			*name;
+    time_t			second;			/* of the runs counted in num_in_second */
+    unsigned long	num_in_second;
+};
+
+static sched_stats_view_ty *StatsMapIMP(int fd, size_t capacity, int prot);
+static size_t StatsLengthIMP(size_t capacity);
+static void StatsUnmapIMP(sched_stats_view_ty *view);
+static void StatsBeginIMP(stats_header_ty *header);
+static void StatsEndIMP(stats_header_ty *header);
+static unsigned long StatsPercentileIMP(const stats_header_ty *header,
+										unsigned long permille);
+
+/*******************************************************************************
+**************************** SchedStatsCreate *********************************/
+int SchedStatsCreate(scheduler_ty *scheduler, const char *name, size_t capacity)
+{
+	sched_stats_view_ty *view = NULL;
+	int fd = -1;
+
+	SC_ASSERT_NOT_NULL(scheduler);
+	assert (NULL != name && "SchedStatsCreate: name is NULL");
+
+	if (scheduler->should_run || NULL != scheduler->stats)
+	{
+		return 1;
+	}
+
+	/* a segment of another scheduler is never taken over */
+	fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0644);
+	if (-1 == fd)
+	{
+		return 1;
+	}
+
+	if (0 == ftruncate(fd, (off_t)StatsLengthIMP(capacity)))
+	{
+		view = StatsMapIMP(fd, capacity, PROT_READ | PROT_WRITE);
+	}
+	close(fd);
+
+	if (NULL != view)
+	{
+		view->name = (char *)malloc(strlen(name) + 1);
+	}
+
+	if (NULL == view || NULL == view->name)
+	{
+		if (NULL != view)
+		{
+			StatsUnmapIMP(view);
+		}
+		shm_unlink(name);
+		return 1;
+	}
+
+	/* the segment starts zeroed: no runs, every entry free */
+	strcpy(view->name, name);
+	view->header->version = STATS_VERSION;
+	view->header->stats.capacity = capacity;
+
+	/* monitors attach once the magic is there */
+	STATS_BARRIER();
+	memcpy(view->header->magic, STATS_MAGIC, 8);
+
+	scheduler->stats = view;
+
+	return 0;
+}
+
+/*******************************************************************************
+**************************** SchedStatsAttach *********************************/
+sched_stats_view_ty *SchedStatsAttach(const char *name)
+{
+	struct stat file_stat;
+	sched_stats_view_ty *view = NULL;
+	size_t capacity = 0;
+	int fd = -1;
+
+	assert (NULL != name && "SchedStatsAttach: name is NULL");
+
+	fd = shm_open(name, O_RDONLY, 0);
+	if (-1 == fd)
+	{
+		return NULL;
+	}
+
+	/* the size tells the capacity; the header must agree */
+	if (0 == fstat(fd, &file_stat) && (size_t)file_stat.st_size >= STATS_RUNS_OFFSET)
+	{
+		capacity = ((size_t)file_stat.st_size - STATS_RUNS_OFFSET) /
+					sizeof(sched_task_runs_ty);
+		if (StatsLengthIMP(capacity) == (size_t)file_stat.st_size)
+		{
+			view = StatsMapIMP(fd, capacity, PROT_READ);
+		}
+	}
+	close(fd);
+
+	if (NULL != view &&
+		(0 != memcmp(view->header->magic, STATS_MAGIC, 8) ||
+		STATS_VERSION != view->header->version ||
+		capacity != view->header->stats.capacity))
+	{
+		StatsUnmapIMP(view);
+		return NULL;
+	}
+
+	return view;
+}
+
+/*******************************************************************************
+**************************** SchedStatsDetach *********************************/
+void SchedStatsDetach(sched_stats_view_ty *view)
+{
+	assert (NULL != view && "SchedStatsDetach: view is NULL");
+
+	StatsUnmapIMP(view);
+}
+
+/*******************************************************************************
+***************************** SchedStatsRead **********************************/
+int SchedStatsRead(const sched_stats_view_ty *view, sched_stats_ty *stats,
+					sched_task_runs_ty *tasks, size_t num_tasks)
+{
+	const stats_header_ty *header = NULL;
+	unsigned long sequence = 0;
+	size_t num_copied = 0;
+	size_t idx = 0;
+	size_t i = 0;
+
+	assert (NULL != view && "SchedStatsRead: view is NULL");
+	assert (NULL != stats && "SchedStatsRead: stats is NULL");
+	assert ((NULL != tasks || 0 == num_tasks) && "SchedStatsRead: tasks is NULL");
+
+	header = view->header;
+
+	for (i = 0; i < STATS_RETRIES; ++i)
+	{
+		sequence = header->sequence;
+		STATS_BARRIER();
+
+		/* the dispatcher is writing; a torn copy is thrown away below */
+		*stats = header->stats;
+		for (idx = 0, num_copied = 0;
+			idx < view->capacity && num_copied < num_tasks; ++idx)
+		{
+			if (SCHED_BAD_ID != view->runs[idx].id)
+			{
+				tasks[num_copied++] = view->runs[idx];
+			}
+		}
+
+		STATS_BARRIER();
+		if (0 == (sequence & 1) && sequence == header->sequence)
+		{
+			return 0;
+		}
+
+		/* let a preempted dispatcher finish */
+		sched_yield();
+	}
+
+	return 1;
+}
+
+/*******************************************************************************
+***************************** Side Functions **********************************/
+void StatsDestroyIMP(sched_stats_view_ty *view)
+{
+	shm_unlink(view->name);
+	free(view->name);
+	StatsUnmapIMP(view);
+}
+
+/* header, then the runs entries at STATS_RUNS_OFFSET */
+static sched_stats_view_ty *StatsMapIMP(int fd, size_t capacity, int prot)
+{
+	sched_stats_view_ty *view = (sched_stats_view_ty *)malloc(sizeof(sched_stats_view_ty));
+	char *base = NULL;
+
+	if (NULL == view)
+	{
+		return NULL;
+	}
+
+	view->length = StatsLengthIMP(capacity);
+	base = (char *)mmap(NULL, view->length, prot, MAP_SHARED, fd, 0);
+	if (MAP_FAILED == (void *)base)
+	{
+		free(view);
+		return NULL;
+	}
+
+	view->header = (stats_header_ty *)base;
+	view->runs = (sched_task_runs_ty *)(base + STATS_RUNS_OFFSET);
+	view->capacity = capacity;
+	view->name = NULL;
+	view->second = 0;
+	view->num_in_second = 0;
+
+	return view;
+}
+
+static size_t StatsLengthIMP(size_t capacity)
+{
+	return STATS_RUNS_OFFSET + capacity * sizeof(sched_task_runs_ty);
+}
+
+static void StatsUnmapIMP(sched_stats_view_ty *view)
+{
+	munmap(view->header, view->length);
+
+	DEBUG_MODE
+	(
+		view->header = INVALID_PTR;
+		view->runs = INVALID_PTR;
+	) /* DEBUG ONLY */
+	free(view);
+}
+
+/* one writer, the dispatcher: the sequence is odd until StatsEndIMP */
+static void StatsBeginIMP(stats_header_ty *header)
+{
+	++header->sequence;
+	STATS_BARRIER();
+}
+
+static void StatsEndIMP(stats_header_ty *header)
+{
+	STATS_BARRIER();
+	++header->sequence;
+}
+
+unsigned long StatsLatenessIMP(const scheduler_ty *sched, const task_ty *task)
+{
+	struct timespec now;
+	time_t due = sched->initial_time + task->next_run;
+
+	clock_gettime(CLOCK_REALTIME, &now);
+	if (now.tv_sec < due)
+	{
+		return 0;
+	}
+
+	return (unsigned long)(now.tv_sec - due) * 1000 +
+			(unsigned long)now.tv_nsec / 1000000;
+}
+
+void StatsDispatchIMP(scheduler_ty *sched, const task_ty *task,
+						unsigned long late_ms, int status)
+{
+	sched_stats_view_ty *view = sched->stats;
+	stats_header_ty *header = view->header;
+	sched_stats_ty *stats = &header->stats;
+	size_t idx = (size_t)(task->id & SLOT_MASK);
+	size_t bucket = 0;
+	time_t now = time(NULL);
+
+	while (bucket + 1 < STATS_LATE_BUCKETS && 0 != (late_ms >> bucket))
+	{
+		++bucket;
+	}
+
+	StatsBeginIMP(header);
+
+	/* the rate is of the last whole second, none when it was idle */
+	if (now != view->second)
+	{
+		stats->dispatch_rate = (now == view->second + 1) ? view->num_in_second : 0;
+		view->second = now;
+		view->num_in_second = 0;
+	}
+	++view->num_in_second;
+
+	++stats->num_dispatched;
+	stats->num_failed += (0 != status);
+	++header->late_hist[bucket];
+	if (late_ms > stats->late_max)
+	{
+		stats->late_max = late_ms;
+	}
+	stats->late_p50 = StatsPercentileIMP(header, 500);
+	stats->late_p90 = StatsPercentileIMP(header, 900);
+	stats->late_p99 = StatsPercentileIMP(header, 990);
+	stats->queue_depth = SchedSize(sched);
+	stats->num_deferred = sched->num_deferred;
+	stats->num_rejected = sched->num_rejected;
+	stats->updated = now;
+
+	/* a task new to the slot starts from 0 runs */
+	if (idx < view->capacity)
+	{
+		if (task->id != view->runs[idx].id)
+		{
+			stats->num_tasks += (SCHED_BAD_ID == view->runs[idx].id);
+			view->runs[idx].id = task->id;
+			view->runs[idx].runs = 0;
+		}
+		++view->runs[idx].runs;
+	}
+
+	StatsEndIMP(header);
+}
+
+void StatsStateIMP(scheduler_ty *sched)
+{
+	stats_header_ty *header = sched->stats->header;
+
+	StatsBeginIMP(header);
+	header->stats.is_running = sched->should_run;
+	header->stats.started = sched->initial_time;
+	header->stats.queue_depth = SchedSize(sched);
+	header->stats.num_deferred = sched->num_deferred;
+	header->stats.num_rejected = sched->num_rejected;
+	header->stats.updated = time(NULL);
+	StatsEndIMP(header);
+}
+
+void StatsForgetIMP(sched_stats_view_ty *view, sched_id_ty id)
+{
+	size_t idx = (size_t)(id & SLOT_MASK);
+
+	if (idx < view->capacity && id == view->runs[idx].id)
+	{
+		StatsBeginIMP(view->header);
+		view->runs[idx].id = SCHED_BAD_ID;
+		view->runs[idx].runs = 0;
+		--view->header->stats.num_tasks;
+		StatsEndIMP(view->header);
+	}
+}
+
+/* the upper bound of the bucket holding the permille-th lateness, no more
+   than the max */
+static unsigned long StatsPercentileIMP(const stats_header_ty *header,
+										unsigned long permille)
+{
+	unsigned long rank = (header->stats.num_dispatched * permille + 999) / 1000;
+	unsigned long num_seen = 0;
+	unsigned long bound = 0;
+	size_t bucket = 0;
+
+	for (bucket = 0; bucket + 1 < STATS_LATE_BUCKETS; ++bucket)
+	{
+		num_seen += header->late_hist[bucket];
+		if (num_seen >= rank)
+		{
+			break;
+		}
+	}
+
+	bound = (0 == bucket) ? 0 : (1UL << bucket) - 1;
+
+	return (bound < header->stats.late_max) ? bound : header->stats.late_max;
+}
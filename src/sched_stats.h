@@ -0,0 +1,33 @@
+/*******************************************************************************
+*************************** - SCHEDULER STATS - ********************************
+*
+*	DESCRIPTION		Internal - statistics published to monitor processes,
+*					SchedStatsCreate
+*	AUTHOR 			Liad Raz
+*	FILES			sched_stats.c sched_stats.h scheduler.c
+*
+*******************************************************************************/
+
+#ifndef __SCHED_STATS_H__
+#define __SCHED_STATS_H__
+
+#include "scheduler_internal.h"	/* scheduler_ty, task_ty */
+
+/* from the wall clock time the task was due; 0 when it is early */
+unsigned long StatsLatenessIMP(const scheduler_ty *sched, const task_ty *task);
+
+/* counts one run of task, which ended with status */
+void StatsDispatchIMP(scheduler_ty *sched, const task_ty *task,
+						unsigned long late_ms, int status);
+
+/* SchedRun started or stopped */
+void StatsStateIMP(scheduler_ty *sched);
+
+/* the runs entry of id is no longer a task's */
+void StatsForgetIMP(sched_stats_view_ty *view, sched_id_ty id);
+
+/* unlinks the segment name and unmaps it; the last update stays for
+   attached monitors */
+void StatsDestroyIMP(sched_stats_view_ty *view);
+
+#endif /* __SCHED_STATS_H__ */
@@ -6,47 +6,125 @@
 *
 *******************************************************************************/
 
-#include <stdlib.h>			/* malloc, free*/
+#define _POSIX_C_SOURCE 200809L	/* clock_gettime */
+
+#include <stdio.h>			/* FILE, fread, fwrite */
+#include <stdlib.h>			/* malloc, realloc, free, qsort */
+#include <string.h>			/* memcmp, memcpy */
 #include <time.h>			/* time_t, time*/
 #include <unistd.h>			/* sleep */
 #include <assert.h>			/* assert */
 
 #include "utilities.h"		/* DEBUG_MODE, OFFSETOF, INVALID_PTR */
-#include "pqueue.h"			/* PQueueCreate, PQueueDestroy, PQueuePeek
-								PQueueDequeue, PQueueEnqueue, PQueueErase,
-								PQueueSize, PQueueIsEmpty */
+#include "probes.h"			/* SDT_PROBE1, SDT_PROBE2 */
+#include "pqueue.h"			/* PQueueCreateIntrusive, PQueueCreateRadixHeap,
+								PQueueCreateDAryHeapIndexed,
+								PQueueCreatePairingHeap, PQueueEnqueue,
+								PQueueDestroy, PQueuePeek, PQueueDequeue,
+								PQueueEnqueueBack, PQueueUnlink, PQueueSize,
+								PQueueUpdateKey,
+								PQueueIsEmpty, PQueueSetFloor */
+#include "calendar_queue.h"	/* CQueueCreate, CQueueDestroy, CQueuePush,
+								CQueuePeek, CQueuePop, CQueueEraseKey,
+								CQueueSize, CQueueIsEmpty, CQueueGetStats */
 #include "scheduler.h"
-#include <stdio.h>
-#define SC_ASSERT_NOT_NULL(ptr)	assert (NULL != ptr \
-								&& "SCHEDULER is not allocated");
-
-typedef struct task task_ty;
-struct task
-{
-    TaskFunc	task_func_p;
-    void	 	*params;
-    time_t	 	interval;
-    time_t 		next_run;
-    uid_ty 		id;
-};
+#include "scheduler_internal.h"
+#include "sched_map.h"		/* MapTaskIMP, PersistIMP, MapCloseIMP */
+#include "sched_journal.h"	/* JournalIMP, CommitIMP, JournalHasTypeIMP */
+#include "sched_shm.h"		/* ShmAcquireIMP, ShmReleaseIMP, ShmDrainIMP,
+								ShmWaitIMP, ShmDestroyIMP */
+#include "sched_stats.h"	/* StatsLatenessIMP, StatsDispatchIMP,
+								StatsStateIMP, StatsForgetIMP,
+								StatsDestroyIMP */
+
+/* distinct intervals served by FIFO buckets, others go to the pqueue */
+#define FIFO_BUCKETS 16
+
+/* adaptive engine: sorted list up to ADAPT_GROW tasks, then a heap until
+   the size falls below ADAPT_SHRINK; the gap keeps a scheduler which
+   hovers around one threshold from migrating back and forth */
+#define ADAPT_GROW 		32
+#define ADAPT_SHRINK 	16
+
+/* lazy remove: rebuild the queue once cancelled tasks are at least
+   COMPACT_MIN and more than 1 / COMPACT_RATIO of it */
+#define COMPACT_MIN 	16
+#define COMPACT_RATIO 	4
+
+/* slots of a new scheduler */
+#define SLOTS_INIT 		16
+
+/* snapshot, little endian: header, one 32 bit generation per slot, then
+   fixed size task records (id, type key, interval, time left; 64 bit) */
+#define SNAP_MAGIC 			"SCHEDSNP"
+#define SNAP_VERSION 		1
+#define SNAP_HEADER_SIZE 	32
+#define SNAP_RECORD_SIZE 	32
+#define SNAP_CHUNK 			256		/* records per read or write */
+
+/* ChecksumIMP, FNV-1a 32 bit */
+#define FNV_OFFSET 			2166136261UL
+#define FNV_PRIME 			16777619UL
+
+/* Tasks of one interval are rescheduled to now + interval, in the order they
+	run, so each interval is a FIFO already sorted by next_run. */
+typedef struct fifo_bucket
+{
+    dlist_ty	*fifo;		/* tasks linked through task_ty.link */
+    time_t		interval;
+    size_t		heap_idx;	/* position in heads heap, when not empty */
+} fifo_bucket_ty;
 
-struct scheduler
+struct fifo_engine
 {
-    pqueue_ty 	*tasks;
-    time_t 		initial_time;
-    task_ty 	*current_task;
-    int 		should_run;
+    fifo_bucket_ty	buckets[FIFO_BUCKETS];
+    fifo_bucket_ty	*heads[FIFO_BUCKETS];	/* non-empty buckets, min-heap */
+    size_t			num_buckets;
+    size_t			num_heads;
+    size_t			size;
 };
 
-static int CmpTaskNextRunIMP(const void *t1_, const void *t2_, const void *ignore);
 static task_ty *CreateNewTaskIMP(scheduler_ty *sched, TaskFunc exe_task_p, void *params, time_t interval);
 static int ExecuteTaskIMP(task_ty *current_task);
 static int ReScheduleTaskIMP(scheduler_ty *scheduler, task_ty *task);
-static void ClearTasksIMP(scheduler_ty *scheduler);
-static int IsIdMatchIMP(const void *task_, const void *searched_id_);
+static int IsSameTaskIMP(const void *task_, const void *searched_task_);
 static void BreakSchedulerIMP(scheduler_ty *th_);
 static void BreakTaskIMP(task_ty *th_);
 
+static int AcquireSlotIMP(scheduler_ty *sched, task_ty *task);
+static void ReleaseSlotIMP(scheduler_ty *sched, sched_id_ty id);
+
+static task_ty *PeekIMP(const scheduler_ty *sched);
+static void DequeueIMP(scheduler_ty *sched);
+static int IsQueueEmptyIMP(const scheduler_ty *sched);
+static int HasWorkIMP(scheduler_ty *sched);
+static size_t QueueSizeIMP(const scheduler_ty *sched);
+static void CompactIMP(scheduler_ty *sched);
+static pqueue_ty *CreateTasksQueueIMP(enum sched_engine_ty engine);
+static enum sched_engine_ty QueueKindIMP(enum sched_engine_ty engine);
+static void AdaptIMP(scheduler_ty *sched);
+static int MigrateTasksIMP(scheduler_ty *sched, pqueue_ty *to);
+
+static int LoadSlotsIMP(FILE *stream, task_slot_ty *slots, size_t num_slots);
+static int LoadTasksIMP(FILE *stream, task_slot_ty *slots, size_t num_slots,
+						task_ty **loaded, size_t num_tasks,
+						const sched_task_type_ty *types, size_t num_types);
+static int CmpNextRunIMP(const void *task1, const void *task2);
+
+static void AccountIMP(scheduler_ty *sched, const task_ty *task,
+						const struct timespec *cpu_start, int status);
+static int IsBudgetSpentIMP(const struct timespec *start, unsigned long budget_ms);
+
+static fifo_engine_ty *FifoCreateIMP(void);
+static void FifoDestroyIMP(fifo_engine_ty *fifo);
+static int FifoPushIMP(fifo_engine_ty *fifo, task_ty *task);
+static task_ty *FifoHeadIMP(const fifo_bucket_ty *bucket);
+static void FifoPopIMP(fifo_engine_ty *fifo, fifo_bucket_ty *bucket);
+static int FifoEraseIMP(fifo_engine_ty *fifo, task_ty *task);
+static void FifoSiftUpIMP(fifo_engine_ty *fifo, size_t idx);
+static void FifoSiftDownIMP(fifo_engine_ty *fifo, size_t idx);
+static void FifoHeadChangedIMP(fifo_engine_ty *fifo, fifo_bucket_ty *bucket);
+
 /*******************************************************************************
 **************************** SchedCreate **************************************/
 scheduler_ty *SchedCreate(void)
@@ -60,8 +138,8 @@ scheduler_ty *SchedCreate(void)
 		return NULL;
 	}
 
-	/* init scheduler fileds */
-	sched->tasks = PQueueCreate(CmpTaskNextRunIMP, NULL);
+	/* init scheduler fileds; tasks carry their own pqueue link */
+	sched->tasks = CreateTasksQueueIMP(SCHED_ENGINE_ADAPTIVE);
 
 	/* check allocation failure  */
 	if (NULL == sched->tasks)
@@ -74,6 +152,28 @@ scheduler_ty *SchedCreate(void)
 	sched->initial_time = 0;
 	sched->current_task = NULL;
 	sched->should_run = 0;
+	sched->engine = SCHED_ENGINE_ADAPTIVE;
+	sched->fifo = NULL;
+	sched->calendar = NULL;
+	sched->is_heap = 0;
+	sched->lazy_remove = 0;
+	sched->num_cancelled = 0;
+	/* the slot table grows on the first add */
+	sched->slots = NULL;
+	sched->num_slots = 0;
+	sched->free_slot = SLOT_NIL;
+	sched->map = NULL;
+	sched->journal = NULL;
+	sched->shm = NULL;
+	sched->stats = NULL;
+	SchedSetHooks(sched, NULL);
+	sched->is_accounting = 0;
+	sched->acct = NULL;
+	sched->num_acct = 0;
+	sched->budget_ms = 0;
+	sched->max_size = 0;
+	sched->num_deferred = 0;
+	sched->num_rejected = 0;
 
 	return sched;
 }
@@ -85,10 +185,46 @@ void SchedDestroy(scheduler_ty *scheduler)
 {
 	SC_ASSERT_NOT_NULL(scheduler);
 
+	/* pending events are committed, the stream is the user's */
+	if (NULL != scheduler->journal)
+	{
+		SchedJournalStop(scheduler);
+	}
+
+	/* mapped tasks stay in the file for the next open; they are not freed,
+	   so on_remove is not called for them */
+	if (NULL != scheduler->map)
+	{
+		DetachTasksIMP(scheduler);
+		MapCloseIMP(scheduler->map);
+	}
+
 	/* clear all tasks from pqueue */
 	ClearTasksIMP(scheduler);
+	/* requests still queued are dropped with the segment name; attached
+	   clients keep their mapping */
+	if (NULL != scheduler->shm)
+	{
+		ShmDestroyIMP(scheduler->shm);
+	}
+	/* the last update stays for attached monitors */
+	if (NULL != scheduler->stats)
+	{
+		StatsDestroyIMP(scheduler->stats);
+	}
 	/* free the pqueue metadata */
 	PQueueDestroy(scheduler->tasks);
+	/* free the engine metadata */
+	if (NULL != scheduler->fifo)
+	{
+		FifoDestroyIMP(scheduler->fifo);
+	}
+	if (NULL != scheduler->calendar)
+	{
+		CQueueDestroy(scheduler->calendar);
+	}
+	free(scheduler->slots);
+	free(scheduler->acct);
 
 	/* DEBUG ONLY */
 	BreakSchedulerIMP(scheduler);
@@ -103,7 +239,13 @@ void SchedDestroy(scheduler_ty *scheduler)
 enum run_status_ty SchedRun(scheduler_ty *th_)
 {
 	task_ty *current = NULL;
+	struct timespec cpu_start;
+	struct timespec wakeup_start;	/* of the first task run since a wait */
 	time_t exe_time = 0;
+	time_t cut_time = 0;		/* when the budget was last spent */
+	time_t resume_time = 0;		/* no task runs before it */
+	unsigned long late_ms = 0;
+	int is_awake = 0;
 	int ret_exe = -1;
 
 	SC_ASSERT_NOT_NULL(th_);
@@ -114,53 +256,161 @@ enum run_status_ty SchedRun(scheduler_ty *th_)
 	th_->should_run = 1;
 	/* Init starting scheduler time to Absolute time */
 	th_->initial_time = time(NULL);
+	/* the clock restarts at 0, monotone engines must accept it */
+	PQueueSetFloor(th_->tasks, 0);
+
+	if (NULL != th_->stats)
+	{
+		StatsStateIMP(th_);
+	}
 
 	/* start main loop until pause OR all tasks were removed */
-	while ((th_->should_run) && !(PQueueIsEmpty(th_->tasks)))
+	while ((th_->should_run) && HasWorkIMP(th_))
 	{
+		/* get rid of cancelled tasks before they pile up */
+		CompactIMP(th_);
+
 		/* get the highest priority task */
-		current = PQueuePeek(th_->tasks);
+		current = PeekIMP(th_);
+
+		/* a cancelled task is dropped without waiting for its time */
+		if (current->is_cancelled)
+		{
+			DequeueIMP(th_);
+			SDT_PROBE2(scheduler, dequeue, current->id, current->next_run);
+			--th_->num_cancelled;
+			FreeTaskIMP(th_, current);
+			continue;
+		}
 
 		/* calculate the future time the task will be executed */
 		exe_time = th_->initial_time + current->next_run;
 
+		/* the budget of this wakeup is spent: due tasks wait for the next
+		   second, and keep their time, so the earliest due runs first */
+		if (0 != th_->budget_ms && is_awake && exe_time <= time(NULL) &&
+			IsBudgetSpentIMP(&wakeup_start, th_->budget_ms))
+		{
+			cut_time = time(NULL);
+			resume_time = cut_time + 1;
+		}
+		if (exe_time < resume_time)
+		{
+			exe_time = resume_time;
+		}
+
+		/* idle until then: commit the journal group now */
+		if (NULL != th_->journal && time(NULL) < exe_time)
+		{
+			CommitIMP(th_->journal);
+		}
+
+		/* clients of a shared segment may add an earlier task meanwhile */
+		if (NULL != th_->shm && time(NULL) < exe_time)
+		{
+			SDT_PROBE2(scheduler, sleep, current->id, exe_time);
+			ShmWaitIMP(th_->shm, exe_time);
+			SDT_PROBE1(scheduler, wake, current->id);
+			is_awake = 0;
+			continue;
+		}
+
 		/* when exe_time is too early send run to sleep */
 		while (time(NULL) < exe_time)
 		{
+			SDT_PROBE2(scheduler, sleep, current->id, exe_time);
 			exe_time = sleep(exe_time - time(NULL));
+			SDT_PROBE1(scheduler, wake, current->id);
+			is_awake = 0;
+		}
+
+		/* the budget counts from the first task of a wakeup */
+		if (0 != th_->budget_ms && !is_awake)
+		{
+			clock_gettime(CLOCK_MONOTONIC, &wakeup_start);
+			is_awake = 1;
+		}
+		/* due when the budget was spent, it waited */
+		if (th_->initial_time + current->next_run <= cut_time)
+		{
+			++th_->num_deferred;
 		}
 
 		/* when its about time remove the task from the pqueue */
-		PQueueDequeue(th_->tasks);
+		DequeueIMP(th_);
+		SDT_PROBE2(scheduler, dequeue, current->id, current->next_run);
 		/* Update current task in scheduler member */
 		th_->current_task = current;
 
-		/* Execute task */
+		/* lateness is up to the start of the task */
+		if (NULL != th_->stats)
+		{
+			late_ms = StatsLatenessIMP(th_, current);
+		}
+
+		/* Execute task; the hooks wrap it, the probes mark the task alone */
+		if (NULL != th_->hooks.pre_dispatch)
+		{
+			th_->hooks.pre_dispatch(current->id, current->params,
+									th_->hooks.hook_params);
+		}
+		SDT_PROBE2(scheduler, dispatch_start, current->id, current->next_run);
+		if (th_->is_accounting)
+		{
+			clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_start);
+		}
 		ret_exe = ExecuteTaskIMP(current);
+		if (th_->is_accounting)
+		{
+			AccountIMP(th_, current, &cpu_start, ret_exe);
+		}
+		SDT_PROBE2(scheduler, dispatch_end, current->id, ret_exe);
+		if (NULL != th_->hooks.post_dispatch)
+		{
+			th_->hooks.post_dispatch(current->id, current->params, ret_exe,
+									th_->hooks.hook_params);
+		}
+
+		/* published before a removed task is freed */
+		if (NULL != th_->stats)
+		{
+			StatsDispatchIMP(th_, current, late_ms, ret_exe);
+		}
 		/* In success reshedule task */
 		if (0 == ret_exe && NULL != th_->current_task)
 		{
 			/* In case ReSchedule failued free task */
 			if (ReScheduleTaskIMP(th_, current))
 			{
-				free(current);
+				JournalIMP(th_, JRNL_REMOVE, current->id, NULL);
+				FreeTaskIMP(th_, current);
 			}
 		}
-		/* Otherwise, remove task */
+		/* Otherwise, remove task; SchedRemove journaled it already */
 		else
 		{
-			/* DEBUG ONLY */
-			BreakTaskIMP(current);
-			free(current);
+			if (NULL != th_->current_task)
+			{
+				JournalIMP(th_, JRNL_REMOVE, current->id, NULL);
+			}
+			FreeTaskIMP(th_, current);
 		}
+
+		/* requests drained between tasks must not see it as running */
+		th_->current_task = NULL;
 	}
 
 	/* when main loop finshed reset all scheduler members */
 	th_->current_task = NULL;
 	th_->should_run = 0;
 
+	if (NULL != th_->stats)
+	{
+		StatsStateIMP(th_);
+	}
+
 	/* when pqueue is empty return 0 */
-	return !PQueueIsEmpty(th_->tasks);
+	return (0 != SchedSize(th_));
 }
 
 
@@ -175,63 +425,101 @@ sched_id_ty SchedAdd(scheduler_ty *scheduler, TaskFunc exe_task_p, void *params,
 	assert (NULL != exe_task_p && "SchedAdd: Function pointer is invalid");
 	assert (0 != interval && "SchedAdd: interval can not be zero");
 
+	/* a journaled task needs a key to be replayed */
+	if (NULL != scheduler->journal &&
+		!JournalHasTypeIMP(scheduler->journal, exe_task_p))
+	{
+		return SCHED_BAD_ID;
+	}
+
+	/* admission control: a full scheduler turns new tasks away */
+	if (IsFullIMP(scheduler))
+	{
+		return SCHED_BAD_ID;
+	}
+
 	/* create new task and init its fields */
 	new_task = CreateNewTaskIMP(scheduler, exe_task_p, params, interval);
 
 	/* check whether creation succeed */
 	if (NULL == new_task)
 	{
-		return BAD_UID;
+		return SCHED_BAD_ID;
 	}
 
-	/* insert task to pqueue */
-	enqueue_status = PQueueEnqueue(scheduler->tasks, new_task);
+	/* while not running the clock reads 0, monotone engines must accept it */
+	if (!scheduler->should_run)
+	{
+		PQueueSetFloor(scheduler->tasks, 0);
+	}
+
+	/* adding mutates the queue anyway; drop cancelled tasks first */
+	CompactIMP(scheduler);
+
+	/* insert task to the scheduler engine */
+	enqueue_status = EnqueueIMP(scheduler, new_task);
 
-	/* In case failure return BAD_UID */
+	/* In case failure return SCHED_BAD_ID */
 	if (1 == enqueue_status)
 	{
-		/* DEBUG ONLY */
-		BreakTaskIMP(new_task);
-		return BAD_UID;
+		FreeTaskIMP(scheduler, new_task);
+		return SCHED_BAD_ID;
 	}
 
+	PersistIMP(scheduler, new_task->id & SLOT_MASK);
+	JournalIMP(scheduler, JRNL_ADD, new_task->id, new_task);
+
 	return new_task->id;
 }
 
 /*******************************************************************************
 ***************************** SchedRemove *************************************/
-int SchedRemove(scheduler_ty *th_, uid_ty to_remove_)
+int SchedRemove(scheduler_ty *th_, sched_id_ty to_remove_)
 {
 	task_ty *ret_task = NULL;
-	int is_same = -1;
 
 	SC_ASSERT_NOT_NULL(th_);
-	assert (!UIDIsSame(BAD_UID, to_remove_) && "SchedRemove: id is invalid");
+	assert (SCHED_BAD_ID != to_remove_ && "SchedRemove: id is invalid");
+
+	/* the id leads straight to its slot; stale ids find nothing */
+	ret_task = LookupIMP(th_, to_remove_);
+
+	/* if not found return failure */
+	if (NULL == ret_task)
+	{
+		return 1;
+	}
 
 	/* check if current task is the one we are looking for */
-	is_same = IsIdMatchIMP(th_->current_task, (void *)&to_remove_);
-	if (is_same)
+	if (ret_task == th_->current_task)
 	{
 		assert (0 != th_->should_run
 		&& "Cannot remove current task while scheduler is not running ");
 
+		/* removing it twice fails, it is out of the queue already */
+		ret_task->is_cancelled = 1;
 		th_->current_task = NULL;
+		PersistIMP(th_, to_remove_ & SLOT_MASK);
+		JournalIMP(th_, JRNL_REMOVE, to_remove_, NULL);
 		/* Actual free occurs in the run function */
 		return 0;
 	}
 
-	/* In case task is not the current, look for it in the pqueue */
-	ret_task = PQueueErase(th_->tasks, IsIdMatchIMP, (void *)&to_remove_);
-
-	/* if not found return failure */
-	if (NULL == ret_task)
+	/* lazy remove marks the task only; the queue is left as is */
+	if (th_->lazy_remove)
 	{
-		return 1;
+		ret_task->is_cancelled = 1;
+		++th_->num_cancelled;
+		PersistIMP(th_, to_remove_ & SLOT_MASK);
+		JournalIMP(th_, JRNL_REMOVE, to_remove_, NULL);
+
+		return 0;
 	}
 
-	/* DEBUG ONLY */
-	BreakTaskIMP(ret_task); /* TODO doesn't affect the outside function! */
-	free(ret_task);
+	/* In case task is not the current, detach it from the engine */
+	UnlinkIMP(th_, ret_task);
+	FreeTaskIMP(th_, ret_task);
+	JournalIMP(th_, JRNL_REMOVE, to_remove_, NULL);
 
 	return 0;
 }
@@ -252,7 +540,8 @@ size_t SchedSize(scheduler_ty *scheduler)
 {
 	SC_ASSERT_NOT_NULL(scheduler);
 
-	return PQueueSize(scheduler->tasks);
+	/* cancelled tasks still queued are gone as far as the user knows */
+	return QueueSizeIMP(scheduler) - scheduler->num_cancelled;
 }
 
 /*******************************************************************************
@@ -261,7 +550,7 @@ int SchedIsEmpty(scheduler_ty *scheduler)
 {
 	SC_ASSERT_NOT_NULL(scheduler);
 
-	return PQueueIsEmpty(scheduler->tasks);
+	return (0 == SchedSize(scheduler));
 }
 
 /*******************************************************************************
@@ -271,121 +560,1654 @@ void SchedClear(scheduler_ty *scheduler)
 	SC_ASSERT_NOT_NULL(scheduler);
 
 	ClearTasksIMP(scheduler);
+	JournalIMP(scheduler, JRNL_CLEAR, SCHED_BAD_ID, NULL);
 }
 
 
 /*******************************************************************************
-***************************** Side Functions **********************************/
-static int CmpTaskNextRunIMP(const void *t1_, const void *t2_, const void *ignore)
+***************************** SchedFind ***************************************/
+int SchedFind(const scheduler_ty *scheduler, sched_id_ty id)
+{
+	SC_ASSERT_NOT_NULL(scheduler);
+
+	return (NULL != LookupIMP(scheduler, id));
+}
+
+/*******************************************************************************
+*************************** SchedGetNextRun ***********************************/
+int SchedGetNextRun(const scheduler_ty *scheduler, sched_id_ty id, time_t *next_run)
+{
+	task_ty *task = NULL;
+
+	SC_ASSERT_NOT_NULL(scheduler);
+	assert (NULL != next_run && "SchedGetNextRun: next_run is not allocated");
+
+	task = LookupIMP(scheduler, id);
+	if (NULL == task)
+	{
+		return 1;
+	}
+
+	*next_run = task->next_run;
+
+	return 0;
+}
+
+/*******************************************************************************
+*************************** SchedSetParams ************************************/
+int SchedSetParams(scheduler_ty *scheduler, sched_id_ty id, void *params)
+{
+	task_ty *task = NULL;
+
+	SC_ASSERT_NOT_NULL(scheduler);
+
+	task = LookupIMP(scheduler, id);
+	if (NULL == task)
+	{
+		return 1;
+	}
+
+	/* the queue orders by next_run only, params change in place */
+	task->params = params;
+
+	return 0;
+}
+
+
+/*******************************************************************************
+*************************** SchedReschedule ***********************************/
+int SchedReschedule(scheduler_ty *scheduler, sched_id_ty id, time_t next_run)
 {
-	const task_ty *task_pqueue = t1_;
-	const task_ty *new_task = t2_;
+	task_ty *task = NULL;
+	time_t now = 0;
 
-	UNUSED(ignore);
+	SC_ASSERT_NOT_NULL(scheduler);
 
-	if (task_pqueue->next_run > new_task->next_run)
+	task = LookupIMP(scheduler, id);
+	if (NULL == task)
 	{
 		return 1;
 	}
-	else if (task_pqueue->next_run < new_task->next_run)
+
+	/* a time already passed means as soon as possible */
+	now = ClockIMP(scheduler);
+	if (next_run < now)
 	{
-		return -1;
+		next_run = now;
 	}
-	else
+
+	/* the running task is queued again when it returns */
+	if (task == scheduler->current_task)
 	{
+		task->next_run = next_run;
+		task->is_rescheduled = 1;
+		JournalIMP(scheduler, JRNL_RESCHEDULE, id, task);
 		return 0;
 	}
-}
 
+	return RepositionIMP(scheduler, task, next_run, task->interval);
+}
 
-static task_ty *CreateNewTaskIMP(scheduler_ty *sched, TaskFunc exe_task_p, void *params, time_t interval)
+/*******************************************************************************
+*************************** SchedSetInterval **********************************/
+int SchedSetInterval(scheduler_ty *scheduler, sched_id_ty id, time_t interval)
 {
-	time_t actual_time = 0;
+	task_ty *task = NULL;
+	time_t next_run = 0;
+	time_t now = 0;
 
-	/* allocate new task */
-	task_ty *ret_task = (task_ty *)malloc(sizeof(task_ty));
+	SC_ASSERT_NOT_NULL(scheduler);
+	assert (0 != interval && "SchedSetInterval: interval can not be zero");
 
-	/* check allocation failure  */
-	if (NULL == ret_task)
+	task = LookupIMP(scheduler, id);
+	if (NULL == task)
 	{
-		return NULL;
+		return 1;
 	}
 
-	/* calculate the scheduler time whether it is running or not */
-	actual_time = sched->should_run * (time(NULL) - sched->initial_time);
+	/* the running task picks up the interval when it returns */
+	if (task == scheduler->current_task)
+	{
+		task->interval = interval;
+		JournalIMP(scheduler, JRNL_RESCHEDULE, id, task);
+		return 0;
+	}
 
-	/* Initi task fields */
-	ret_task->task_func_p = exe_task_p;
-	ret_task->params = params;
-	ret_task->interval = interval;
-	ret_task->next_run = actual_time + interval;
-	ret_task->id = UIDGenerate();
+	/* the pending run keeps its distance from when it was scheduled */
+	now = ClockIMP(scheduler);
+	next_run = task->next_run - task->interval + interval;
+	if (next_run < now)
+	{
+		next_run = now;
+	}
 
-	return ret_task;
+	return RepositionIMP(scheduler, task, next_run, interval);
 }
 
 
-static int ExecuteTaskIMP(task_ty *task_)
+/*******************************************************************************
+**************************** SchedSetEngine ***********************************/
+int SchedSetEngine(scheduler_ty *scheduler, enum sched_engine_ty engine)
 {
-	return (task_->task_func_p(task_->params));
+	pqueue_ty *tasks = NULL;
+
+	SC_ASSERT_NOT_NULL(scheduler);
+
+	/* tasks are never migrated between engines */
+	if (scheduler->should_run || 0 != SchedSize(scheduler))
+	{
+		return 1;
+	}
+
+	/* only cancelled tasks may be left */
+	ClearTasksIMP(scheduler);
+
+	/* the radix and pairing engines replace the tasks pqueue itself; an
+		adaptive engine may have left a heap behind */
+	if (QueueKindIMP(engine) != QueueKindIMP(scheduler->engine) ||
+		scheduler->is_heap)
+	{
+		tasks = CreateTasksQueueIMP(engine);
+		if (NULL == tasks)
+		{
+			return 1;
+		}
+
+		PQueueDestroy(scheduler->tasks);
+		scheduler->tasks = tasks;
+		scheduler->is_heap = 0;
+	}
+
+	if (SCHED_ENGINE_FIFO == engine && NULL == scheduler->fifo)
+	{
+		scheduler->fifo = FifoCreateIMP();
+		if (NULL == scheduler->fifo)
+		{
+			return 1;
+		}
+	}
+	else if (SCHED_ENGINE_FIFO != engine && NULL != scheduler->fifo)
+	{
+		FifoDestroyIMP(scheduler->fifo);
+		scheduler->fifo = NULL;
+	}
+
+	if (SCHED_ENGINE_CALENDAR == engine && NULL == scheduler->calendar)
+	{
+		scheduler->calendar = CQueueCreate();
+		if (NULL == scheduler->calendar)
+		{
+			return 1;
+		}
+	}
+	else if (SCHED_ENGINE_CALENDAR != engine && NULL != scheduler->calendar)
+	{
+		CQueueDestroy(scheduler->calendar);
+		scheduler->calendar = NULL;
+	}
+
+	scheduler->engine = engine;
+
+	return 0;
 }
 
-static int ReScheduleTaskIMP(scheduler_ty *th_, task_ty *task_)
+/*******************************************************************************
+************************** SchedSetLazyRemove *********************************/
+void SchedSetLazyRemove(scheduler_ty *scheduler, int is_lazy)
 {
-	task_->next_run = (time(NULL) - th_->initial_time) + task_->interval;
+	SC_ASSERT_NOT_NULL(scheduler);
 
-	return (PQueueEnqueue(th_->tasks, task_));
+	scheduler->lazy_remove = (0 != is_lazy);
 }
 
-static void ClearTasksIMP(scheduler_ty *th_)
+/*******************************************************************************
+****************************** SchedSetHooks **********************************/
+void SchedSetHooks(scheduler_ty *scheduler, const sched_hooks_ty *hooks)
 {
-	task_ty *to_remove = NULL;
+	SC_ASSERT_NOT_NULL(scheduler);
 
-	/* traverse until pqueue is empty */
-	while (!PQueueIsEmpty(th_->tasks))
+	if (NULL != hooks)
 	{
-		/* get first task in pqueue */
-		to_remove = PQueuePeek(th_->tasks);
+		scheduler->hooks = *hooks;
+		return;
+	}
 
-		/* break task fields */
-		BreakTaskIMP(to_remove);
-		/* remove task */
-		free(to_remove);
+	scheduler->hooks.pre_dispatch = NULL;
+	scheduler->hooks.post_dispatch = NULL;
+	scheduler->hooks.on_remove = NULL;
+	scheduler->hooks.hook_params = NULL;
+}
 
-		/* remove element from pqueue in scheduler */
-		PQueueDequeue(th_->tasks);
-	}
+/*******************************************************************************
+**************************** SchedSetTaskStats ********************************/
+void SchedSetTaskStats(scheduler_ty *scheduler, int is_on)
+{
+	SC_ASSERT_NOT_NULL(scheduler);
+
+	scheduler->is_accounting = (0 != is_on);
 }
 
-static int IsIdMatchIMP(const void *task_, const void *searched_id_)
+/*******************************************************************************
+**************************** SchedGetTaskStats ********************************/
+int SchedGetTaskStats(const scheduler_ty *scheduler, sched_id_ty id,
+					sched_task_stats_ty *stats)
 {
-	/* In case Scheduler is not running current task will be NULL */
-	if (task_ == NULL)
+	size_t idx = 0;
+
+	SC_ASSERT_NOT_NULL(scheduler);
+	assert (SCHED_BAD_ID != id && "SchedGetTaskStats: id is invalid");
+	assert (NULL != stats && "SchedGetTaskStats: stats is NULL");
+
+	/* the entry holds the counts of the last task of the slot which ran */
+	idx = (size_t)(id & SLOT_MASK);
+	if (idx < scheduler->num_acct && id == scheduler->acct[idx].id)
 	{
+		*stats = scheduler->acct[idx].stats;
 		return 0;
 	}
 
-	return (UIDIsSame(((task_ty *)task_)->id, *((uid_ty *)searched_id_)));
+	if (NULL == LookupIMP(scheduler, id))
+	{
+		return 1;
+	}
+
+	stats->runs = 0;
+	stats->failures = 0;
+	stats->cpu_ns = 0;
+	stats->max_cpu_ns = 0;
+
+	return 0;
 }
 
-static void BreakSchedulerIMP(scheduler_ty *th_)
+/*******************************************************************************
+***************************** SchedSetBudget **********************************/
+void SchedSetBudget(scheduler_ty *scheduler, unsigned long budget_ms)
 {
-    DEBUG_MODE
-    (
-		th_->tasks = INVALID_PTR;
-		th_->initial_time = 0;
-		th_->current_task = 0;
-		th_->should_run = 0;
-    ); /* DEBUG ONLY */
+	SC_ASSERT_NOT_NULL(scheduler);
+
+	scheduler->budget_ms = budget_ms;
 }
 
-static void BreakTaskIMP(task_ty *th_)
+/*******************************************************************************
+***************************** SchedSetMaxSize *********************************/
+void SchedSetMaxSize(scheduler_ty *scheduler, size_t max_size)
 {
-	DEBUG_MODE
-	(
-		th_->params = INVALID_PTR;
-		th_->interval = 0;
-		th_->next_run = 0;
-		th_->id = BAD_UID;
-	) /* DEBUG ONLY */
+	SC_ASSERT_NOT_NULL(scheduler);
+
+	scheduler->max_size = max_size;
+}
+
+/*******************************************************************************
+**************************** SchedGetLoadStats ********************************/
+void SchedGetLoadStats(const scheduler_ty *scheduler, sched_load_stats_ty *stats)
+{
+	SC_ASSERT_NOT_NULL(scheduler);
+	assert (NULL != stats && "SchedGetLoadStats: stats is NULL");
+
+	stats->num_deferred = scheduler->num_deferred;
+	stats->num_rejected = scheduler->num_rejected;
+}
+
+/*******************************************************************************
+************************* SchedGetCalendarStats *******************************/
+int SchedGetCalendarStats(const scheduler_ty *scheduler, cqueue_stats_ty *stats)
+{
+	SC_ASSERT_NOT_NULL(scheduler);
+	assert (NULL != stats && "SchedGetCalendarStats: stats is not allocated");
+
+	if (SCHED_ENGINE_CALENDAR != scheduler->engine)
+	{
+		return 1;
+	}
+
+	CQueueGetStats(scheduler->calendar, stats);
+
+	return 0;
+}
+
+
+/*******************************************************************************
+******************************** SchedSave ************************************/
+int SchedSave(const scheduler_ty *scheduler, FILE *stream,
+				const sched_task_type_ty *types, size_t num_types)
+{
+	unsigned char buffer[SNAP_CHUNK * SNAP_RECORD_SIZE];
+	const sched_task_type_ty *type = NULL;
+	const task_ty *task = NULL;
+	unsigned char *record = NULL;
+	sched_id_ty generation = 0;
+	size_t num_tasks = 0;
+	size_t num_buffered = 0;
+	size_t idx = 0;
+
+	SC_ASSERT_NOT_NULL(scheduler);
+	assert (NULL != stream && "SchedSave: stream is NULL");
+
+	/* the running task is in its slot, not in the queue */
+	for (idx = 0; idx < scheduler->num_slots; ++idx)
+	{
+		task = scheduler->slots[idx].task;
+		num_tasks += (NULL != task && !task->is_cancelled);
+	}
+
+	memcpy(buffer, SNAP_MAGIC, 8);
+	PutIMP(buffer + 8, SNAP_VERSION, 4);
+	PutIMP(buffer + 12, SNAP_RECORD_SIZE, 4);
+	PutIMP(buffer + 16, scheduler->num_slots, 8);
+	PutIMP(buffer + 24, num_tasks, 8);
+	if (1 != fwrite(buffer, SNAP_HEADER_SIZE, 1, stream))
+	{
+		return 1;
+	}
+
+	/* a cancelled task is not saved: its slot is saved free, its id stale */
+	for (idx = 0; idx < scheduler->num_slots; ++idx)
+	{
+		task = scheduler->slots[idx].task;
+		generation = scheduler->slots[idx].generation;
+		if (NULL != task && task->is_cancelled)
+		{
+			generation = NextGenerationIMP(generation);
+		}
+
+		PutIMP(buffer + 4 * num_buffered, generation, 4);
+		if (SNAP_CHUNK == ++num_buffered || idx + 1 == scheduler->num_slots)
+		{
+			if (num_buffered != fwrite(buffer, 4, num_buffered, stream))
+			{
+				return 1;
+			}
+			num_buffered = 0;
+		}
+	}
+
+	for (idx = 0; idx < scheduler->num_slots; ++idx)
+	{
+		task = scheduler->slots[idx].task;
+		if (NULL != task && !task->is_cancelled)
+		{
+			type = TypeOfFuncIMP(types, num_types, task->task_func_p);
+			if (NULL == type)
+			{
+				return 1;
+			}
+
+			record = buffer + num_buffered * SNAP_RECORD_SIZE;
+			PutIMP(record, task->id, 8);
+			PutIMP(record + 8, type->key, 8);
+			PutIMP(record + 16, (unsigned long)task->interval, 8);
+			PutIMP(record + 24, (unsigned long)TimeLeftIMP(scheduler, task), 8);
+			++num_buffered;
+		}
+
+		if (0 != num_buffered &&
+			(SNAP_CHUNK == num_buffered || idx + 1 == scheduler->num_slots))
+		{
+			if (num_buffered != fwrite(buffer, SNAP_RECORD_SIZE, num_buffered, stream))
+			{
+				return 1;
+			}
+			num_buffered = 0;
+		}
+	}
+
+	return (0 != fflush(stream));
+}
+
+/*******************************************************************************
+******************************** SchedLoad ************************************/
+int SchedLoad(scheduler_ty *scheduler, FILE *stream,
+				const sched_task_type_ty *types, size_t num_types)
+{
+	unsigned char header[SNAP_HEADER_SIZE];
+	task_slot_ty *slots = NULL;
+	task_ty **loaded = NULL;
+	size_t num_slots = 0;
+	size_t num_tasks = 0;
+	size_t idx = 0;
+	int status = 0;
+
+	SC_ASSERT_NOT_NULL(scheduler);
+	assert (NULL != stream && "SchedLoad: stream is NULL");
+
+	/* a mapped scheduler keeps its tasks in the file's records; a journal
+	   would miss the loaded tasks */
+	if (scheduler->should_run || 0 != SchedSize(scheduler) ||
+		NULL != scheduler->map || NULL != scheduler->journal ||
+		NULL != scheduler->shm)
+	{
+		return 1;
+	}
+
+	/* only cancelled tasks may be left; their slots go with the table */
+	ClearTasksIMP(scheduler);
+
+	if (1 != fread(header, SNAP_HEADER_SIZE, 1, stream) ||
+		0 != memcmp(header, SNAP_MAGIC, 8) ||
+		SNAP_VERSION != GetIMP(header + 8, 4) ||
+		SNAP_RECORD_SIZE != GetIMP(header + 12, 4))
+	{
+		return 1;
+	}
+
+	num_slots = (size_t)GetIMP(header + 16, 8);
+	num_tasks = (size_t)GetIMP(header + 24, 8);
+	if ((0 != num_slots && num_slots - 1 > SLOT_MASK) || num_tasks > num_slots)
+	{
+		return 1;
+	}
+
+	slots = (task_slot_ty *)malloc((num_slots + 1) * sizeof(task_slot_ty));
+	loaded = (task_ty **)malloc((num_tasks + 1) * sizeof(task_ty *));
+	if (NULL == slots || NULL == loaded ||
+		LoadSlotsIMP(stream, slots, num_slots) ||
+		LoadTasksIMP(stream, slots, num_slots, loaded, num_tasks, types, num_types))
+	{
+		free(slots);
+		free(loaded);
+		return 1;
+	}
+
+	InstallSlotsIMP(scheduler, slots, num_slots);
+	idx = QueueLoadedIMP(scheduler, loaded, num_tasks);
+
+	/* a heap could not grow: free the tasks not queued and the queued ones */
+	status = (idx < num_tasks);
+	if (status)
+	{
+		for (; idx < num_tasks; ++idx)
+		{
+			FreeTaskIMP(scheduler, loaded[idx]);
+		}
+		ClearTasksIMP(scheduler);
+	}
+
+	free(loaded);
+
+	return status;
+}
+
+
+/*******************************************************************************
+***************************** Side Functions **********************************/
+static task_ty *CreateNewTaskIMP(scheduler_ty *sched, TaskFunc exe_task_p, void *params, time_t interval)
+{
+	time_t actual_time = 0;
+	task_ty *ret_task = NULL;
+
+	/* a mapped task lives in the record of its slot, of a known type */
+	if (NULL != sched->map)
+	{
+		if (SLOT_NIL == sched->free_slot)
+		{
+			return NULL;
+		}
+
+		ret_task = MapTaskIMP(sched->map, sched->free_slot, exe_task_p);
+	}
+	/* allocate new task */
+	else
+	{
+		ret_task = (task_ty *)malloc(sizeof(task_ty));
+	}
+
+	/* check allocation failure  */
+	if (NULL == ret_task)
+	{
+		return NULL;
+	}
+
+	/* calculate the scheduler time whether it is running or not */
+	actual_time = sched->should_run * (time(NULL) - sched->initial_time);
+
+	/* Initi task fields */
+	ret_task->task_func_p = exe_task_p;
+	ret_task->params = params;
+	ret_task->interval = interval;
+	ret_task->next_run = actual_time + interval;
+	ret_task->is_cancelled = 0;
+	ret_task->is_in_fifo = 0;
+	ret_task->is_rescheduled = 0;
+
+	/* the slot sets the task id; mapped slots never run out here */
+	if (AcquireSlotIMP(sched, ret_task))
+	{
+		free(ret_task);
+		return NULL;
+	}
+
+	return ret_task;
+}
+
+
+static int ExecuteTaskIMP(task_ty *task_)
+{
+	return (task_->task_func_p(task_->params));
+}
+
+static int ReScheduleTaskIMP(scheduler_ty *th_, task_ty *task_)
+{
+	/* the task may have picked its next run itself */
+	if (!task_->is_rescheduled)
+	{
+		task_->next_run = (time(NULL) - th_->initial_time) + task_->interval;
+	}
+	task_->is_rescheduled = 0;
+
+	if (EnqueueIMP(th_, task_))
+	{
+		return 1;
+	}
+
+	PersistIMP(th_, task_->id & SLOT_MASK);
+
+	return 0;
+}
+
+/* the scheduler time; it reads 0 while not running */
+time_t ClockIMP(scheduler_ty *sched)
+{
+	if (!sched->should_run)
+	{
+		/* monotone engines must accept the clock of 0 again */
+		PQueueSetFloor(sched->tasks, 0);
+		return 0;
+	}
+
+	return (time(NULL) - sched->initial_time);
+}
+
+void ClearTasksIMP(scheduler_ty *th_)
+{
+	task_ty *to_remove = NULL;
+
+	/* traverse until pqueue is empty */
+	while (!IsQueueEmptyIMP(th_))
+	{
+		/* get first task in pqueue */
+		to_remove = PeekIMP(th_);
+
+		/* remove element from pqueue in scheduler; the task holds its link */
+		DequeueIMP(th_);
+
+		/* remove task, its id goes stale */
+		FreeTaskIMP(th_, to_remove);
+	}
+
+	th_->num_cancelled = 0;
+}
+
+/* empties the engine and leaves the tasks as they are */
+void DetachTasksIMP(scheduler_ty *sched)
+{
+	while (!IsQueueEmptyIMP(sched))
+	{
+		DequeueIMP(sched);
+	}
+
+	sched->num_cancelled = 0;
+}
+
+void FreeTaskIMP(scheduler_ty *sched, task_ty *task)
+{
+	sched_id_ty id = task->id;
+
+	ReleaseSlotIMP(sched, id);
+
+	if (NULL != sched->stats)
+	{
+		StatsForgetIMP(sched->stats, id);
+	}
+
+	/* the id is stale already, the params are still the task's */
+	if (NULL != sched->hooks.on_remove)
+	{
+		sched->hooks.on_remove(id, task->params, sched->hooks.hook_params);
+	}
+
+	/* DEBUG ONLY */
+	BreakTaskIMP(task);
+
+	/* a mapped task goes back to its record, now free */
+	if (NULL != sched->map)
+	{
+		PersistIMP(sched, id & SLOT_MASK);
+		return;
+	}
+
+	free(task);
+}
+
+static int IsSameTaskIMP(const void *task_, const void *searched_task_)
+{
+	return (task_ == searched_task_);
+}
+
+static void BreakSchedulerIMP(scheduler_ty *th_)
+{
+    DEBUG_MODE
+    (
+		th_->tasks = INVALID_PTR;
+		th_->fifo = INVALID_PTR;
+		th_->calendar = INVALID_PTR;
+		th_->slots = INVALID_PTR;
+		th_->map = INVALID_PTR;
+		th_->journal = INVALID_PTR;
+		th_->shm = INVALID_PTR;
+		th_->stats = INVALID_PTR;
+		th_->acct = INVALID_PTR;
+		th_->initial_time = 0;
+		th_->current_task = 0;
+		th_->should_run = 0;
+    ); /* DEBUG ONLY */
+}
+
+static void BreakTaskIMP(task_ty *th_)
+{
+	DEBUG_MODE
+	(
+		th_->params = INVALID_PTR;
+		th_->interval = 0;
+		th_->next_run = 0;
+		th_->id = SCHED_BAD_ID;
+	) /* DEBUG ONLY */
+}
+
+
+/*******************************************************************************
+***************************** Task Slots **************************************/
+static int AcquireSlotIMP(scheduler_ty *sched, task_ty *task)
+{
+	sched_id_ty generation = 0;
+	size_t num_slots = 0;
+	size_t idx = 0;
+
+	/* a shared table hands out the slots to every process */
+	if (NULL != sched->shm)
+	{
+		idx = ShmAcquireIMP(sched->shm, &generation);
+		if (SLOT_NIL == idx)
+		{
+			return 1;
+		}
+
+		sched->slots[idx].generation = generation;
+		sched->slots[idx].task = task;
+		task->id = (sched->slots[idx].generation << SLOT_BITS) | (sched_id_ty)idx;
+
+		return 0;
+	}
+
+	/* no free slot: double the table, up to what SLOT_BITS can address;
+	   a mapped table is as big as its file */
+	if (SLOT_NIL == sched->free_slot)
+	{
+		num_slots = (0 == sched->num_slots) ? SLOTS_INIT : 2 * sched->num_slots;
+		if (num_slots - 1 > SLOT_MASK)
+		{
+			num_slots = (size_t)SLOT_MASK + 1;
+		}
+		if (NULL != sched->map || num_slots == sched->num_slots ||
+			GrowSlotsIMP(sched, num_slots))
+		{
+			return 1;
+		}
+	}
+
+	idx = sched->free_slot;
+	sched->free_slot = sched->slots[idx].next_free;
+	sched->slots[idx].task = task;
+
+	task->id = (sched->slots[idx].generation << SLOT_BITS) | (sched_id_ty)idx;
+
+	return 0;
+}
+
+static void ReleaseSlotIMP(scheduler_ty *sched, sched_id_ty id)
+{
+	task_slot_ty *slot = &sched->slots[id & SLOT_MASK];
+
+	/* the next owner gets a new id */
+	slot->generation = NextGenerationIMP(slot->generation);
+
+	slot->task = NULL;
+	if (NULL != sched->shm)
+	{
+		ShmReleaseIMP(sched->shm, (size_t)(id & SLOT_MASK), slot->generation);
+		return;
+	}
+
+	slot->next_free = sched->free_slot;
+	sched->free_slot = (size_t)(id & SLOT_MASK);
+}
+
+/* NULL when id is stale or its task is cancelled */
+task_ty *LookupIMP(const scheduler_ty *sched, sched_id_ty id)
+{
+	sched_id_ty idx = id & SLOT_MASK;
+	const task_slot_ty *slot = NULL;
+
+	if (idx >= sched->num_slots)
+	{
+		return NULL;
+	}
+
+	slot = &sched->slots[idx];
+	if (NULL == slot->task || slot->generation != (id >> SLOT_BITS) ||
+		slot->task->is_cancelled)
+	{
+		return NULL;
+	}
+
+	return slot->task;
+}
+
+/* generation 0 is never used */
+sched_id_ty NextGenerationIMP(sched_id_ty generation)
+{
+	generation = (generation + 1) & SLOT_MASK;
+
+	return (0 == generation) ? 1 : generation;
+}
+
+/* the new slots are free at generation 1, chained lowest index first */
+int GrowSlotsIMP(scheduler_ty *sched, size_t num_slots)
+{
+	task_slot_ty *slots = NULL;
+	size_t idx = 0;
+
+	slots = (task_slot_ty *)realloc(sched->slots, num_slots * sizeof(task_slot_ty));
+	if (NULL == slots)
+	{
+		return 1;
+	}
+
+	for (idx = num_slots; idx > sched->num_slots; --idx)
+	{
+		slots[idx - 1].task = NULL;
+		slots[idx - 1].generation = 1;
+		slots[idx - 1].next_free = sched->free_slot;
+		sched->free_slot = idx - 1;
+	}
+
+	sched->slots = slots;
+	sched->num_slots = num_slots;
+
+	return 0;
+}
+
+/* builds the free list again from the slots without a task, lowest first */
+void ChainFreeSlotsIMP(scheduler_ty *sched)
+{
+	size_t idx = 0;
+
+	sched->free_slot = SLOT_NIL;
+	for (idx = sched->num_slots; idx > 0; --idx)
+	{
+		if (NULL == sched->slots[idx - 1].task)
+		{
+			sched->slots[idx - 1].next_free = sched->free_slot;
+			sched->free_slot = idx - 1;
+		}
+	}
+}
+
+/* slots replaces the table, which may be NULL */
+void InstallSlotsIMP(scheduler_ty *sched, task_slot_ty *slots,
+							size_t num_slots)
+{
+	free(sched->slots);
+	sched->slots = slots;
+	sched->num_slots = num_slots;
+	ChainFreeSlotsIMP(sched);
+}
+
+/* the tasks are sorted to run order, so every engine takes them at the
+   back. Returns how many were queued before a heap could not grow */
+size_t QueueLoadedIMP(scheduler_ty *sched, task_ty **loaded,
+							size_t num_tasks)
+{
+	size_t idx = 0;
+
+	qsort(loaded, num_tasks, sizeof(task_ty *), CmpNextRunIMP);
+	PQueueSetFloor(sched->tasks, 0);
+
+	for (idx = 0; idx < num_tasks; ++idx)
+	{
+		if (EnqueueIMP(sched, loaded[idx]))
+		{
+			break;
+		}
+	}
+
+	return idx;
+}
+
+
+/*******************************************************************************
+***************************** Snapshot ****************************************/
+/* from now on the scheduler clock; the running task is queued again at its
+   SchedReschedule time or at now + interval */
+time_t TimeLeftIMP(const scheduler_ty *sched, const task_ty *task)
+{
+	time_t now = sched->should_run * (time(NULL) - sched->initial_time);
+	time_t left = task->next_run - now;
+
+	if (task == sched->current_task && !task->is_rescheduled)
+	{
+		left = task->interval;
+	}
+
+	return (0 > left) ? 0 : left;
+}
+
+const sched_task_type_ty *TypeOfFuncIMP(const sched_task_type_ty *types,
+											size_t num_types, TaskFunc func)
+{
+	size_t i = 0;
+
+	for (i = 0; i < num_types; ++i)
+	{
+		if (types[i].task_func == func)
+		{
+			return &types[i];
+		}
+	}
+
+	return NULL;
+}
+
+const sched_task_type_ty *TypeOfKeyIMP(const sched_task_type_ty *types,
+											size_t num_types, unsigned long key)
+{
+	size_t i = 0;
+
+	for (i = 0; i < num_types; ++i)
+	{
+		if (types[i].key == key)
+		{
+			return &types[i];
+		}
+	}
+
+	return NULL;
+}
+
+static int LoadSlotsIMP(FILE *stream, task_slot_ty *slots, size_t num_slots)
+{
+	unsigned char buffer[SNAP_CHUNK * 4];
+	size_t num_read = 0;
+	size_t idx = 0;
+	size_t i = 0;
+
+	while (idx < num_slots)
+	{
+		num_read = (SNAP_CHUNK < num_slots - idx) ? SNAP_CHUNK : num_slots - idx;
+		if (num_read != fread(buffer, 4, num_read, stream))
+		{
+			return 1;
+		}
+
+		for (i = 0; i < num_read; ++i, ++idx)
+		{
+			slots[idx].task = NULL;
+			slots[idx].generation = GetIMP(buffer + 4 * i, 4);
+			slots[idx].next_free = SLOT_NIL;
+			if (0 == slots[idx].generation || SLOT_MASK < slots[idx].generation)
+			{
+				return 1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+/* allocates every task in its saved slot; frees them all on failure */
+static int LoadTasksIMP(FILE *stream, task_slot_ty *slots, size_t num_slots,
+						task_ty **loaded, size_t num_tasks,
+						const sched_task_type_ty *types, size_t num_types)
+{
+	unsigned char buffer[SNAP_CHUNK * SNAP_RECORD_SIZE];
+	const unsigned char *record = NULL;
+	const sched_task_type_ty *type = NULL;
+	task_ty *task = NULL;
+	sched_id_ty id = 0;
+	size_t num_loaded = 0;
+	size_t num_read = 0;
+	size_t i = 0;
+
+	while (num_loaded < num_tasks)
+	{
+		num_read = (SNAP_CHUNK < num_tasks - num_loaded) ?
+					SNAP_CHUNK : num_tasks - num_loaded;
+		if (num_read != fread(buffer, SNAP_RECORD_SIZE, num_read, stream))
+		{
+			break;
+		}
+
+		for (i = 0; i < num_read; ++i)
+		{
+			record = buffer + i * SNAP_RECORD_SIZE;
+			id = GetIMP(record, 8);
+			type = TypeOfKeyIMP(types, num_types, GetIMP(record + 8, 8));
+
+			/* the id must name a free slot at its saved generation */
+			if (NULL == type || (id & SLOT_MASK) >= num_slots ||
+				NULL != slots[id & SLOT_MASK].task ||
+				slots[id & SLOT_MASK].generation != (id >> SLOT_BITS))
+			{
+				break;
+			}
+
+			task = (task_ty *)malloc(sizeof(task_ty));
+			if (NULL == task)
+			{
+				break;
+			}
+
+			task->task_func_p = type->task_func;
+			task->params = type->params;
+			task->interval = (time_t)GetIMP(record + 16, 8);
+			task->next_run = (time_t)GetIMP(record + 24, 8);
+			task->id = id;
+			task->is_cancelled = 0;
+			task->is_in_fifo = 0;
+			task->is_rescheduled = 0;
+
+			slots[id & SLOT_MASK].task = task;
+			loaded[num_loaded++] = task;
+		}
+
+		if (i < num_read)
+		{
+			break;
+		}
+	}
+
+	if (num_loaded == num_tasks)
+	{
+		return 0;
+	}
+
+	for (i = 0; i < num_loaded; ++i)
+	{
+		free(loaded[i]);
+	}
+
+	return 1;
+}
+
+/* by next run, then by slot: the order of equal times is reproducible */
+static int CmpNextRunIMP(const void *task1, const void *task2)
+{
+	const task_ty *first = *(task_ty * const *)task1;
+	const task_ty *second = *(task_ty * const *)task2;
+	sched_id_ty slot1 = first->id & SLOT_MASK;
+	sched_id_ty slot2 = second->id & SLOT_MASK;
+
+	if (first->next_run != second->next_run)
+	{
+		return (first->next_run > second->next_run) ? 1 : -1;
+	}
+
+	return (slot1 > slot2) - (slot1 < slot2);
+}
+
+void PutIMP(unsigned char *to, unsigned long value, size_t num_bytes)
+{
+	size_t i = 0;
+
+	for (i = 0; i < num_bytes; ++i)
+	{
+		to[i] = (unsigned char)(value & 0xff);
+		value >>= 8;
+	}
+}
+
+/* num_bytes is at most 8: unsigned long is 64 bits, see id_is_64_bits_ty */
+unsigned long GetIMP(const unsigned char *from, size_t num_bytes)
+{
+	unsigned long value = 0;
+	size_t i = num_bytes;
+
+	while (0 < i)
+	{
+		--i;
+		value = (value << 8) | from[i];
+	}
+
+	return value;
+}
+
+/* FNV-1a, 32 bit */
+unsigned long ChecksumIMP(const void *data, size_t num_bytes)
+{
+	const unsigned char *byte = (const unsigned char *)data;
+	unsigned long hash = FNV_OFFSET;
+	size_t i = 0;
+
+	for (i = 0; i < num_bytes; ++i)
+	{
+		hash = ((hash ^ byte[i]) * FNV_PRIME) & 0xffffffffUL;
+	}
+
+	return hash;
+}
+
+
+/*******************************************************************************
+***************************** Task Accounting *********************************/
+/* the table grows to the slots on the first run of a new slot; without
+   memory the run is not counted */
+static void AccountIMP(scheduler_ty *sched, const task_ty *task,
+						const struct timespec *cpu_start, int status)
+{
+	struct timespec cpu_end;
+	task_acct_ty *acct = NULL;
+	size_t idx = (size_t)(task->id & SLOT_MASK);
+	unsigned long cpu_ns = 0;
+
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_end);
+
+	if (idx >= sched->num_acct)
+	{
+		acct = (task_acct_ty *)realloc(sched->acct, sched->num_slots * sizeof(task_acct_ty));
+		if (NULL == acct)
+		{
+			return;
+		}
+
+		for (; sched->num_acct < sched->num_slots; ++sched->num_acct)
+		{
+			acct[sched->num_acct].id = SCHED_BAD_ID;
+		}
+		sched->acct = acct;
+	}
+
+	/* a task new to the slot starts from 0 */
+	acct = &sched->acct[idx];
+	if (task->id != acct->id)
+	{
+		acct->id = task->id;
+		acct->stats.runs = 0;
+		acct->stats.failures = 0;
+		acct->stats.cpu_ns = 0;
+		acct->stats.max_cpu_ns = 0;
+	}
+
+	cpu_ns = (unsigned long)(cpu_end.tv_sec - cpu_start->tv_sec) * 1000000000UL +
+			(unsigned long)cpu_end.tv_nsec - (unsigned long)cpu_start->tv_nsec;
+
+	++acct->stats.runs;
+	acct->stats.failures += (0 != status);
+	acct->stats.cpu_ns += cpu_ns;
+	if (cpu_ns > acct->stats.max_cpu_ns)
+	{
+		acct->stats.max_cpu_ns = cpu_ns;
+	}
+}
+
+/*******************************************************************************
+***************************** Overload ****************************************/
+static int IsBudgetSpentIMP(const struct timespec *start, unsigned long budget_ms)
+{
+	struct timespec now;
+	long elapsed_ms = 0;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	elapsed_ms = (long)(now.tv_sec - start->tv_sec) * 1000 +
+				(now.tv_nsec - start->tv_nsec) / 1000000;
+
+	return (elapsed_ms >= (long)budget_ms);
+}
+
+/* a task turned away is counted */
+int IsFullIMP(scheduler_ty *sched)
+{
+	if (0 == sched->max_size || SchedSize(sched) < sched->max_size)
+	{
+		return 0;
+	}
+
+	++sched->num_rejected;
+
+	return 1;
+}
+
+/*******************************************************************************
+***************************** Engine Functions ********************************/
+int EnqueueIMP(scheduler_ty *sched, task_ty *task)
+{
+	SDT_PROBE2(scheduler, enqueue, task->id, task->next_run);
+
+	if (SCHED_ENGINE_CALENDAR == sched->engine)
+	{
+		return (CQueuePush(sched->calendar, task->next_run, task));
+	}
+
+	/* FIFO engine takes the common intervals, the pqueue the rest */
+	if (SCHED_ENGINE_FIFO == sched->engine && 0 == FifoPushIMP(sched->fifo, task))
+	{
+		return 0;
+	}
+
+	/* now + interval usually lands near the back */
+	if (PQueueEnqueueBack(sched->tasks, task))
+	{
+		return 1;
+	}
+
+	AdaptIMP(sched);
+
+	return 0;
+}
+
+static task_ty *PeekIMP(const scheduler_ty *sched)
+{
+	task_ty *general = NULL;
+	task_ty *fifo_head = NULL;
+
+	if (SCHED_ENGINE_CALENDAR == sched->engine)
+	{
+		return CQueuePeek(sched->calendar);
+	}
+
+	if (!PQueueIsEmpty(sched->tasks))
+	{
+		general = PQueuePeek(sched->tasks);
+	}
+
+	if (SCHED_ENGINE_FIFO != sched->engine || 0 == sched->fifo->num_heads)
+	{
+		return general;
+	}
+
+	fifo_head = FifoHeadIMP(sched->fifo->heads[0]);
+
+	/* equal times prefer the FIFO buckets; DequeueIMP makes the same choice */
+	if (NULL == general || fifo_head->next_run <= general->next_run)
+	{
+		return fifo_head;
+	}
+
+	return general;
+}
+
+static void DequeueIMP(scheduler_ty *sched)
+{
+	if (SCHED_ENGINE_CALENDAR == sched->engine)
+	{
+		CQueuePop(sched->calendar);
+		return;
+	}
+
+	if (SCHED_ENGINE_FIFO == sched->engine && 0 != sched->fifo->num_heads &&
+		PeekIMP(sched) == FifoHeadIMP(sched->fifo->heads[0]))
+	{
+		FifoPopIMP(sched->fifo, sched->fifo->heads[0]);
+		return;
+	}
+
+	PQueueDequeue(sched->tasks);
+	AdaptIMP(sched);
+}
+
+void UnlinkIMP(scheduler_ty *sched, task_ty *task)
+{
+	if (SCHED_ENGINE_CALENDAR == sched->engine)
+	{
+		CQueueEraseKey(sched->calendar, task->next_run, IsSameTaskIMP, task);
+		return;
+	}
+
+	if (SCHED_ENGINE_FIFO == sched->engine && 0 == FifoEraseIMP(sched->fifo, task))
+	{
+		return;
+	}
+
+	PQueueUnlink(sched->tasks, task);
+	AdaptIMP(sched);
+}
+
+/* FIFO buckets are keyed by interval and the calendar is not a pqueue:
+   detach and queue again. A pqueue moves the task in place, and on failure
+   the task stays queued as it was. */
+int RepositionIMP(scheduler_ty *sched, task_ty *task, time_t next_run,
+						time_t interval)
+{
+	sched_id_ty id = task->id;
+
+	if (SCHED_ENGINE_CALENDAR == sched->engine || task->is_in_fifo)
+	{
+		UnlinkIMP(sched, task);
+		task->next_run = next_run;
+		task->interval = interval;
+
+		/* the calendar may allocate to queue it again; a task out of the
+		   queue must not keep its id, so it is removed */
+		if (EnqueueIMP(sched, task))
+		{
+			FreeTaskIMP(sched, task);
+			JournalIMP(sched, JRNL_REMOVE, id, NULL);
+			return 1;
+		}
+	}
+	else
+	{
+		if (PQueueUpdateKey(sched->tasks, task, next_run))
+		{
+			return 1;
+		}
+
+		task->interval = interval;
+	}
+
+	PersistIMP(sched, task->id & SLOT_MASK);
+	JournalIMP(sched, JRNL_RESCHEDULE, task->id, task);
+
+	return 0;
+}
+
+static int IsQueueEmptyIMP(const scheduler_ty *sched)
+{
+	return (PQueueIsEmpty(sched->tasks) &&
+			(NULL == sched->fifo || 0 == sched->fifo->size) &&
+			(NULL == sched->calendar || CQueueIsEmpty(sched->calendar)));
+}
+
+/* SchedRun goes on while tasks are queued, those of clients included */
+static int HasWorkIMP(scheduler_ty *sched)
+{
+	if (NULL != sched->shm)
+	{
+		ShmDrainIMP(sched);
+	}
+
+	return !IsQueueEmptyIMP(sched);
+}
+
+/* tasks in the engine, cancelled ones included */
+static size_t QueueSizeIMP(const scheduler_ty *sched)
+{
+	return PQueueSize(sched->tasks) +
+			((NULL != sched->fifo) ? sched->fifo->size : 0) +
+			((NULL != sched->calendar) ? CQueueSize(sched->calendar) : 0);
+}
+
+/* drains the engine in run order and puts back the live tasks, so equal
+   run times keep their order. A task which cannot be put back is freed,
+   as SchedRun does when rescheduling fails. */
+static void CompactIMP(scheduler_ty *sched)
+{
+	task_ty **live = NULL;
+	task_ty *task = NULL;
+	size_t num_live = 0;
+	size_t i = 0;
+
+	if (COMPACT_MIN > sched->num_cancelled ||
+		sched->num_cancelled * COMPACT_RATIO <= QueueSizeIMP(sched))
+	{
+		return;
+	}
+
+	live = (task_ty **)malloc((SchedSize(sched) + 1) * sizeof(task_ty *));
+
+	/* try again on the next add or run iteration */
+	if (NULL == live)
+	{
+		return;
+	}
+
+	while (!IsQueueEmptyIMP(sched))
+	{
+		task = PeekIMP(sched);
+		DequeueIMP(sched);
+
+		if (task->is_cancelled)
+		{
+			FreeTaskIMP(sched, task);
+		}
+		else
+		{
+			live[num_live++] = task;
+		}
+	}
+
+	sched->num_cancelled = 0;
+
+	for (i = 0; i < num_live; ++i)
+	{
+		if (EnqueueIMP(sched, live[i]))
+		{
+			FreeTaskIMP(sched, live[i]);
+		}
+	}
+
+	free(live);
+}
+
+static pqueue_ty *CreateTasksQueueIMP(enum sched_engine_ty engine)
+{
+	if (SCHED_ENGINE_RADIX == engine)
+	{
+		return PQueueCreateRadixHeap(OFFSETOF_SIZE_T(task_ty, next_run));
+	}
+
+	if (SCHED_ENGINE_PAIRING == engine)
+	{
+		return PQueueCreatePairingHeap(OFFSETOF_SIZE_T(task_ty, next_run),
+										OFFSETOF_SIZE_T(task_ty, heap_node));
+	}
+
+	return PQueueCreateIntrusive(OFFSETOF_SIZE_T(task_ty, next_run),
+								OFFSETOF_SIZE_T(task_ty, link));
+}
+
+/* the tasks pqueue an engine starts with; the others share the sorted one */
+static enum sched_engine_ty QueueKindIMP(enum sched_engine_ty engine)
+{
+	if (SCHED_ENGINE_RADIX == engine || SCHED_ENGINE_PAIRING == engine)
+	{
+		return engine;
+	}
+
+	return SCHED_ENGINE_PQUEUE;
+}
+
+static void AdaptIMP(scheduler_ty *sched)
+{
+	size_t size = 0;
+	pqueue_ty *to = NULL;
+
+	if (SCHED_ENGINE_ADAPTIVE != sched->engine)
+	{
+		return;
+	}
+
+	size = PQueueSize(sched->tasks);
+
+	if (!sched->is_heap && ADAPT_GROW < size)
+	{
+		to = PQueueCreateDAryHeapIndexed(OFFSETOF_SIZE_T(task_ty, next_run),
+									DHEAP_DEFAULT_ARITY,
+									OFFSETOF_SIZE_T(task_ty, heap_idx));
+	}
+	else if (sched->is_heap && ADAPT_SHRINK > size)
+	{
+		to = CreateTasksQueueIMP(SCHED_ENGINE_ADAPTIVE);
+	}
+
+	/* on failure keep the current queue; the next change tries again */
+	if (NULL != to && 0 == MigrateTasksIMP(sched, to))
+	{
+		sched->is_heap = !sched->is_heap;
+	}
+}
+
+/* moves the tasks in run order, so each lands at the back of the sorted
+   list; only heap pushes allocate, and the intrusive list takes back every
+   task when one of them fails */
+static int MigrateTasksIMP(scheduler_ty *sched, pqueue_ty *to)
+{
+	pqueue_ty *from = sched->tasks;
+	task_ty *task = NULL;
+
+	while (!PQueueIsEmpty(from))
+	{
+		task = PQueuePeek(from);
+		PQueueDequeue(from);
+
+		if (PQueueEnqueueBack(to, task))
+		{
+			assert (!sched->is_heap && "MigrateTasks: sorted list enqueue failed");
+
+			PQueueEnqueue(from, task);
+			while (!PQueueIsEmpty(to))
+			{
+				task = PQueuePeek(to);
+				PQueueDequeue(to);
+				PQueueEnqueue(from, task);
+			}
+			PQueueDestroy(to);
+
+			return 1;
+		}
+	}
+
+	PQueueDestroy(from);
+	sched->tasks = to;
+
+	return 0;
+}
+
+
+/*******************************************************************************
+***************************** FIFO Engine *************************************/
+static fifo_engine_ty *FifoCreateIMP(void)
+{
+	fifo_engine_ty *fifo = (fifo_engine_ty *)malloc(sizeof(fifo_engine_ty));
+
+	if (NULL == fifo)
+	{
+		return NULL;
+	}
+
+	/* buckets get their dlist when an interval is first seen */
+	fifo->num_buckets = 0;
+	fifo->num_heads = 0;
+	fifo->size = 0;
+
+	return fifo;
+}
+
+static void FifoDestroyIMP(fifo_engine_ty *fifo)
+{
+	size_t i = 0;
+
+	assert (0 == fifo->size && "FifoDestroy: tasks are still linked");
+
+	for (i = 0; i < fifo->num_buckets; ++i)
+	{
+		DListDestroy(fifo->buckets[i].fifo);
+	}
+
+	free(fifo);
+}
+
+/* returns 0 when the task was queued; 1 when it belongs to the pqueue */
+static int FifoPushIMP(fifo_engine_ty *fifo, task_ty *task)
+{
+	fifo_bucket_ty *bucket = NULL;
+	fifo_bucket_ty *unused = NULL;
+	int was_empty = 0;
+	size_t i = 0;
+
+	for (i = 0; i < fifo->num_buckets && NULL == bucket; ++i)
+	{
+		if (fifo->buckets[i].interval == task->interval)
+		{
+			bucket = &fifo->buckets[i];
+		}
+		else if (NULL == unused && DListIsEmpty(fifo->buckets[i].fifo))
+		{
+			unused = &fifo->buckets[i];
+		}
+	}
+
+	/* an empty bucket is in no heap and links no task: it takes the new
+		interval, so the buckets follow the intervals in use */
+	if (NULL == bucket && NULL != unused)
+	{
+		bucket = unused;
+		bucket->interval = task->interval;
+	}
+
+	/* first task of a new interval opens a bucket while there is room */
+	if (NULL == bucket)
+	{
+		if (FIFO_BUCKETS == fifo->num_buckets)
+		{
+			return 1;
+		}
+
+		bucket = &fifo->buckets[fifo->num_buckets];
+		bucket->fifo = DListCreate();
+		if (NULL == bucket->fifo)
+		{
+			return 1;
+		}
+		bucket->interval = task->interval;
+		++fifo->num_buckets;
+	}
+
+	/* FIFO order holds only while next_run does not go back in time,
+		e.g. after SchedRun restarts the clock */
+	if (!DListIsEmpty(bucket->fifo) &&
+		((task_ty *)DListGetData(DListPrev(DListEnd(bucket->fifo))))->next_run >
+																task->next_run)
+	{
+		return 1;
+	}
+
+	was_empty = DListIsEmpty(bucket->fifo);
+	DListLink(DListEnd(bucket->fifo), &task->link, task);
+	task->is_in_fifo = 1;
+	++fifo->size;
+
+	/* bucket was empty, its head joins the heads heap */
+	if (was_empty)
+	{
+		bucket->heap_idx = fifo->num_heads;
+		fifo->heads[fifo->num_heads] = bucket;
+		++fifo->num_heads;
+		FifoSiftUpIMP(fifo, bucket->heap_idx);
+	}
+
+	return 0;
+}
+
+static task_ty *FifoHeadIMP(const fifo_bucket_ty *bucket)
+{
+	return DListGetData(DListBegin(bucket->fifo));
+}
+
+static void FifoPopIMP(fifo_engine_ty *fifo, fifo_bucket_ty *bucket)
+{
+	FifoHeadIMP(bucket)->is_in_fifo = 0;
+	DListUnlink(DListBegin(bucket->fifo));
+	--fifo->size;
+
+	FifoHeadChangedIMP(fifo, bucket);
+}
+
+/* returns 0 when task was linked in its interval bucket; 1 when it is
+   in the pqueue */
+static int FifoEraseIMP(fifo_engine_ty *fifo, task_ty *task)
+{
+	fifo_bucket_ty *bucket = NULL;
+	dlist_itr_ty where = {NULL};
+	int was_head = 0;
+	size_t i = 0;
+
+	if (!task->is_in_fifo)
+	{
+		return 1;
+	}
+
+	for (i = 0; i < fifo->num_buckets && NULL == bucket; ++i)
+	{
+		if (fifo->buckets[i].interval == task->interval)
+		{
+			bucket = &fifo->buckets[i];
+		}
+	}
+
+	/* the task embeds its bucket node */
+	where = DListItrOf(bucket->fifo, &task->link);
+	was_head = DListIsSameIter(where, DListBegin(bucket->fifo));
+
+	DListUnlink(where);
+	task->is_in_fifo = 0;
+	--fifo->size;
+
+	if (was_head)
+	{
+		FifoHeadChangedIMP(fifo, bucket);
+	}
+
+	return 0;
+}
+
+/* restore the heads heap after the first task of bucket left */
+static void FifoHeadChangedIMP(fifo_engine_ty *fifo, fifo_bucket_ty *bucket)
+{
+	size_t idx = bucket->heap_idx;
+
+	/* empty bucket leaves the heap, the last head takes its place */
+	if (DListIsEmpty(bucket->fifo))
+	{
+		--fifo->num_heads;
+		if (idx == fifo->num_heads)
+		{
+			return;
+		}
+
+		fifo->heads[idx] = fifo->heads[fifo->num_heads];
+		fifo->heads[idx]->heap_idx = idx;
+		FifoSiftUpIMP(fifo, idx);
+	}
+
+	/* new head runs later than the old one */
+	FifoSiftDownIMP(fifo, idx);
+}
+
+static void FifoSiftUpIMP(fifo_engine_ty *fifo, size_t idx)
+{
+	fifo_bucket_ty *to_place = fifo->heads[idx];
+	size_t parent = 0;
+
+	while (0 < idx)
+	{
+		parent = (idx - 1) / 2;
+		if (FifoHeadIMP(fifo->heads[parent])->next_run <= FifoHeadIMP(to_place)->next_run)
+		{
+			break;
+		}
+
+		fifo->heads[idx] = fifo->heads[parent];
+		fifo->heads[idx]->heap_idx = idx;
+		idx = parent;
+	}
+
+	fifo->heads[idx] = to_place;
+	to_place->heap_idx = idx;
+}
+
+static void FifoSiftDownIMP(fifo_engine_ty *fifo, size_t idx)
+{
+	fifo_bucket_ty *to_place = fifo->heads[idx];
+	size_t child = 0;
+
+	while ((child = 2 * idx + 1) < fifo->num_heads)
+	{
+		if (child + 1 < fifo->num_heads &&
+			FifoHeadIMP(fifo->heads[child + 1])->next_run <
+			FifoHeadIMP(fifo->heads[child])->next_run)
+		{
+			++child;
+		}
+
+		if (FifoHeadIMP(to_place)->next_run <= FifoHeadIMP(fifo->heads[child])->next_run)
+		{
+			break;
+		}
+
+		fifo->heads[idx] = fifo->heads[child];
+		fifo->heads[idx]->heap_idx = idx;
+		idx = child;
+	}
+
+	fifo->heads[idx] = to_place;
+	to_place->heap_idx = idx;
 }
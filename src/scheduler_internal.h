@@ -0,0 +1,169 @@
+/*******************************************************************************
+*************************** - SCHEDULER INTERNAL - *****************************
+*
+*	DESCRIPTION		Internal - the task, slot and scheduler structs and the
+*					core functions shared by the scheduler modules
+*	AUTHOR 			Liad Raz
+*	FILES			scheduler.c sched_map.c sched_journal.c sched_shm.c
+*					sched_stats.c scheduler_internal.h
+*
+*******************************************************************************/
+
+#ifndef __SCHEDULER_INTERNAL_H__
+#define __SCHEDULER_INTERNAL_H__
+
+#include <stddef.h> 		/* size_t */
+#include <limits.h>			/* CHAR_BIT */
+#include <time.h>			/* time_t */
+#include <assert.h>			/* assert */
+
+#include "pqueue.h"			/* pqueue_ty, pq_link_ty, pq_heap_node_ty */
+#include "calendar_queue.h"	/* cqueue_ty */
+#include "scheduler.h"
+
+#define SC_ASSERT_NOT_NULL(ptr)	assert (NULL != ptr \
+								&& "SCHEDULER is not allocated");
+
+/* task id: slot generation in the high half, slot index in the low half.
+   Generations start at 1, so no id equals SCHED_BAD_ID */
+#define SLOT_BITS 		(sizeof(sched_id_ty) * CHAR_BIT / 2)
+#define SLOT_MASK 		(~(sched_id_ty)0 >> SLOT_BITS)
+#define SLOT_NIL 		((size_t)-1)
+
+typedef struct task task_ty;
+struct task
+{
+    TaskFunc	task_func_p;
+    void	 	*params;
+    time_t	 	interval;
+    time_t 		next_run;
+    sched_id_ty	id;
+    int			is_cancelled;	/* tombstone, dropped when it reaches the head */
+    int			is_in_fifo;	/* linked in a FIFO bucket, not in the pqueue */
+    int			is_rescheduled;	/* next_run set by SchedReschedule while running */
+    pq_link_ty	link;		/* pqueue node embedded in the task */
+    size_t		heap_idx;	/* position while queued in a heap */
+    pq_heap_node_ty heap_node;	/* node while queued in a pairing heap */
+};
+
+/* keyed pqueues read next_run in place as a long; a build where time_t is
+   another size fails here, array size -1 */
+typedef char time_t_is_long_ty[(sizeof(time_t) == sizeof(long)) ? 1 : -1];
+
+/* ids, snapshots and journals take 32 bit slots and generations from a 64
+   bit unsigned long; with a 32 bit one they would be cut to 16 bits */
+typedef char id_is_64_bits_ty[(sizeof(sched_id_ty) * CHAR_BIT == 64) ? 1 : -1];
+
+/* each module keeps its own state behind these */
+typedef struct task_map task_map_ty;		/* sched_map.c */
+typedef struct journal journal_ty;			/* sched_journal.c */
+typedef struct fifo_engine fifo_engine_ty;	/* scheduler.c */
+
+/* counts of the task of id, kept apart from the tasks: SchedRun touches
+   them only while accounting is on */
+typedef struct task_acct
+{
+    sched_id_ty	id;				/* SCHED_BAD_ID before the first run */
+    sched_task_stats_ty stats;
+} task_acct_ty;
+
+/* every task owns a slot while it is allocated; releasing the slot bumps
+   its generation, so ids of freed tasks no longer match */
+typedef struct task_slot
+{
+    task_ty		*task;			/* NULL while the slot is free */
+    sched_id_ty	generation;
+    size_t		next_free;
+} task_slot_ty;
+
+struct scheduler
+{
+    pqueue_ty 	*tasks;
+    time_t 		initial_time;
+    task_ty 	*current_task;
+    int 		should_run;
+    enum sched_engine_ty engine;
+    fifo_engine_ty *fifo;	/* SCHED_ENGINE_FIFO only */
+    cqueue_ty	*calendar;	/* SCHED_ENGINE_CALENDAR only */
+    int			is_heap;	/* SCHED_ENGINE_ADAPTIVE: tasks is a heap */
+    int			lazy_remove;
+    size_t		num_cancelled;	/* tombstones still queued */
+    task_slot_ty *slots;		/* id -> task */
+    size_t		num_slots;
+    size_t		free_slot;		/* head of the free slots list */
+    task_map_ty	*map;			/* tasks live in its records; SchedMapOpen */
+    journal_ty	*journal;		/* SchedJournalStart */
+    sched_shm_ty *shm;			/* ids and requests shared; SchedShmCreate */
+    sched_stats_view_ty *stats;	/* published statistics; SchedStatsCreate */
+    sched_hooks_ty hooks;		/* members are NULL unless set */
+    int			is_accounting;	/* SchedSetTaskStats */
+    task_acct_ty *acct;			/* by slot, grown up to num_slots */
+    size_t		num_acct;
+    unsigned long budget_ms;	/* of a wakeup; 0 unlimited */
+    size_t		max_size;		/* tasks SchedAdd admits; 0 unlimited */
+    unsigned long num_deferred;
+    unsigned long num_rejected;
+};
+
+/******************************************************************************
+**************************** Core, scheduler.c ********************************/
+/* the scheduler time; it reads 0 while not running */
+time_t ClockIMP(scheduler_ty *sched);
+
+/* frees every queued task; their ids go stale */
+void ClearTasksIMP(scheduler_ty *sched);
+
+/* frees a task which is out of the engine, and its slot */
+void FreeTaskIMP(scheduler_ty *sched, task_ty *task);
+
+/* empties the engine and leaves the tasks as they are */
+void DetachTasksIMP(scheduler_ty *sched);
+
+/* generation 0 is never used */
+sched_id_ty NextGenerationIMP(sched_id_ty generation);
+
+/* NULL when id is stale or its task is cancelled */
+task_ty *LookupIMP(const scheduler_ty *sched, sched_id_ty id);
+
+/* the new slots are free at generation 1, chained lowest index first */
+int GrowSlotsIMP(scheduler_ty *sched, size_t num_slots);
+
+/* builds the free list again from the slots without a task, lowest first */
+void ChainFreeSlotsIMP(scheduler_ty *sched);
+
+/* slots replaces the table, which may be NULL */
+void InstallSlotsIMP(scheduler_ty *sched, task_slot_ty *slots, size_t num_slots);
+
+/* queues the loaded tasks in run order; returns how many were queued before
+   a heap could not grow */
+size_t QueueLoadedIMP(scheduler_ty *sched, task_ty **loaded, size_t num_tasks);
+
+/* queue operations of the engine in use */
+int EnqueueIMP(scheduler_ty *sched, task_ty *task);
+void UnlinkIMP(scheduler_ty *sched, task_ty *task);
+
+/* SchedSetMaxSize is reached; a task turned away is counted */
+int IsFullIMP(scheduler_ty *sched);
+
+/* moves a queued task to next_run and interval; on failure it stays
+   queued as it was */
+int RepositionIMP(scheduler_ty *sched, task_ty *task, time_t next_run,
+					time_t interval);
+
+/* from now on the scheduler clock */
+time_t TimeLeftIMP(const scheduler_ty *sched, const task_ty *task);
+
+/* the entry of func or key in types; NULL when it has none */
+const sched_task_type_ty *TypeOfFuncIMP(const sched_task_type_ty *types,
+										size_t num_types, TaskFunc func);
+const sched_task_type_ty *TypeOfKeyIMP(const sched_task_type_ty *types,
+										size_t num_types, unsigned long key);
+
+/* little endian, num_bytes at most 8 */
+void PutIMP(unsigned char *to, unsigned long value, size_t num_bytes);
+unsigned long GetIMP(const unsigned char *from, size_t num_bytes);
+
+/* FNV-1a, 32 bit */
+unsigned long ChecksumIMP(const void *data, size_t num_bytes);
+
+#endif /* __SCHEDULER_INTERNAL_H__ */
@@ -0,0 +1,229 @@
+/*******************************************************************************
+********************************* - SLOT POOL - ********************************
+*
+*	DESCRIPTION		Implementation of the slot pool and its bucket chains
+*	AUTHOR 			Liad Raz
+*
+*******************************************************************************/
+
+#include <stdlib.h>			/* malloc, realloc, free */
+#include <assert.h>			/* assert */
+
+#include "utilities.h"
+#include "slot_pool.h"
+
+#define SPASSERT_NOT_NULL(ptr)									\
+		assert (NULL != ptr && "Slot pool is not allocated");
+
+
+/*******************************************************************************
+***************************** SlotPool Init ***********************************/
+int SlotPoolInit(slot_pool_ty *pool, size_t capacity)
+{
+	SPASSERT_NOT_NULL(pool);
+	assert (0 != capacity && "SlotPoolInit: capacity is 0");
+
+	pool->slots = (pool_slot_ty *)malloc(capacity * sizeof(pool_slot_ty));
+
+	/* check allocation failure */
+	if (NULL == pool->slots)
+	{
+		return 1;
+	}
+
+	pool->capacity = capacity;
+	SlotPoolClear(pool);
+
+	return 0;
+}
+
+/*******************************************************************************
+***************************** SlotPool Free ***********************************/
+void SlotPoolFree(slot_pool_ty *pool)
+{
+	SPASSERT_NOT_NULL(pool);
+
+	free(pool->slots);
+
+	/* break pool fields */
+	DEBUG_MODE
+	(
+		pool->slots = INVALID_PTR;
+	)
+}
+
+/*******************************************************************************
+***************************** SlotPool Clear **********************************/
+void SlotPoolClear(slot_pool_ty *pool)
+{
+	SPASSERT_NOT_NULL(pool);
+
+	pool->used = 0;
+	pool->free_head = SLOT_POOL_NIL;
+	pool->size = 0;
+}
+
+/*******************************************************************************
+***************************** SlotPool Acquire ********************************/
+size_t SlotPoolAcquire(slot_pool_ty *pool, unsigned long key, void *data)
+{
+	pool_slot_ty *grown = NULL;
+	size_t slot = 0;
+
+	SPASSERT_NOT_NULL(pool);
+
+	/* take a released slot, or a new one from the array */
+	if (SLOT_POOL_NIL != pool->free_head)
+	{
+		slot = pool->free_head;
+		pool->free_head = pool->slots[slot].next;
+	}
+	else
+	{
+		if (pool->used == pool->capacity)
+		{
+			grown = (pool_slot_ty *)realloc(pool->slots,
+							2 * pool->capacity * sizeof(pool_slot_ty));
+			if (NULL == grown)
+			{
+				return SLOT_POOL_NIL;
+			}
+			pool->slots = grown;
+			pool->capacity *= 2;
+		}
+
+		slot = pool->used++;
+	}
+
+	pool->slots[slot].key = key;
+	pool->slots[slot].data = data;
+	pool->slots[slot].next = SLOT_POOL_NIL;
+	++pool->size;
+
+	return slot;
+}
+
+/*******************************************************************************
+***************************** SlotPool Release ********************************/
+void SlotPoolRelease(slot_pool_ty *pool, size_t slot)
+{
+	SPASSERT_NOT_NULL(pool);
+	assert (slot < pool->used && "SlotPoolRelease: slot was never acquired");
+
+	pool->slots[slot].next = pool->free_head;
+	pool->free_head = slot;
+	--pool->size;
+}
+
+/*******************************************************************************
+***************************** SlotChain Reset *********************************/
+void SlotChainReset(pool_chain_ty *chain)
+{
+	assert (NULL != chain && "SlotChainReset: chain is NULL");
+
+	chain->head = SLOT_POOL_NIL;
+	chain->tail = SLOT_POOL_NIL;
+}
+
+/*******************************************************************************
+***************************** SlotChain Append ********************************/
+void SlotChainAppend(slot_pool_ty *pool, pool_chain_ty *chain, size_t slot)
+{
+	SPASSERT_NOT_NULL(pool);
+	assert (NULL != chain && "SlotChainAppend: chain is NULL");
+
+	pool->slots[slot].next = SLOT_POOL_NIL;
+
+	if (SLOT_POOL_NIL == chain->tail)
+	{
+		chain->head = slot;
+	}
+	else
+	{
+		pool->slots[chain->tail].next = slot;
+	}
+
+	chain->tail = slot;
+}
+
+/*******************************************************************************
+***************************** SlotChain PopHead *******************************/
+size_t SlotChainPopHead(slot_pool_ty *pool, pool_chain_ty *chain)
+{
+	size_t slot = 0;
+
+	SPASSERT_NOT_NULL(pool);
+	assert (NULL != chain && SLOT_POOL_NIL != chain->head
+	&& "SlotChainPopHead: chain is empty");
+
+	slot = chain->head;
+	chain->head = pool->slots[slot].next;
+	if (SLOT_POOL_NIL == chain->head)
+	{
+		chain->tail = SLOT_POOL_NIL;
+	}
+
+	return slot;
+}
+
+/*******************************************************************************
+***************************** SlotChain Erase *********************************/
+void *SlotChainErase(slot_pool_ty *pool, pool_chain_ty *chain,
+					SlotPoolIsMatch is_match, const void *param)
+{
+	size_t prev = SLOT_POOL_NIL;
+	size_t slot = 0;
+
+	SPASSERT_NOT_NULL(pool);
+	assert (NULL != is_match && "SlotChainErase: Function pointer is invalid");
+
+	for (slot = chain->head; SLOT_POOL_NIL != slot; slot = pool->slots[slot].next)
+	{
+		if (is_match(pool->slots[slot].data, param))
+		{
+			/* unlink from the bucket chain */
+			if (SLOT_POOL_NIL == prev)
+			{
+				chain->head = pool->slots[slot].next;
+			}
+			else
+			{
+				pool->slots[prev].next = pool->slots[slot].next;
+			}
+
+			if (chain->tail == slot)
+			{
+				chain->tail = prev;
+			}
+
+			SlotPoolRelease(pool, slot);
+
+			return pool->slots[slot].data;
+		}
+
+		prev = slot;
+	}
+
+	return NULL;
+}
+
+/*******************************************************************************
+***************************** SlotChain Find **********************************/
+void *SlotChainFind(const slot_pool_ty *pool, const pool_chain_ty *chain,
+					SlotPoolIsMatch is_match, const void *param)
+{
+	size_t slot = 0;
+
+	SPASSERT_NOT_NULL(pool);
+	assert (NULL != is_match && "SlotChainFind: Function pointer is invalid");
+
+	for (slot = chain->head; SLOT_POOL_NIL != slot; slot = pool->slots[slot].next)
+	{
+		if (is_match(pool->slots[slot].data, param))
+		{
+			return pool->slots[slot].data;
+		}
+	}
+
+	return NULL;
+}
@@ -0,0 +1,139 @@
+/*******************************************************************************
+********************************* - SLOT POOL - ********************************
+*
+*	DESCRIPTION		Internal - element slots chained in buckets by index,
+*					shared by the calendar queue and the radix heap
+*	AUTHOR 			Liad Raz
+*	FILES			slot_pool.c slot_pool.h calendar_queue.c radix_heap.c
+*
+*******************************************************************************/
+
+#ifndef __SLOT_POOL_H__
+#define __SLOT_POOL_H__
+
+#include <stddef.h> 	/* size_t */
+
+/*******************************************************************************
+* Elements live in one array of slots and are chained per bucket by index,
+* so moving an element to another bucket, or a whole resize, only relinks
+* them and never allocates. Released slots are chained through the same
+* index and handed out again before the array grows.
+*
+* Keys are unsigned: flipping the sign bit maps a long to an unsigned long
+* keeping the order.
+*******************************************************************************/
+
+#define SLOT_POOL_NIL 			((size_t)-1)
+#define SLOT_POOL_SIGN_BIT 		(~(~0UL >> 1))
+#define SLOT_POOL_TO_UKEY(key) 	((unsigned long)(key) ^ SLOT_POOL_SIGN_BIT)
+#define SLOT_POOL_TO_KEY(ukey) 	((long)((ukey) ^ SLOT_POOL_SIGN_BIT))
+
+/******************************************************************************
+******************************** Typedefs *************************************/
+typedef struct pool_slot
+{
+	unsigned long key;
+	void *data;
+	size_t next;			/* in the bucket chain, or the free chain */
+} pool_slot_ty;
+
+typedef struct pool_chain
+{
+	size_t head;
+	size_t tail;
+} pool_chain_ty;
+
+typedef struct slot_pool
+{
+	pool_slot_ty *slots;
+	size_t capacity;
+	size_t used;			/* slots handed out at least once */
+	size_t free_head;		/* chain of released slots */
+	size_t size;			/* slots held */
+} slot_pool_ty;
+
+typedef int (*SlotPoolIsMatch)(const void *data, const void *param);
+
+/*******************************************************************************
+* DESCRIPTION	Allocates capacity slots for an empty pool.
+* RETURN	 	status => 0 SUCCESS; 1 memory allocation failed.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+int SlotPoolInit(slot_pool_ty *pool, size_t capacity);
+
+/*******************************************************************************
+* DESCRIPTION	Frees the slots. Elements are not freed.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+void SlotPoolFree(slot_pool_ty *pool);
+
+/*******************************************************************************
+* DESCRIPTION	Releases every slot at once; the array is kept.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+void SlotPoolClear(slot_pool_ty *pool);
+
+/*******************************************************************************
+* DESCRIPTION	Takes a released slot, or a new one from the array, which
+*				doubles when full, and fills it with key and data.
+* RETURN		The slot; SLOT_POOL_NIL when the array could not grow.
+* IMPORTANT		The slot is in no chain yet.
+*
+* Time Complexity 	O(1) amortized
+*******************************************************************************/
+size_t SlotPoolAcquire(slot_pool_ty *pool, unsigned long key, void *data);
+
+/*******************************************************************************
+* DESCRIPTION	Hands slot back to the pool.
+* IMPORTANT		slot must be unlinked from its chain already.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+void SlotPoolRelease(slot_pool_ty *pool, size_t slot);
+
+/*******************************************************************************
+* DESCRIPTION	Empties chain; its slots are left as they are.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+void SlotChainReset(pool_chain_ty *chain);
+
+/*******************************************************************************
+* DESCRIPTION	Links slot at the tail of chain.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+void SlotChainAppend(slot_pool_ty *pool, pool_chain_ty *chain, size_t slot);
+
+/*******************************************************************************
+* DESCRIPTION	Unlinks the head of chain.
+* RETURN		The slot unlinked, still held.
+* IMPORTANT		Undefined behavior when chain is empty.
+*
+* Time Complexity 	O(1)
+*******************************************************************************/
+size_t SlotChainPopHead(slot_pool_ty *pool, pool_chain_ty *chain);
+
+/*******************************************************************************
+* DESCRIPTION	Unlinks and releases the first slot of chain whose data
+*				matches is_match.
+* RETURN		The data of the released slot; NULL when not found.
+*
+* Time Complexity 	O(chain length)
+*******************************************************************************/
+void *SlotChainErase(slot_pool_ty *pool, pool_chain_ty *chain,
+					SlotPoolIsMatch is_match, const void *param);
+
+/*******************************************************************************
+* DESCRIPTION	Looks for the first slot of chain whose data matches is_match.
+* RETURN		Its data; NULL when not found.
+*
+* Time Complexity 	O(chain length)
+*******************************************************************************/
+void *SlotChainFind(const slot_pool_ty *pool, const pool_chain_ty *chain,
+					SlotPoolIsMatch is_match, const void *param);
+
+#endif /* __SLOT_POOL_H__ */
@@ -16,26 +16,63 @@
 #define ASSERT_NOT_NULL_IMP(ptr)								\
 		assert (NULL != ptr && "Sort LIST is not allocated");
 
+/* express levels above the dlist; enough for 4^16 elements */
+#define SKIP_MAX_LEVEL 16
+/* one of SKIP_FANOUT nodes of a level is promoted to the next level */
+#define SKIP_FANOUT 4
+
+/*	Skip list -
+	The dlist is level 0, so iterators, Next and Prev are dlist iterators.
+	Each element's dlist node is the first member of a skip node, which also
+	holds the element's express levels (next and prev per level).
+
+	level 2		head -------------------------> 30 ----------------> NULL
+	level 1		head ------------> 12 -------> 30 ------> 80 ------> NULL
+	dlist		dummy <-> 5 <-> 9 <-> 12 <-> 22 <-> 30 <-> 44 <-> 80 <-> dummy
+*/
+typedef struct skip_node skip_node_ty;
+struct skip_node
+{
+	node_ty base;			/* dlist node; must be first */
+	size_t height;			/* number of express levels */
+	skip_node_ty *links[2];	/* next, prev per level; allocated to height */
+};
+
+#define SKIP_NEXT(node, level) ((node)->links[2 * (level)])
+#define SKIP_PREV(node, level) ((node)->links[2 * (level) + 1])
 
 struct sortl
 {
     dlist_ty *dlist;
 	CmpFunc p_cmp_func;
     const void *cmp_param;
+    size_t key_offset;
+    size_t link_offset;
+    int is_keyed;
+    int is_intrusive;
+    size_t size;
+    size_t height;							/* express levels in use */
+    skip_node_ty *head[SKIP_MAX_LEVEL];		/* first node of each level */
+    unsigned long seed;						/* node heights generator */
 };
 
-typedef struct callback_params_sl
-{
-	CmpFunc cmp_func_p;
-	const void *cmp_param;
-	void *user_data;
-} callback_params_sl_ty;
-
 
 /*******************************************************************************
 ***************************** Side-Functions **********************************/
-int IsBiggerImp(const void *element_data, const void *param);
-int IsEqualImp(const void *element_data, const void *param);
+static int CmpKeysImp(const void *data1, const void *data2, const void *sort_list);
+static int CmpDataImp(const sortl_ty *sort_list, const void *data1, const void *data2);
+static sortl_itr_ty InsertAtImp(sortl_ty *sort_list, dlist_itr_ty where, void *data);
+static sortl_itr_ty ItrOfImp(const sortl_ty *sort_list, dlist_itr_ty dlist_itr);
+
+static sortl_itr_ty SkipInsertImp(sortl_ty *sort_list, void *data);
+static sortl_itr_ty SkipLinkImp(sortl_ty *sort_list, skip_node_ty *node, void *data);
+static skip_node_ty *SkipSearchImp(const sortl_ty *sort_list, const void *data,
+								int is_upper, skip_node_ty **update);
+static dlist_itr_ty SkipLevel0Imp(const sortl_ty *sort_list, skip_node_ty *from,
+								const void *data, int is_upper);
+static void SkipUnlinkImp(sortl_ty *sort_list, skip_node_ty *node);
+static void SkipRebuildImp(sortl_ty *sort_list);
+static size_t SkipRandomHeightImp(sortl_ty *sort_list);
 
 /*******************************************************************************
 ***************************** SortL Create ************************************/
@@ -67,6 +104,49 @@ sortl_ty *SortLCreate(const CmpFunc cmp_func_p, const void *cmp_param)
 	/* init slist fields */
 	sort_list->p_cmp_func = cmp_func_p;
 	sort_list->cmp_param = cmp_param;
+	sort_list->key_offset = 0;
+	sort_list->link_offset = 0;
+	sort_list->is_keyed = 0;
+	sort_list->is_intrusive = 0;
+	sort_list->size = 0;
+	sort_list->height = 0;
+	sort_list->seed = 1;
+
+	return sort_list;
+}
+
+/*******************************************************************************
+***************************** SortL CreateKeyed *******************************/
+sortl_ty *SortLCreateKeyed(size_t key_offset)
+{
+	sortl_ty *sort_list = SortLCreate(CmpKeysImp, NULL);
+
+	if (NULL == sort_list)
+	{
+		return NULL;
+	}
+
+	/* the key compare sits in the CmpFunc slot; it receives the list as param */
+	sort_list->cmp_param = sort_list;
+	sort_list->key_offset = key_offset;
+	sort_list->is_keyed = 1;
+
+	return sort_list;
+}
+
+/*******************************************************************************
+***************************** SortL CreateIntrusive ***************************/
+sortl_ty *SortLCreateIntrusive(size_t key_offset, size_t link_offset)
+{
+	sortl_ty *sort_list = SortLCreateKeyed(key_offset);
+
+	if (NULL == sort_list)
+	{
+		return NULL;
+	}
+
+	sort_list->link_offset = link_offset;
+	sort_list->is_intrusive = 1;
 
 	return sort_list;
 }
@@ -75,30 +155,62 @@ sortl_ty *SortLCreate(const CmpFunc cmp_func_p, const void *cmp_param)
 ***************************** SortL Insert ************************************/
 sortl_itr_ty SortLInsert(sortl_ty *sort_list, void *data)
 {
-	callback_params_sl_ty callback_params = {NULL};
-	IsMatchFunc is_bigger_p = IsBiggerImp;
-	sortl_itr_ty begin = {NULL};
-	sortl_itr_ty end = {NULL};
-	sortl_itr_ty return_itr = {NULL};
+	dlist_itr_ty where = {NULL};
 
     /* debug only */
 	ASSERT_NOT_NULL_IMP(sort_list);
 
-	/* fill cmp_objects_package fields with comparison information */
-	callback_params.cmp_func_p = sort_list->p_cmp_func;
-	callback_params.cmp_param = sort_list->cmp_param;
-	callback_params.user_data = data;
+	/* descend the express levels; O(log n) */
+	if (!sort_list->is_intrusive)
+	{
+		return SkipInsertImp(sort_list, data);
+	}
+
+	/* intrusive nodes have no express levels: find the first bigger key inline */
+	where = DListFindKey(DListBegin(sort_list->dlist), DListEnd(sort_list->dlist),
+						sort_list->key_offset,
+						*(dlist_key_ty *)((char *)data + sort_list->key_offset), 1);
+
+	return InsertAtImp(sort_list, where, data);
+}
+
+
+/*******************************************************************************
+***************************** SortL InsertHint ********************************/
+sortl_itr_ty SortLInsertHint(sortl_ty *sort_list, sortl_itr_ty hint, void *data)
+{
+	dlist_itr_ty where = hint.dlist_itr;
+	dlist_itr_ty begin = {NULL};
+	dlist_itr_ty end = {NULL};
+
+	ASSERT_NOT_NULL_IMP(sort_list);
+	assert (hint.dlist_itr.dlist == sort_list->dlist
+	&& "InsertHint: hint refers to another list");
+
+	/* the express levels already give a logarithmic search */
+	if (!sort_list->is_intrusive)
+	{
+		return SkipInsertImp(sort_list, data);
+	}
 
-	begin = SortLBegin(sort_list);
-	end = SortLEnd(sort_list);
+	begin = DListBegin(sort_list->dlist);
+	end = DListEnd(sort_list->dlist);
 
-	/* find an element which its data is bigger than the data provided by the user. */
-	return_itr = SortLFindIf(begin, end, is_bigger_p, &callback_params);
+	/* step back while the previous element is bigger than data */
+	while (!DListIsSameIter(where, begin) &&
+			0 < CmpDataImp(sort_list, DListGetData(DListPrev(where)), data))
+	{
+		where = DListPrev(where);
+	}
 
-	/* insert new node in the returned location */
-	return_itr.dlist_itr = DListInsert(return_itr.dlist_itr, data);
+	/* step forward over smaller and equal elements, equals keep FIFO order */
+	while (!DListIsSameIter(where, end) &&
+			0 >= CmpDataImp(sort_list, DListGetData(where), data))
+	{
+		where = DListNext(where);
+	}
 
-	return return_itr;
+	return InsertAtImp(sort_list, where, data);
 }
 
 
@@ -116,7 +228,16 @@ void SortLDestroy(sortl_ty *sort_list)
 {
 	ASSERT_NOT_NULL_IMP(sort_list);
 
-	/* free dlist with DListDestroy */
+	/* embedded nodes belong to the elements, detach them before destroy */
+	if (sort_list->is_intrusive)
+	{
+		while (!DListIsEmpty(sort_list->dlist))
+		{
+			DListUnlink(DListBegin(sort_list->dlist));
+		}
+	}
+
+	/* free dlist with DListDestroy; a skip node starts with its dlist node */
 	DListDestroy(sort_list->dlist);
 
 	/* break sortl_ty fields */
@@ -134,20 +255,16 @@ size_t SortLCount(const sortl_ty *sort_list)
 {
 	ASSERT_NOT_NULL_IMP(sort_list);
 
-	return DListCount(sort_list->dlist);
+	return sort_list->size;
 }
 
 /*******************************************************************************
 ***************************** SortL Begin *************************************/
 sortl_itr_ty SortLBegin(sortl_ty *sort_list)
 {
-	sortl_itr_ty begin = {NULL};
-
 	ASSERT_NOT_NULL_IMP(sort_list);
 
-	begin.dlist_itr = DListBegin(sort_list->dlist);
-
-	return begin;
+	return ItrOfImp(sort_list, DListBegin(sort_list->dlist));
 }
 
 
@@ -156,13 +273,9 @@ sortl_itr_ty SortLBegin(sortl_ty *sort_list)
 
 sortl_itr_ty SortLEnd(sortl_ty *sort_list)
 {
-	sortl_itr_ty end = {NULL};
-
 	ASSERT_NOT_NULL_IMP(sort_list);
 
-	end.dlist_itr = DListEnd(sort_list->dlist);
-
-	return end;
+	return ItrOfImp(sort_list, DListEnd(sort_list->dlist));
 }
 
 
@@ -170,22 +283,18 @@ sortl_itr_ty SortLEnd(sortl_ty *sort_list)
 ***************************** SortL Next **************************************/
 sortl_itr_ty SortLNext(sortl_itr_ty iter)
 {
-	sortl_itr_ty next = {NULL};
-
-	next.dlist_itr = DListNext(iter.dlist_itr);
+	iter.dlist_itr = DListNext(iter.dlist_itr);
 
-	return next;
+	return iter;
 }
 
 /*******************************************************************************
 ***************************** SortL Prev **************************************/
 sortl_itr_ty SortLPrev(sortl_itr_ty iter)
 {
-	sortl_itr_ty prev = {NULL};
-
-	prev.dlist_itr = DListPrev(iter.dlist_itr);
+	iter.dlist_itr = DListPrev(iter.dlist_itr);
 
-	return prev;
+	return iter;
 }
 
 /*******************************************************************************
@@ -200,48 +309,62 @@ int SortLIsSameIter(sortl_itr_ty iter1, sortl_itr_ty iter2)
 ***************************** SortL Merge *************************************/
 void SortLMerge(sortl_ty *dest, sortl_ty *donor)
 {
-	callback_params_sl_ty callb_params = {NULL};
-
-	sortl_itr_ty dest_where = {NULL};
-	sortl_itr_ty donor_from = {NULL};
-	sortl_itr_ty donor_to = {NULL};
+	dlist_itr_ty dest_where = {NULL};
+	dlist_itr_ty donor_from = {NULL};
+	dlist_itr_ty donor_to = {NULL};
 
 	ASSERT_NOT_NULL_IMP(dest);
 	ASSERT_NOT_NULL_IMP(donor);
+	assert (dest->is_intrusive == donor->is_intrusive
+	&& "SortLMerge: lists have different layouts");
 
-	dest_where = SortLBegin(dest);
-	donor_from = SortLBegin(donor);
-
-	/* fill cmp_objects_package fields with dest's comparison information */
-	callb_params.cmp_func_p = dest->p_cmp_func;
-	callb_params.cmp_param = dest->cmp_param;
-	callb_params.user_data = SortLGetData(donor_from);
+	dest_where = DListBegin(dest->dlist);
 
-	/* traverse dest list until the end */
-	while(!SortLIsEmpty(donor))
+	/* traverse dest list until donor is empty */
+	while (!DListIsEmpty(donor->dlist))
 	{
+		donor_from = DListBegin(donor->dlist);
+
 		/* in dest traverse 'where' until is bigger than 'from' donor element */
-		dest_where = SortLFindIf(dest_where, SortLEnd(dest), IsBiggerImp, &callb_params);
-		/* change param comparison to dest_where value */
-		callb_params.user_data = SortLGetData(dest_where);
+		while (!DListIsSameIter(dest_where, DListEnd(dest->dlist)) &&
+			0 >= CmpDataImp(dest, DListGetData(dest_where), DListGetData(donor_from)))
+		{
+			dest_where = DListNext(dest_where);
+		}
 
 		/* In case where got the the end of dest, the rest of donor will be copied to dest */
-		if (SortLIsSameIter(dest_where, SortLEnd(dest)))
+		if (DListIsSameIter(dest_where, DListEnd(dest->dlist)))
 		{
-			donor_to = SortLEnd(donor);
+			donor_to = DListEnd(donor->dlist);
 		}
 		else
 		{
 			/* in donor traverse 'to' until is bigger than 'where' dest element */
-			donor_to = SortLFindIf(donor_from, SortLEnd(donor), IsBiggerImp, &callb_params);
-			/* change param comparison to donor_to value */
-			callb_params.user_data = SortLGetData(donor_to);
+			donor_to = DListNext(donor_from);
+			while (!DListIsSameIter(donor_to, DListEnd(donor->dlist)) &&
+				0 >= CmpDataImp(dest, DListGetData(donor_to), DListGetData(dest_where)))
+			{
+				donor_to = DListNext(donor_to);
+			}
 		}
 
-		/* copy and remove range of donor elements to dest list */
-		DListSplice(dest_where.dlist_itr, donor_from.dlist_itr, donor_to.dlist_itr);
+		/* move range of donor nodes to dest list */
+		DListSplice(dest_where, donor_from, donor_to);
+	}
+
+	dest->size += donor->size;
+	donor->size = 0;
 
-		donor_from = donor_to;
+	/* relink the express levels of the merged list in one pass */
+	if (!dest->is_intrusive)
+	{
+		if (donor->height > dest->height)
+		{
+			dest->height = donor->height;
+		}
+		donor->height = 0;
+
+		SkipRebuildImp(dest);
 	}
 }
 
@@ -256,22 +379,29 @@ donor	2	--	3	--	22	--	36	--	77	--	600	--	END
 ***************************** SortL Find **************************************/
 sortl_itr_ty SortLFind(const sortl_ty *sortl, const void *data)
 {
-	callback_params_sl_ty params = {NULL};
-	IsMatchFunc is_equal_p = IsEqualImp;
-	sortl_itr_ty ret_itr = {NULL};
+	skip_node_ty *from = NULL;
+	dlist_itr_ty found = {NULL};
+	dlist_itr_ty end = {NULL};
 
 	ASSERT_NOT_NULL_IMP(sortl);
 
-	/* fill callback_params_sl_ty fields with comparison information */
-	params.cmp_func_p = sortl->p_cmp_func;
-	params.cmp_param = sortl->cmp_param;
-	params.user_data = (void *)data;
+	end = DListEnd(sortl->dlist);
 
-	/* find an element which its data equals the data provided by the user */
-	ret_itr.dlist_itr = DListFind(DListBegin(sortl->dlist), DListEnd(sortl->dlist),
-								is_equal_p, &params);
+	/* first element which is not smaller than data */
+	if (!sortl->is_intrusive)
+	{
+		from = SkipSearchImp(sortl, data, 0, NULL);
+	}
+	found = SkipLevel0Imp(sortl, from, data, 0);
 
-	return ret_itr;
+	/* when it is bigger, data does not exist in list */
+	if (!DListIsSameIter(found, end) &&
+		0 != CmpDataImp(sortl, DListGetData(found), data))
+	{
+		found = end;
+	}
+
+	return ItrOfImp(sortl, found);
 }
 
 /*******************************************************************************
@@ -290,11 +420,75 @@ int SortLIsEmpty(const sortl_ty *sort_list)
 
 sortl_itr_ty SortLRemove(sortl_itr_ty iter)
 {
-	sortl_itr_ty ret_itr = {NULL};
+	node_ty *to_free = iter.dlist_itr.to_node;
 
-	ret_itr.dlist_itr = DListRemove(iter.dlist_itr);
+	ASSERT_NOT_NULL_IMP(iter.sortl);
+	assert (!iter.sortl->is_intrusive
+	&& "SortLRemove: intrusive nodes are removed with SortLUnlink");
 
-	return ret_itr;
+	/* detach the express levels, then the dlist node */
+	SkipUnlinkImp(iter.sortl, (skip_node_ty *)to_free);
+	iter.dlist_itr = DListUnlink(iter.dlist_itr);
+	--iter.sortl->size;
+
+	free(to_free);
+
+	return iter;
+}
+
+
+/*******************************************************************************
+***************************** SortL Unlink ************************************/
+
+sortl_itr_ty SortLUnlink(sortl_itr_ty iter)
+{
+	ASSERT_NOT_NULL_IMP(iter.sortl);
+	assert (iter.sortl->is_intrusive && "SortLUnlink: list is not intrusive");
+
+	iter.dlist_itr = DListUnlink(iter.dlist_itr);
+	--iter.sortl->size;
+
+	return iter;
+}
+
+
+/*******************************************************************************
+***************************** SortL Reposition ********************************/
+
+sortl_itr_ty SortLReposition(sortl_itr_ty iter)
+{
+	sortl_ty *sort_list = iter.sortl;
+	void *data = NULL;
+
+	ASSERT_NOT_NULL_IMP(sort_list);
+
+	data = DListGetData(iter.dlist_itr);
+
+	/* an embedded node is searched for from where it was */
+	if (sort_list->is_intrusive)
+	{
+		return SortLInsertHint(sort_list, SortLUnlink(iter), data);
+	}
+
+	/* detach the skip node as SortLRemove does, and link it again */
+	SkipUnlinkImp(sort_list, (skip_node_ty *)iter.dlist_itr.to_node);
+	DListUnlink(iter.dlist_itr);
+	--sort_list->size;
+
+	return SkipLinkImp(sort_list, (skip_node_ty *)iter.dlist_itr.to_node, data);
+}
+
+
+/*******************************************************************************
+***************************** SortL ItrOf *************************************/
+
+sortl_itr_ty SortLItrOf(sortl_ty *list, void *data)
+{
+	ASSERT_NOT_NULL_IMP(list);
+	assert (list->is_intrusive && "SortLItrOf: list is not intrusive");
+
+	return ItrOfImp(list, DListItrOf(list->dlist,
+							(node_ty *)((char *)data + list->link_offset)));
 }
 
 
@@ -302,50 +496,273 @@ sortl_itr_ty SortLRemove(sortl_itr_ty iter)
 ***************************** SortL FindIf ************************************/
 sortl_itr_ty SortLFindIf(sortl_itr_ty from, sortl_itr_ty to, IsMatchFunc is_match_func, void *param)
 {
-	sortl_itr_ty ret_itr = {NULL};
-
 	assert (from.dlist_itr.dlist == to.dlist_itr.dlist
 	&& "FindIf: Iterators refer to the same list");
 	assert (NULL != is_match_func
 	&& "FindIf: Function pointer is invalid");
 
 	/* find matched element; in case not found get the end of range */
-	ret_itr.dlist_itr = DListFind(from.dlist_itr, to.dlist_itr, is_match_func, param);
+	from.dlist_itr = DListFind(from.dlist_itr, to.dlist_itr, is_match_func, param);
 
-	return ret_itr;
+	return from;
 }
 
 
 /*******************************************************************************
 ***************************** Side Functions **********************************/
-int IsBiggerImp(const void *element_data, const void *param)
+static int CmpKeysImp(const void *data1, const void *data2, const void *sort_list)
+{
+	size_t offset = ((const sortl_ty *)sort_list)->key_offset;
+	dlist_key_ty key1 = *(const dlist_key_ty *)((const char *)data1 + offset);
+	dlist_key_ty key2 = *(const dlist_key_ty *)((const char *)data2 + offset);
+
+	return ((key1 > key2) - (key1 < key2));
+}
+
+static int CmpDataImp(const sortl_ty *sort_list, const void *data1, const void *data2)
+{
+	/* keyed lists compare inline, others through the user CmpFunc */
+	if (sort_list->is_keyed)
+	{
+		return CmpKeysImp(data1, data2, sort_list);
+	}
+
+	return sort_list->p_cmp_func(data1, data2, sort_list->cmp_param);
+}
+
+static sortl_itr_ty InsertAtImp(sortl_ty *sort_list, dlist_itr_ty where, void *data)
+{
+	/* intrusive list links the node embedded in data */
+	where = DListLink(where, (node_ty *)((char *)data + sort_list->link_offset), data);
+	++sort_list->size;
+
+	return ItrOfImp(sort_list, where);
+}
+
+static sortl_itr_ty ItrOfImp(const sortl_ty *sort_list, dlist_itr_ty dlist_itr)
+{
+	sortl_itr_ty ret_itr = {{NULL}, NULL};
+
+	ret_itr.dlist_itr = dlist_itr;
+	ret_itr.sortl = (sortl_ty *)sort_list;
+
+	return ret_itr;
+}
+
+
+/*******************************************************************************
+***************************** Skip List ***************************************/
+static sortl_itr_ty SkipInsertImp(sortl_ty *sort_list, void *data)
 {
-	int is_bigger = 0;
+	skip_node_ty *new_node = NULL;
+	size_t height = SkipRandomHeightImp(sort_list);
 
-	/* convert 'param' to callback_params_sl_ty data type */
-	callback_params_sl_ty callb_params = *(callback_params_sl_ty *)param;
+	/* one allocation for the dlist node and all express levels */
+	new_node = (skip_node_ty *)malloc(sizeof(skip_node_ty) +
+				((0 < height) ? (2 * height - 2) : 0) * sizeof(skip_node_ty *));
 
-	/* determine if data's node element is bigger than param value */
-	is_bigger = callb_params.cmp_func_p(element_data, callb_params.user_data,
-										callb_params.cmp_param);
+	/* check allocation failure */
+	if (NULL == new_node)
+	{
+		return SortLEnd(sort_list);
+	}
+
+	new_node->height = height;
 
-	return (is_bigger > 0);
+	return SkipLinkImp(sort_list, new_node, data);
 }
 
-int IsEqualImp(const void *element_data, const void *param)
+/* links a detached node, of any height, at the position of data */
+static sortl_itr_ty SkipLinkImp(sortl_ty *sort_list, skip_node_ty *new_node, void *data)
 {
-	int is_equal = 0;
+	skip_node_ty *update[SKIP_MAX_LEVEL] = {NULL};
+	skip_node_ty *from = NULL;
+	dlist_itr_ty where = {NULL};
+	size_t height = new_node->height;
+	size_t level = 0;
+
+	/* predecessors on each level; equal elements stay before data (FIFO) */
+	from = SkipSearchImp(sort_list, data, 1, update);
+	where = SkipLevel0Imp(sort_list, from, data, 1);
+
+	/* levels which were not in use start empty */
+	for (level = sort_list->height; level < height; ++level)
+	{
+		update[level] = NULL;
+		sort_list->head[level] = NULL;
+	}
+	if (height > sort_list->height)
+	{
+		sort_list->height = height;
+	}
+
+	/* splice new_node after its predecessor on each of its levels */
+	for (level = 0; level < height; ++level)
+	{
+		SKIP_PREV(new_node, level) = update[level];
+
+		if (NULL == update[level])
+		{
+			SKIP_NEXT(new_node, level) = sort_list->head[level];
+			sort_list->head[level] = new_node;
+		}
+		else
+		{
+			SKIP_NEXT(new_node, level) = SKIP_NEXT(update[level], level);
+			SKIP_NEXT(update[level], level) = new_node;
+		}
 
-	/* convert 'param' to callback_params_sl_ty data type */
-	callback_params_sl_ty callb_params = *(callback_params_sl_ty *)param;
+		if (NULL != SKIP_NEXT(new_node, level))
+		{
+			SKIP_PREV(SKIP_NEXT(new_node, level), level) = new_node;
+		}
+	}
 
-	/* determine if data's node element equals to param value */
-	is_equal = callb_params.cmp_func_p(element_data, callb_params.user_data,
-										callb_params.cmp_param);
+	where = DListLink(where, &new_node->base, data);
+	++sort_list->size;
 
-	return (is_equal == 0);
+	return ItrOfImp(sort_list, where);
 }
 
+/* descend from the top level, moving right while the next node is smaller
+   (or equal when is_upper). Returns the last node passed, NULL for the head.
+   update, when not NULL, receives the last node passed on each level. */
+static skip_node_ty *SkipSearchImp(const sortl_ty *sort_list, const void *data,
+								int is_upper, skip_node_ty **update)
+{
+	skip_node_ty *runner = NULL;
+	skip_node_ty *next = NULL;
+	size_t level = sort_list->height;
+	int cmp_res = 0;
 
+	while (0 < level)
+	{
+		--level;
+		next = (NULL == runner) ? sort_list->head[level] : SKIP_NEXT(runner, level);
 
+		while (NULL != next)
+		{
+			cmp_res = CmpDataImp(sort_list, next->base.data, data);
+			if (0 < cmp_res || (0 == cmp_res && !is_upper))
+			{
+				break;
+			}
+
+			runner = next;
+			next = SKIP_NEXT(runner, level);
+		}
 
+		if (NULL != update)
+		{
+			update[level] = runner;
+		}
+	}
+
+	return runner;
+}
+
+/* finish the search on the dlist, starting after 'from' (or at the beginning).
+   Returns the first element bigger than data (is_upper) or not smaller. */
+static dlist_itr_ty SkipLevel0Imp(const sortl_ty *sort_list, skip_node_ty *from,
+								const void *data, int is_upper)
+{
+	dlist_itr_ty runner = DListBegin(sort_list->dlist);
+	dlist_itr_ty end = DListEnd(sort_list->dlist);
+	int cmp_res = 0;
+
+	if (NULL != from)
+	{
+		runner.to_node = &from->base;
+		runner = DListNext(runner);
+	}
+
+	while (!DListIsSameIter(runner, end))
+	{
+		cmp_res = CmpDataImp(sort_list, DListGetData(runner), data);
+		if (0 < cmp_res || (0 == cmp_res && !is_upper))
+		{
+			break;
+		}
+
+		runner = DListNext(runner);
+	}
+
+	return runner;
+}
+
+static void SkipUnlinkImp(sortl_ty *sort_list, skip_node_ty *node)
+{
+	size_t level = 0;
+
+	for (level = 0; level < node->height; ++level)
+	{
+		if (NULL == SKIP_PREV(node, level))
+		{
+			sort_list->head[level] = SKIP_NEXT(node, level);
+		}
+		else
+		{
+			SKIP_NEXT(SKIP_PREV(node, level), level) = SKIP_NEXT(node, level);
+		}
+
+		if (NULL != SKIP_NEXT(node, level))
+		{
+			SKIP_PREV(SKIP_NEXT(node, level), level) = SKIP_PREV(node, level);
+		}
+	}
+}
+
+/* relink all express levels in dlist order; O(number_of_elements) */
+static void SkipRebuildImp(sortl_ty *sort_list)
+{
+	skip_node_ty *last[SKIP_MAX_LEVEL] = {NULL};
+	skip_node_ty *node = NULL;
+	dlist_itr_ty runner = DListBegin(sort_list->dlist);
+	dlist_itr_ty end = DListEnd(sort_list->dlist);
+	size_t level = 0;
+
+	for (level = 0; level < sort_list->height; ++level)
+	{
+		sort_list->head[level] = NULL;
+	}
+
+	while (!DListIsSameIter(runner, end))
+	{
+		node = (skip_node_ty *)runner.to_node;
+
+		for (level = 0; level < node->height; ++level)
+		{
+			SKIP_PREV(node, level) = last[level];
+			SKIP_NEXT(node, level) = NULL;
+
+			if (NULL == last[level])
+			{
+				sort_list->head[level] = node;
+			}
+			else
+			{
+				SKIP_NEXT(last[level], level) = node;
+			}
+
+			last[level] = node;
+		}
+
+		runner = DListNext(runner);
+	}
+}
+
+/* geometric height: reaches level k with probability 1 / SKIP_FANOUT^k */
+static size_t SkipRandomHeightImp(sortl_ty *sort_list)
+{
+	size_t height = 0;
+
+	do
+	{
+		/* 32 bit LCG (Numerical Recipes); bits 16..30 are the random ones */
+		sort_list->seed = (sort_list->seed * 1664525UL + 1013904223UL) & 0xFFFFFFFFUL;
+	}
+	while (0 == ((sort_list->seed >> 16) % SKIP_FANOUT) &&
+			SKIP_MAX_LEVEL > ++height);
+
+	return height;
+}
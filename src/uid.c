@@ -6,20 +6,33 @@
 *
 *******************************************************************************/
 
+#include <pthread.h>	/* pthread_once, pthread_atfork */
+
 #include "utilities.h"
 #include "uid.h"
 
+/* shared by all threads; only touched through atomic builtins */
+static size_t uid_counter = 0;
+/* cached process id, set once and again in a forked child */
+static pid_t uid_pid = 0;
+static pthread_once_t uid_init_once = PTHREAD_ONCE_INIT;
+
+static void InitImp(void);
+static void RefreshPidImp(void);
+
 
 /*******************************************************************************
 *********************************** Impl **************************************/
 uid_ty UIDGenerate(void)
 {
 	uid_ty new_uid = {0};
-	static size_t counter = 0;
 
-	new_uid.counter = counter + 1;
+	pthread_once(&uid_init_once, InitImp);
+
+	/* every caller gets its own number, no lock taken */
+	new_uid.counter = __sync_add_and_fetch(&uid_counter, 1);
 	new_uid.time = time(NULL);
-	new_uid.pid = getpid();
+	new_uid.pid = uid_pid;
 
 	return new_uid;
 }
@@ -36,3 +49,20 @@ int UIDIsBad(const uid_ty uid)
 	return ((BAD_UID.counter == uid.counter) && (BAD_UID.time == uid.time) &&
 	         (BAD_UID.pid == uid.pid));
 }
+
+
+/*******************************************************************************
+***************************** Side Functions **********************************/
+static void InitImp(void)
+{
+	RefreshPidImp();
+
+	/* the child of fork has a new pid; it keeps the counter, which is fine
+		since the pid tells the two processes apart */
+	pthread_atfork(NULL, NULL, RefreshPidImp);
+}
+
+static void RefreshPidImp(void)
+{
+	uid_pid = getpid();
+}
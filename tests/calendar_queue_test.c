@@ -0,0 +1,367 @@
+/*******************************************************************************
+****************************** - CALENDAR QUEUE - ******************************
+*
+*	DESCRIPTION		Tests
+*	AUTHOR          Liad Raz
+*
+*******************************************************************************/
+
+#include <stdio.h>		/* printf, puts */
+#include <stdlib.h>		/* abort, rand, srand */
+#include <stddef.h>		/* size_t */
+
+#include "utilities.h"
+#include "calendar_queue.h"
+
+#define NUM_ELEMENTS 1000
+
+typedef struct timer
+{
+	long next_run;
+	long interval;
+	int id;
+} timer_ty;
+
+void TestCQueueCreate(void);
+void TestCQueueHold(void);
+void TestCQueueFifo(void);
+void TestCQueueEarlierKey(void);
+void TestCQueueResize(void);
+void TestCQueueErase(void);
+
+static int IsSameAddress(const void *element_data, const void *param);
+
+int main(void)
+{
+	PRINT_MSG(\n--- Tests Calendar Queue ---\n);
+
+	TestCQueueCreate();
+	TestCQueueHold();
+	TestCQueueFifo();
+	TestCQueueEarlierKey();
+	TestCQueueResize();
+	TestCQueueErase();
+
+	return 0;
+}
+
+/*-------------------------------Test Function-------------------------------*/
+
+void TestCQueueCreate(void)
+{
+	cqueue_ty *cqueue = CQueueCreate();
+	cqueue_stats_ty stats = {0};
+
+	if (NULL == cqueue)
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Create: FAILED);
+		DEFAULT;
+		abort();
+	}
+
+	CQueueGetStats(cqueue, &stats);
+
+	if (CQueueIsEmpty(cqueue) && 0 == CQueueSize(cqueue) &&
+		NULL == CQueuePeek(cqueue) && 0 == stats.resizes && 0 != stats.num_buckets)
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Create: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Create: FAILED);
+		DEFAULT;
+	}
+
+	CQueueDestroy(cqueue);
+}
+
+void TestCQueueHold(void)
+{
+	static timer_ty timers[NUM_ELEMENTS];
+	cqueue_ty *cqueue = CQueueCreate();
+	timer_ty *current = NULL;
+	long prev = -1000;
+	int is_sorted = 1;
+	size_t i = 0;
+
+	/* negative keys too; more than the initial capacity */
+	srand(50);
+	for (i = 0; i < NUM_ELEMENTS; ++i)
+	{
+		timers[i].next_run = (long)(rand() % 2000) - 900;
+		timers[i].interval = 1 + rand() % 5000;
+		CQueuePush(cqueue, timers[i].next_run, &timers[i]);
+	}
+
+	/* pop the earliest and push it back later, like a scheduler */
+	for (i = 0; i < 20 * NUM_ELEMENTS; ++i)
+	{
+		current = CQueuePeek(cqueue);
+		if (current->next_run < prev)
+		{
+			is_sorted = 0;
+		}
+		prev = current->next_run;
+		CQueuePop(cqueue);
+
+		current->next_run += current->interval;
+		CQueuePush(cqueue, current->next_run, current);
+	}
+
+	if (is_sorted && NUM_ELEMENTS == CQueueSize(cqueue))
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Hold Order: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Hold Order: FAILED);
+		DEFAULT;
+	}
+
+	CQueueDestroy(cqueue);
+}
+
+void TestCQueueFifo(void)
+{
+	static timer_ty timers[100];
+	cqueue_ty *cqueue = CQueueCreate();
+	timer_ty *current = NULL;
+	int next_id = 0;
+	int is_fifo = 1;
+	int i = 0;
+
+	/* enough equal keys to resize the queue in between */
+	for (i = 0; i < 100; ++i)
+	{
+		timers[i].id = i;
+		timers[i].next_run = (0 == i % 2) ? 40 : 7 * i;
+		CQueuePush(cqueue, timers[i].next_run, &timers[i]);
+	}
+
+	/* the keys 40 come out in insertion order */
+	for (i = 0; i < 100; ++i)
+	{
+		current = CQueuePeek(cqueue);
+		if (40 == current->next_run)
+		{
+			is_fifo = is_fifo && (next_id == current->id);
+			next_id += 2;
+		}
+		CQueuePop(cqueue);
+	}
+
+	for (i = 0; i < 100; i += 2)
+	{
+		CQueuePush(cqueue, 40, &timers[i]);
+	}
+	for (i = 0; i < 100 && is_fifo; i += 2)
+	{
+		if (CQueuePeek(cqueue) != &timers[i])
+		{
+			is_fifo = 0;
+		}
+		CQueuePop(cqueue);
+	}
+
+	if (is_fifo && 100 == next_id && CQueueIsEmpty(cqueue))
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Equal Keys FIFO: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Equal Keys FIFO: FAILED);
+		DEFAULT;
+	}
+
+	CQueueDestroy(cqueue);
+}
+
+void TestCQueueEarlierKey(void)
+{
+	long keys[] = {100, 200, 300, 400, 5, 250};
+	cqueue_ty *cqueue = CQueueCreate();
+	size_t counter = 0;
+
+	CQueuePush(cqueue, keys[0], &keys[0]);
+	CQueuePush(cqueue, keys[1], &keys[1]);
+	CQueuePush(cqueue, keys[2], &keys[2]);
+	CQueuePush(cqueue, keys[3], &keys[3]);
+	CQueuePop(cqueue);
+	CQueuePop(cqueue);
+
+	/* the scan already passed 200; a smaller key moves it back */
+	CQueuePush(cqueue, keys[4], &keys[4]);
+	if (&keys[4] == CQueuePeek(cqueue))
+	{ ++counter; }
+
+	CQueuePop(cqueue);
+	CQueuePush(cqueue, keys[5], &keys[5]);
+	if (&keys[5] == CQueuePeek(cqueue))
+	{ ++counter; }
+
+	CQueuePop(cqueue);
+	if (&keys[2] == CQueuePeek(cqueue) && 2 == CQueueSize(cqueue))
+	{ ++counter; }
+
+	/* one key far in the future is found by a direct search */
+	CQueuePop(cqueue);
+	CQueuePop(cqueue);
+	CQueuePush(cqueue, 3000000, &keys[0]);
+	CQueuePush(cqueue, -3000000, &keys[1]);
+	if (&keys[1] == CQueuePeek(cqueue))
+	{ ++counter; }
+	CQueuePop(cqueue);
+	if (&keys[0] == CQueuePeek(cqueue))
+	{ ++counter; }
+
+	if (5 == counter)
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Earlier Key: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Earlier Key: FAILED);
+		DEFAULT;
+	}
+
+	CQueueDestroy(cqueue);
+}
+
+void TestCQueueResize(void)
+{
+	static timer_ty timers[NUM_ELEMENTS];
+	cqueue_ty *cqueue = CQueueCreate();
+	cqueue_stats_ty first = {0};
+	cqueue_stats_ty stats = {0};
+	size_t counter = 0;
+	size_t i = 0;
+
+	CQueueGetStats(cqueue, &first);
+
+	/* keys 1000 apart: the width follows their separation */
+	for (i = 0; i < NUM_ELEMENTS; ++i)
+	{
+		timers[i].next_run = (long)(i * 1000);
+		CQueuePush(cqueue, timers[i].next_run, &timers[i]);
+	}
+
+	CQueueGetStats(cqueue, &stats);
+	if (0 < stats.grows && 0 == stats.shrinks &&
+		stats.grows == stats.resizes && stats.num_buckets > first.num_buckets)
+	{ ++counter; }
+
+	if (1000 <= stats.width && 3000 >= stats.width &&
+		stats.num_buckets * 2 >= NUM_ELEMENTS && 0 < stats.last_resize_size)
+	{ ++counter; }
+
+	for (i = 0; i < NUM_ELEMENTS; ++i)
+	{
+		if (&timers[i] != CQueuePeek(cqueue))
+		{
+			break;
+		}
+		CQueuePop(cqueue);
+	}
+
+	/* draining shrinks back to the initial number of buckets */
+	CQueueGetStats(cqueue, &stats);
+	if (NUM_ELEMENTS == i && 0 < stats.shrinks &&
+		stats.grows + stats.shrinks == stats.resizes &&
+		first.num_buckets == stats.num_buckets)
+	{ ++counter; }
+
+	if (3 == counter)
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Resize Stats: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Resize Stats: FAILED);
+		DEFAULT;
+	}
+
+	CQueueDestroy(cqueue);
+}
+
+void TestCQueueErase(void)
+{
+	long keys[] = {50, 10, 40, 20, 30, 60, 5, 30};
+	long not_exist = 0;
+	cqueue_ty *cqueue = CQueueCreate();
+	size_t counter = 0;
+	size_t i = 0;
+
+	for (i = 0; i < SIZEOF_ARRAY(keys); ++i)
+	{
+		CQueuePush(cqueue, keys[i], &keys[i]);
+	}
+
+	/* erase the minimum and an inner element; released slots are reused */
+	if (&keys[6] == CQueueErase(cqueue, IsSameAddress, &keys[6]) &&
+		&keys[4] == CQueueErase(cqueue, IsSameAddress, &keys[4]) &&
+		0 == CQueuePush(cqueue, keys[4], &keys[4]))
+	{ ++counter; }
+
+	if (NULL == CQueueErase(cqueue, IsSameAddress, &not_exist))
+	{ ++counter; }
+
+	/* find leaves the queue as is */
+	if (&keys[2] == CQueueFind(cqueue, IsSameAddress, &keys[2]) &&
+		NULL == CQueueFind(cqueue, IsSameAddress, &keys[6]))
+	{ ++counter; }
+
+	if (7 == CQueueSize(cqueue) && &keys[1] == CQueuePeek(cqueue))
+	{ ++counter; }
+
+	/* the key leads to the day of the element */
+	if (&keys[0] == CQueueEraseKey(cqueue, keys[0], IsSameAddress, &keys[0]) &&
+		NULL == CQueueEraseKey(cqueue, keys[0], IsSameAddress, &keys[0]) &&
+		6 == CQueueSize(cqueue))
+	{ ++counter; }
+
+	/* drain in order */
+	for (i = 0; i < 5; ++i)
+	{
+		CQueuePop(cqueue);
+	}
+	if (&keys[5] == CQueuePeek(cqueue))
+	{ ++counter; }
+
+	if (6 == counter)
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Erase: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Erase: FAILED);
+		DEFAULT;
+	}
+
+	CQueueDestroy(cqueue);
+}
+
+/*-------------------------------Side Functions ------------------------------*/
+
+static int IsSameAddress(const void *element_data, const void *param)
+{
+	return (element_data == param);
+}
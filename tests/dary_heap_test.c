@@ -0,0 +1,350 @@
+/*******************************************************************************
+******************************** - D-ARY HEAP - *******************************
+*
+*	DESCRIPTION		Tests
+*	AUTHOR          Liad Raz
+*
+*******************************************************************************/
+
+#include <stdio.h>		/* printf, puts */
+#include <stdlib.h>		/* abort, rand, srand */
+#include <stddef.h>		/* size_t */
+
+#include "utilities.h"
+#include "dary_heap.h"
+
+#define NUM_ELEMENTS 1000
+
+typedef struct timer
+{
+	long deadline;
+	size_t heap_idx;
+	int is_removed;
+} timer_ty;
+
+void TestDHeapCreate(void);
+void TestDHeapOrder(size_t arity);
+void TestDHeapErase(void);
+void TestDHeapIndexed(void);
+void TestDHeapUpdateKey(void);
+void TestDHeapFifo(void);
+
+static int IsSameAddress(const void *element_data, const void *param);
+
+int main(void)
+{
+	PRINT_MSG(\n--- Tests D-ary Heap ---\n);
+
+	TestDHeapCreate();
+	TestDHeapOrder(2);
+	TestDHeapOrder(DHEAP_DEFAULT_ARITY);
+	TestDHeapOrder(7);
+	TestDHeapErase();
+	TestDHeapIndexed();
+	TestDHeapUpdateKey();
+	TestDHeapFifo();
+
+	return 0;
+}
+
+/*-------------------------------Test Function-------------------------------*/
+
+void TestDHeapCreate(void)
+{
+	dheap_ty *heap = DHeapCreate(DHEAP_DEFAULT_ARITY);
+
+	if (NULL == heap)
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Create: FAILED);
+		DEFAULT;
+		abort();
+	}
+
+	if (DHeapIsEmpty(heap) && 0 == DHeapSize(heap) && NULL == DHeapPeek(heap))
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Create: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Create: FAILED);
+		DEFAULT;
+	}
+
+	DHeapDestroy(heap);
+}
+
+void TestDHeapOrder(size_t arity)
+{
+	static long keys[NUM_ELEMENTS];
+	dheap_ty *heap = DHeapCreate(arity);
+	dheap_key_ty prev = -1;
+	int is_sorted = 1;
+	size_t i = 0;
+
+	/* more than the initial capacity, so the array grows */
+	for (i = 0; i < NUM_ELEMENTS; ++i)
+	{
+		keys[i] = (long)((i * 7919) % NUM_ELEMENTS) / 3;
+		DHeapPush(heap, keys[i], &keys[i]);
+	}
+
+	if (NUM_ELEMENTS != DHeapSize(heap))
+	{
+		is_sorted = 0;
+	}
+
+	while (!DHeapIsEmpty(heap))
+	{
+		/* the packed key is the key of the peeked element */
+		if (DHeapPeekKey(heap) < prev ||
+			DHeapPeekKey(heap) != *(long *)DHeapPeek(heap))
+		{
+			is_sorted = 0;
+		}
+		prev = DHeapPeekKey(heap);
+		DHeapPop(heap);
+	}
+
+	printf("arity %lu: ", (unsigned long)arity);
+	if (is_sorted)
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Push Pop Order: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Push Pop Order: FAILED);
+		DEFAULT;
+	}
+
+	DHeapDestroy(heap);
+}
+
+void TestDHeapErase(void)
+{
+	long keys[] = {50, 10, 40, 20, 30, 60, 5, 30};
+	long not_exist = 0;
+	dheap_ty *heap = DHeapCreate(DHEAP_DEFAULT_ARITY);
+	size_t counter = 0;
+	size_t i = 0;
+
+	for (i = 0; i < SIZEOF_ARRAY(keys); ++i)
+	{
+		DHeapPush(heap, keys[i], &keys[i]);
+	}
+
+	/* erase the minimum and an inner element */
+	if (&keys[6] == DHeapErase(heap, IsSameAddress, &keys[6]) &&
+		&keys[4] == DHeapErase(heap, IsSameAddress, &keys[4]))
+	{ ++counter; }
+
+	if (NULL == DHeapErase(heap, IsSameAddress, &not_exist))
+	{ ++counter; }
+
+	/* find leaves the heap as is */
+	if (&keys[2] == DHeapFind(heap, IsSameAddress, &keys[2]) &&
+		NULL == DHeapFind(heap, IsSameAddress, &keys[6]))
+	{ ++counter; }
+
+	if (6 == DHeapSize(heap) && &keys[1] == DHeapPeek(heap))
+	{ ++counter; }
+
+	DHeapClear(heap);
+	if (DHeapIsEmpty(heap))
+	{ ++counter; }
+
+	if (5 == counter)
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Erase: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Erase: FAILED);
+		DEFAULT;
+	}
+
+	DHeapDestroy(heap);
+}
+
+void TestDHeapIndexed(void)
+{
+	static timer_ty timers[NUM_ELEMENTS];
+	dheap_ty *heap = DHeapCreateIndexed(DHEAP_DEFAULT_ARITY,
+										OFFSETOF_SIZE_T(timer_ty, heap_idx));
+	timer_ty *current = NULL;
+	long prev = -1;
+	size_t num_popped = 0;
+	int is_valid = 1;
+	size_t i = 0;
+
+	srand(50);
+	for (i = 0; i < NUM_ELEMENTS; ++i)
+	{
+		timers[i].deadline = rand() % 5000;
+		timers[i].is_removed = 0;
+		DHeapPush(heap, timers[i].deadline, &timers[i]);
+	}
+
+	/* unlink every third element, the minimum included */
+	for (i = 0; i < NUM_ELEMENTS; i += 3)
+	{
+		DHeapUnlink(heap, &timers[i]);
+		timers[i].is_removed = 1;
+	}
+	current = DHeapPeek(heap);
+	DHeapUnlink(heap, current);
+	current->is_removed = 1;
+
+	while (!DHeapIsEmpty(heap))
+	{
+		current = DHeapPeek(heap);
+		is_valid = is_valid && !current->is_removed && prev <= current->deadline;
+		prev = current->deadline;
+		DHeapPop(heap);
+		++num_popped;
+	}
+
+	if (is_valid && NUM_ELEMENTS - (NUM_ELEMENTS + 2) / 3 - 1 == num_popped)
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Indexed Unlink: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Indexed Unlink: FAILED);
+		DEFAULT;
+	}
+
+	DHeapDestroy(heap);
+}
+
+void TestDHeapUpdateKey(void)
+{
+	static timer_ty timers[NUM_ELEMENTS];
+	dheap_ty *heap = DHeapCreateIndexed(DHEAP_DEFAULT_ARITY,
+										OFFSETOF_SIZE_T(timer_ty, heap_idx));
+	timer_ty *current = NULL;
+	long prev = -1;
+	size_t num_popped = 0;
+	int is_valid = 1;
+	size_t i = 0;
+
+	srand(50);
+	for (i = 0; i < NUM_ELEMENTS; ++i)
+	{
+		timers[i].deadline = rand() % 5000;
+		DHeapPush(heap, timers[i].deadline, &timers[i]);
+	}
+
+	/* move elements both ways, the minimum included */
+	for (i = 0; i < NUM_ELEMENTS; i += 2)
+	{
+		timers[i].deadline = (0 == i % 4) ? timers[i].deadline / 3 :
+											timers[i].deadline + 2500;
+		DHeapUpdateKey(heap, &timers[i], timers[i].deadline);
+	}
+	current = DHeapPeek(heap);
+	current->deadline = 10000;
+	DHeapUpdateKey(heap, current, current->deadline);
+	timers[1].deadline = -1;
+	DHeapUpdateKey(heap, &timers[1], timers[1].deadline);
+	is_valid = (&timers[1] == DHeapPeek(heap));
+
+	while (!DHeapIsEmpty(heap))
+	{
+		current = DHeapPeek(heap);
+		is_valid = is_valid && prev <= current->deadline;
+		prev = current->deadline;
+		DHeapPop(heap);
+		++num_popped;
+	}
+
+	if (is_valid && NUM_ELEMENTS == num_popped && 10000 == prev)
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Update Key: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Update Key: FAILED);
+		DEFAULT;
+	}
+
+	DHeapDestroy(heap);
+}
+
+void TestDHeapFifo(void)
+{
+	static timer_ty timers[NUM_ELEMENTS];
+	dheap_ty *heap = DHeapCreateIndexed(DHEAP_DEFAULT_ARITY,
+										OFFSETOF_SIZE_T(timer_ty, heap_idx));
+	timer_ty *current = NULL;
+	size_t prev_order = 0;
+	size_t order = 0;
+	long prev = -1;
+	size_t num_popped = 0;
+	int is_valid = 1;
+	size_t i = 0;
+
+	/* few distinct keys, so most elements tie */
+	srand(50);
+	for (i = 0; i < NUM_ELEMENTS; ++i)
+	{
+		timers[i].deadline = rand() % 10;
+		DHeapPush(heap, timers[i].deadline, &timers[i]);
+	}
+
+	/* an update to the same key goes behind the elements already there */
+	for (i = 0; i < NUM_ELEMENTS; i += 5)
+	{
+		DHeapUpdateKey(heap, &timers[i], timers[i].deadline);
+	}
+
+	while (!DHeapIsEmpty(heap))
+	{
+		current = DHeapPeek(heap);
+		i = (size_t)(current - timers);
+		order = (0 == i % 5) ? NUM_ELEMENTS + i : i;
+		is_valid = is_valid && (prev < current->deadline ||
+					(prev == current->deadline && prev_order < order));
+		prev = current->deadline;
+		prev_order = order;
+		DHeapPop(heap);
+		++num_popped;
+	}
+
+	if (is_valid && NUM_ELEMENTS == num_popped)
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Indexed Equal Keys FIFO: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Indexed Equal Keys FIFO: FAILED);
+		DEFAULT;
+	}
+
+	DHeapDestroy(heap);
+}
+
+/*-------------------------------Side Functions ------------------------------*/
+
+static int IsSameAddress(const void *element_data, const void *param)
+{
+	return (element_data == param);
+}
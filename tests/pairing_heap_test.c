@@ -0,0 +1,331 @@
+/*******************************************************************************
+******************************* - PAIRING HEAP - *******************************
+*
+*	DESCRIPTION		Tests
+*	AUTHOR          Liad Raz
+*
+*******************************************************************************/
+
+#include <stdio.h>		/* printf, puts */
+#include <stdlib.h>		/* abort, rand, srand */
+#include <stddef.h>		/* size_t */
+
+#include "utilities.h"
+#include "pairing_heap.h"
+
+#define NUM_ELEMENTS 1000
+
+typedef struct timer
+{
+	long deadline;
+	int is_removed;
+	size_t pushed;		/* push order, for equal deadlines */
+	pheap_node_ty node;
+} timer_ty;
+
+void TestPHeapCreate(void);
+void TestPHeapOrder(void);
+void TestPHeapErase(void);
+void TestPHeapUnlink(void);
+void TestPHeapUpdateKey(void);
+
+static int IsSameAddress(const void *element_data, const void *param);
+static pheap_ty *CreateHeap(void);
+
+int main(void)
+{
+	PRINT_MSG(\n--- Tests Pairing Heap ---\n);
+
+	TestPHeapCreate();
+	TestPHeapOrder();
+	TestPHeapErase();
+	TestPHeapUnlink();
+	TestPHeapUpdateKey();
+
+	return 0;
+}
+
+/*-------------------------------Test Function-------------------------------*/
+
+void TestPHeapCreate(void)
+{
+	pheap_ty *heap = CreateHeap();
+
+	if (NULL == heap)
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Create: FAILED);
+		DEFAULT;
+		abort();
+	}
+
+	if (PHeapIsEmpty(heap) && 0 == PHeapSize(heap) && NULL == PHeapPeek(heap))
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Create: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Create: FAILED);
+		DEFAULT;
+	}
+
+	PHeapDestroy(heap);
+}
+
+void TestPHeapOrder(void)
+{
+	static timer_ty timers[NUM_ELEMENTS];
+	pheap_ty *heap = CreateHeap();
+	timer_ty *current = NULL;
+	pheap_key_ty prev = -1;
+	size_t prev_pushed = 0;
+	size_t num_pushed = 0;
+	int is_sorted = 1;
+	size_t i = 0;
+
+	for (i = 0; i < NUM_ELEMENTS; ++i)
+	{
+		timers[i].deadline = (long)((i * 7919) % NUM_ELEMENTS) / 3;
+		timers[i].pushed = num_pushed++;
+		PHeapPush(heap, timers[i].deadline, &timers[i]);
+	}
+
+	if (NUM_ELEMENTS != PHeapSize(heap))
+	{
+		is_sorted = 0;
+	}
+
+	/* pop half, push them back later, like a scheduler */
+	for (i = 0; i < NUM_ELEMENTS / 2; ++i)
+	{
+		current = PHeapPeek(heap);
+		PHeapPop(heap);
+		current->deadline += NUM_ELEMENTS;
+		current->pushed = num_pushed++;
+		PHeapPush(heap, current->deadline, current);
+	}
+
+	/* equal deadlines pop in push order */
+	while (!PHeapIsEmpty(heap))
+	{
+		current = PHeapPeek(heap);
+		if (PHeapPeekKey(heap) < prev || PHeapPeekKey(heap) != current->deadline ||
+			(PHeapPeekKey(heap) == prev && current->pushed < prev_pushed))
+		{
+			is_sorted = 0;
+		}
+		prev = PHeapPeekKey(heap);
+		prev_pushed = current->pushed;
+		PHeapPop(heap);
+	}
+
+	if (is_sorted)
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Push Pop Order: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Push Pop Order: FAILED);
+		DEFAULT;
+	}
+
+	PHeapDestroy(heap);
+}
+
+void TestPHeapErase(void)
+{
+	long keys[] = {50, 10, 40, 20, 30, 60, 5, 30};
+	timer_ty timers[8];
+	timer_ty not_exist = {0};
+	pheap_ty *heap = CreateHeap();
+	size_t counter = 0;
+	size_t i = 0;
+
+	for (i = 0; i < SIZEOF_ARRAY(keys); ++i)
+	{
+		timers[i].deadline = keys[i];
+		PHeapPush(heap, keys[i], &timers[i]);
+	}
+
+	/* erase the minimum and an inner element */
+	if (&timers[6] == PHeapErase(heap, IsSameAddress, &timers[6]) &&
+		&timers[4] == PHeapErase(heap, IsSameAddress, &timers[4]))
+	{ ++counter; }
+
+	if (NULL == PHeapErase(heap, IsSameAddress, &not_exist))
+	{ ++counter; }
+
+	/* find leaves the heap as is; every element is reached */
+	for (i = 0; i < SIZEOF_ARRAY(keys); ++i)
+	{
+		if ((6 == i || 4 == i) != (NULL == PHeapFind(heap, IsSameAddress, &timers[i])))
+		{
+			break;
+		}
+	}
+	if (SIZEOF_ARRAY(keys) == i)
+	{ ++counter; }
+
+	if (6 == PHeapSize(heap) && &timers[1] == PHeapPeek(heap))
+	{ ++counter; }
+
+	PHeapClear(heap);
+	if (PHeapIsEmpty(heap))
+	{ ++counter; }
+
+	if (5 == counter)
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Erase: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Erase: FAILED);
+		DEFAULT;
+	}
+
+	PHeapDestroy(heap);
+}
+
+void TestPHeapUnlink(void)
+{
+	static timer_ty timers[NUM_ELEMENTS];
+	pheap_ty *heap = CreateHeap();
+	timer_ty *current = NULL;
+	long prev = -1;
+	size_t num_popped = 0;
+	int is_valid = 1;
+	size_t i = 0;
+
+	srand(50);
+	for (i = 0; i < NUM_ELEMENTS; ++i)
+	{
+		timers[i].deadline = rand() % 5000;
+		timers[i].is_removed = 0;
+		PHeapPush(heap, timers[i].deadline, &timers[i]);
+	}
+
+	/* a pop first, so the tree has depth; then unlink every third */
+	current = PHeapPeek(heap);
+	PHeapPop(heap);
+	current->is_removed = 1;
+	for (i = 0; i < NUM_ELEMENTS; i += 3)
+	{
+		if (!timers[i].is_removed)
+		{
+			PHeapUnlink(heap, &timers[i]);
+			timers[i].is_removed = 1;
+		}
+	}
+	current = PHeapPeek(heap);
+	PHeapUnlink(heap, current);
+	current->is_removed = 1;
+
+	while (!PHeapIsEmpty(heap))
+	{
+		current = PHeapPeek(heap);
+		is_valid = is_valid && !current->is_removed && prev <= current->deadline;
+		prev = current->deadline;
+		PHeapPop(heap);
+		++num_popped;
+	}
+
+	for (i = 0; i < NUM_ELEMENTS; ++i)
+	{
+		num_popped += timers[i].is_removed;
+	}
+
+	if (is_valid && NUM_ELEMENTS == num_popped)
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Unlink: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Unlink: FAILED);
+		DEFAULT;
+	}
+
+	PHeapDestroy(heap);
+}
+
+void TestPHeapUpdateKey(void)
+{
+	static timer_ty timers[NUM_ELEMENTS];
+	pheap_ty *heap = CreateHeap();
+	timer_ty *current = NULL;
+	long prev = -1;
+	size_t num_popped = 0;
+	int is_valid = 1;
+	size_t i = 0;
+
+	srand(50);
+	for (i = 0; i < NUM_ELEMENTS; ++i)
+	{
+		timers[i].deadline = rand() % 5000;
+		PHeapPush(heap, timers[i].deadline, &timers[i]);
+	}
+	current = PHeapPeek(heap);
+	PHeapPop(heap);
+	PHeapPush(heap, current->deadline, current);
+
+	/* move elements both ways, the minimum included */
+	for (i = 0; i < NUM_ELEMENTS; i += 2)
+	{
+		timers[i].deadline = (0 == i % 4) ? timers[i].deadline / 3 :
+											timers[i].deadline + 2500;
+		PHeapUpdateKey(heap, &timers[i], timers[i].deadline);
+	}
+	current = PHeapPeek(heap);
+	current->deadline = 10000;
+	PHeapUpdateKey(heap, current, current->deadline);
+	timers[1].deadline = -1;
+	PHeapUpdateKey(heap, &timers[1], timers[1].deadline);
+	is_valid = (&timers[1] == PHeapPeek(heap));
+
+	while (!PHeapIsEmpty(heap))
+	{
+		current = PHeapPeek(heap);
+		is_valid = is_valid && prev <= current->deadline;
+		prev = current->deadline;
+		PHeapPop(heap);
+		++num_popped;
+	}
+
+	if (is_valid && NUM_ELEMENTS == num_popped && 10000 == prev)
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Update Key: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Update Key: FAILED);
+		DEFAULT;
+	}
+
+	PHeapDestroy(heap);
+}
+
+/*-------------------------------Side Functions ------------------------------*/
+
+static int IsSameAddress(const void *element_data, const void *param)
+{
+	return (element_data == param);
+}
+
+static pheap_ty *CreateHeap(void)
+{
+	return PHeapCreate(OFFSETOF_SIZE_T(timer_ty, node));
+}
@@ -36,6 +36,12 @@ void TestPQueueIsEmpty(void);
 void TestPQueueSize(void);
 void TestPQueueClear(void);
 void TestPQueueErase(void);
+void TestPQueueCreateKeyed(void);
+void TestPQueueCreateIntrusive(void);
+void TestPQueueEnqueueBack(void);
+void TestPQueueCreateDAryHeap(void);
+void TestPQueueCreateRadixHeap(void);
+void TestPQueueCreatePairingHeap(void);
 
 static int PQCmpObjs(const void *obj1, const void *obj2, const void *priority);
 static int AreNamesMatch(const void *struct_name, const void *looked_for_name);
@@ -58,6 +64,12 @@ int main(void)
 	TestPQueueSize();
 	TestPQueueClear();
 	TestPQueueErase();
+	TestPQueueCreateKeyed();
+	TestPQueueCreateIntrusive();
+	TestPQueueEnqueueBack();
+	TestPQueueCreateDAryHeap();
+	TestPQueueCreateRadixHeap();
+	TestPQueueCreatePairingHeap();
 
 	return 0;
 }
@@ -250,7 +262,7 @@ void TestPQueueErase(void)
 	}
 
 	to_not_find = PQueueErase(pqueue, AreNamesMatch, nameNotExsits);
-	if (NULL == to_not_find)
+	if (NULL == to_not_find && NULL == PQueueFind(pqueue, AreNamesMatch, nameNotExsits))
 	{
 		GREEN;
 		PRINT_STATUS_MSG(Test Erase When NOT exists: SUCCESS);
@@ -266,6 +278,386 @@ void TestPQueueErase(void)
 	PQueueDestroy(pqueue);
 }
 
+void TestPQueueCreateKeyed(void)
+{
+	typedef struct timer
+	{
+		char *name;
+		long deadline;
+	} timer_ty;
+
+	static timer_ty timers[200];
+	timer_ty late = {"late", 30};
+	timer_ty early = {"early", 10};
+	timer_ty middle = {"middle", 20};
+	pqueue_ty *pqueue = PQueueCreateKeyed(OFFSETOF_SIZE_T(timer_ty, deadline));
+	timer_ty *current = NULL;
+	long prev = -1;
+	int is_sorted = 1;
+	size_t counter = 0;
+	size_t i = 0;
+
+	PQueueEnqueue(pqueue, &late);
+	PQueueEnqueue(pqueue, &early);
+	PQueueEnqueue(pqueue, &middle);
+
+	/* a changed key moves the element's own node, nothing is lost */
+	if (0 == PQueueUpdateKey(pqueue, &late, 5) && &late == PQueuePeek(pqueue) &&
+		0 == PQueueUpdateKey(pqueue, &late, 30) && &early == PQueuePeek(pqueue) &&
+		3 == PQueueSize(pqueue))
+	{ ++counter; }
+
+	if (&early == PQueuePeek(pqueue))
+	{ ++counter; }
+	PQueueDequeue(pqueue);
+
+	if (&middle == PQueuePeek(pqueue))
+	{ ++counter; }
+	PQueueDequeue(pqueue);
+
+	if (&late == PQueuePeek(pqueue))
+	{ ++counter; }
+	PQueueClear(pqueue);
+
+	/* enough elements for express levels; every key is reversed */
+	for (i = 0; i < 200; ++i)
+	{
+		timers[i].deadline = (long)i;
+		PQueueEnqueue(pqueue, &timers[i]);
+	}
+	for (i = 0; i < 200; ++i)
+	{
+		PQueueUpdateKey(pqueue, &timers[i], 1000 - (long)i);
+	}
+	while (!PQueueIsEmpty(pqueue))
+	{
+		current = PQueuePeek(pqueue);
+		is_sorted = is_sorted && prev < current->deadline;
+		prev = current->deadline;
+		PQueueDequeue(pqueue);
+		++counter;
+	}
+
+	if (is_sorted && 204 == counter)
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Create Keyed: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Create Keyed: FAILED);
+		DEFAULT;
+	}
+
+	PQueueDestroy(pqueue);
+}
+
+void TestPQueueCreateIntrusive(void)
+{
+	typedef struct timer
+	{
+		char *name;
+		long deadline;
+		pq_link_ty link;
+	} timer_ty;
+
+	timer_ty late = {"late", 30, {NULL, NULL, NULL}};
+	timer_ty early = {"early", 10, {NULL, NULL, NULL}};
+	timer_ty middle = {"middle", 20, {NULL, NULL, NULL}};
+	pqueue_ty *pqueue = PQueueCreateIntrusive(OFFSETOF_SIZE_T(timer_ty, deadline),
+											OFFSETOF_SIZE_T(timer_ty, link));
+	char *name_middle = "middle";
+	size_t counter = 0;
+
+	PQueueEnqueue(pqueue, &late);
+	PQueueEnqueue(pqueue, &early);
+	PQueueEnqueue(pqueue, &middle);
+
+	/* link of the element is the pqueue node */
+	if (&early == PQueuePeek(pqueue) && &early == early.link.data)
+	{ ++counter; }
+
+	if (&middle == PQueueErase(pqueue, AreNamesMatch, name_middle))
+	{ ++counter; }
+
+	PQueueDequeue(pqueue);
+	if (&late == PQueuePeek(pqueue) && 1 == PQueueSize(pqueue))
+	{ ++counter; }
+
+	/* detached elements can be queued again */
+	PQueueEnqueue(pqueue, &middle);
+	PQueueEnqueue(pqueue, &early);
+	if (&early == PQueuePeek(pqueue) && 3 == PQueueSize(pqueue))
+	{ ++counter; }
+
+	/* unlink by address, straight through the embedded link */
+	PQueueUnlink(pqueue, &early);
+	if (&middle == PQueuePeek(pqueue) && 2 == PQueueSize(pqueue))
+	{ ++counter; }
+
+	if (5 == counter)
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Create Intrusive: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Create Intrusive: FAILED);
+		DEFAULT;
+	}
+
+	/* destroy detaches the elements, they live on the stack */
+	PQueueDestroy(pqueue);
+}
+
+void TestPQueueEnqueueBack(void)
+{
+	pqueue_ty *pqueue = PQueueCreate(PQCmpObjs, OFFSETOF(celebs_ty, priority));
+	size_t counter = 0;
+
+	PQueueEnqueueBack(pqueue, &james);
+	PQueueEnqueueBack(pqueue, &chan);
+	PQueueEnqueueBack(pqueue, &sponge_bob);
+	PQueueEnqueueBack(pqueue, &brittney);
+
+	if (&sponge_bob == PQueuePeek(pqueue))
+	{ ++counter; }
+	PQueueDequeue(pqueue);
+
+	if (&brittney == PQueuePeek(pqueue))
+	{ ++counter; }
+	PQueueDequeue(pqueue);
+
+	if (&james == PQueuePeek(pqueue))
+	{ ++counter; }
+	PQueueDequeue(pqueue);
+
+	if (&chan == PQueuePeek(pqueue))
+	{ ++counter; }
+
+	if (4 == counter)
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Enqueue Back: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Enqueue Back: FAILED);
+		DEFAULT;
+	}
+
+	PQueueDestroy(pqueue);
+}
+
+void TestPQueueCreateDAryHeap(void)
+{
+	typedef struct timer
+	{
+		char *name;
+		long deadline;
+		size_t heap_idx;
+	} timer_ty;
+
+	timer_ty late = {"late", 30, 0};
+	timer_ty early = {"early", 10, 0};
+	timer_ty middle = {"middle", 20, 0};
+	pqueue_ty *pqueue = PQueueCreateDAryHeap(OFFSETOF_SIZE_T(timer_ty, deadline),
+											DHEAP_DEFAULT_ARITY);
+	pqueue_ty *indexed = NULL;
+	char *name_middle = "middle";
+	size_t counter = 0;
+
+	PQueueEnqueue(pqueue, &late);
+	PQueueEnqueue(pqueue, &early);
+	PQueueEnqueueBack(pqueue, &middle);
+
+	if (&early == PQueuePeek(pqueue) && 3 == PQueueSize(pqueue))
+	{ ++counter; }
+
+	if (&middle == PQueueFind(pqueue, AreNamesMatch, name_middle) &&
+		&middle == PQueueErase(pqueue, AreNamesMatch, name_middle) &&
+		NULL == PQueueErase(pqueue, AreNamesMatch, name_middle) &&
+		NULL == PQueueFind(pqueue, AreNamesMatch, name_middle))
+	{ ++counter; }
+
+	PQueueDequeue(pqueue);
+	if (&late == PQueuePeek(pqueue) && 1 == PQueueSize(pqueue))
+	{ ++counter; }
+
+	/* a plain heap finds the element to move by searching */
+	PQueueEnqueue(pqueue, &middle);
+	if (0 == PQueueUpdateKey(pqueue, &late, 15) && &late == PQueuePeek(pqueue) &&
+		15 == late.deadline && 2 == PQueueSize(pqueue))
+	{ ++counter; }
+	late.deadline = 30;
+
+	PQueueClear(pqueue);
+	if (PQueueIsEmpty(pqueue) && NULL == PQueuePeek(pqueue))
+	{ ++counter; }
+
+	/* an indexed heap unlinks through the position the element embeds */
+	indexed = PQueueCreateDAryHeapIndexed(OFFSETOF_SIZE_T(timer_ty, deadline),
+										DHEAP_DEFAULT_ARITY,
+										OFFSETOF_SIZE_T(timer_ty, heap_idx));
+	PQueueEnqueue(indexed, &late);
+	PQueueEnqueue(indexed, &early);
+	PQueueEnqueue(indexed, &middle);
+	PQueueUnlink(indexed, &early);
+	if (&middle == PQueuePeek(indexed) && 2 == PQueueSize(indexed))
+	{ ++counter; }
+
+	/* and moves it in place when its key changes */
+	if (0 == PQueueUpdateKey(indexed, &late, 5) && &late == PQueuePeek(indexed) &&
+		5 == late.deadline && 0 == PQueueUpdateKey(indexed, &late, 40) &&
+		&middle == PQueuePeek(indexed) && 2 == PQueueSize(indexed))
+	{ ++counter; }
+	PQueueDestroy(indexed);
+
+	if (7 == counter)
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Create DAryHeap: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Create DAryHeap: FAILED);
+		DEFAULT;
+	}
+
+	PQueueDestroy(pqueue);
+}
+
+void TestPQueueCreateRadixHeap(void)
+{
+	typedef struct timer
+	{
+		char *name;
+		long deadline;
+	} timer_ty;
+
+	timer_ty late = {"late", 30};
+	timer_ty early = {"early", 10};
+	timer_ty middle = {"middle", 20};
+	timer_ty restarted = {"restarted", 1};
+	pqueue_ty *pqueue = PQueueCreateRadixHeap(OFFSETOF_SIZE_T(timer_ty, deadline));
+	char *name_middle = "middle";
+	size_t counter = 0;
+
+	PQueueEnqueue(pqueue, &late);
+	PQueueEnqueue(pqueue, &middle);
+	PQueueEnqueueBack(pqueue, &early);
+
+	if (&early == PQueuePeek(pqueue) && 3 == PQueueSize(pqueue))
+	{ ++counter; }
+
+	if (&middle == PQueueFind(pqueue, AreNamesMatch, name_middle) &&
+		&middle == PQueueErase(pqueue, AreNamesMatch, name_middle) &&
+		NULL == PQueueErase(pqueue, AreNamesMatch, name_middle) &&
+		NULL == PQueueFind(pqueue, AreNamesMatch, name_middle))
+	{ ++counter; }
+
+	/* keys below the last dequeued one are accepted after a new floor */
+	PQueueDequeue(pqueue);
+	PQueueSetFloor(pqueue, 0);
+	if (0 == PQueueEnqueue(pqueue, &restarted) && &restarted == PQueuePeek(pqueue))
+	{ ++counter; }
+
+	/* a key may move anywhere at or above the floor (1, the last peeked) */
+	if (0 != PQueueUpdateKey(pqueue, &late, 0) && 30 == late.deadline &&
+		0 == PQueueUpdateKey(pqueue, &late, 1) &&
+		0 == PQueueUpdateKey(pqueue, &restarted, 50) &&
+		&late == PQueuePeek(pqueue) && 2 == PQueueSize(pqueue))
+	{ ++counter; }
+
+	PQueueClear(pqueue);
+	if (PQueueIsEmpty(pqueue) && NULL == PQueuePeek(pqueue))
+	{ ++counter; }
+
+	if (5 == counter)
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Create RadixHeap: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Create RadixHeap: FAILED);
+		DEFAULT;
+	}
+
+	PQueueDestroy(pqueue);
+}
+
+void TestPQueueCreatePairingHeap(void)
+{
+	typedef struct timer
+	{
+		char *name;
+		long deadline;
+		pq_heap_node_ty node;
+	} timer_ty;
+
+	timer_ty late = {"late", 30, {0}};
+	timer_ty early = {"early", 10, {0}};
+	timer_ty middle = {"middle", 20, {0}};
+	pqueue_ty *pqueue = PQueueCreatePairingHeap(OFFSETOF_SIZE_T(timer_ty, deadline),
+												OFFSETOF_SIZE_T(timer_ty, node));
+	char *name_middle = "middle";
+	size_t counter = 0;
+
+	PQueueEnqueue(pqueue, &late);
+	PQueueEnqueue(pqueue, &middle);
+	PQueueEnqueueBack(pqueue, &early);
+
+	if (&early == PQueuePeek(pqueue) && 3 == PQueueSize(pqueue))
+	{ ++counter; }
+
+	if (&middle == PQueueFind(pqueue, AreNamesMatch, name_middle) &&
+		&middle == PQueueErase(pqueue, AreNamesMatch, name_middle) &&
+		NULL == PQueueErase(pqueue, AreNamesMatch, name_middle))
+	{ ++counter; }
+
+	/* the node embedded in the element is its handle */
+	PQueueEnqueue(pqueue, &middle);
+	PQueueUnlink(pqueue, &early);
+	if (&middle == PQueuePeek(pqueue) && 2 == PQueueSize(pqueue))
+	{ ++counter; }
+
+	if (0 == PQueueUpdateKey(pqueue, &late, 5) && &late == PQueuePeek(pqueue) &&
+		5 == late.deadline && 0 == PQueueUpdateKey(pqueue, &late, 40) &&
+		&middle == PQueuePeek(pqueue))
+	{ ++counter; }
+
+	PQueueDequeue(pqueue);
+	PQueueClear(pqueue);
+	if (PQueueIsEmpty(pqueue) && NULL == PQueuePeek(pqueue))
+	{ ++counter; }
+
+	if (5 == counter)
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Create PairingHeap: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Create PairingHeap: FAILED);
+		DEFAULT;
+	}
+
+	PQueueDestroy(pqueue);
+}
+
 /*-------------------------------Side Functions ------------------------------*/
 
 static int PQCmpObjs(const void *obj1, const void *obj2, const void *priority)
@@ -0,0 +1,206 @@
+/*******************************************************************************
+************************* - TYPED PRIORITY QUEUE - *****************************
+*
+*	DESCRIPTION		Tests
+*	AUTHOR          Liad Raz
+*
+*******************************************************************************/
+
+#include <stdio.h>		/* printf, puts */
+#include <stdlib.h>		/* abort */
+#include <stddef.h>		/* size_t */
+
+#include "utilities.h"
+#include "pqueue_typed.h"
+
+typedef struct timer
+{
+	long deadline;
+	int id;
+} timer_ty;
+
+static int CmpTimers(const timer_ty *t1, const timer_ty *t2, const void *ignore);
+static int IsTimerId(const timer_ty *timer, const void *id);
+
+PQUEUE_DEFINE(Timer, timer_ty, CmpTimers)
+
+void TestTypedPQueueCreate(void);
+void TestTypedPQueueOrder(void);
+void TestTypedPQueueStable(void);
+void TestTypedPQueueErase(void);
+
+int main(void)
+{
+	PRINT_MSG(\n--- Tests Typed Priority Queue ---\n);
+
+	TestTypedPQueueCreate();
+	TestTypedPQueueOrder();
+	TestTypedPQueueStable();
+	TestTypedPQueueErase();
+
+	return 0;
+}
+
+/*-------------------------------Test Function-------------------------------*/
+
+void TestTypedPQueueCreate(void)
+{
+	Timer_pqueue_ty *pqueue = TimerPQueueCreate(NULL);
+
+	if (NULL == pqueue)
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Create: FAILED);
+		DEFAULT;
+		abort();
+	}
+
+	PRINT_IS_SUCCESS(TimerPQueueIsEmpty(pqueue), empty);
+	TimerPQueueDestroy(pqueue);
+
+	GREEN;
+	PRINT_STATUS_MSG(Test Create: SUCCESS);
+	DEFAULT;
+}
+
+void TestTypedPQueueOrder(void)
+{
+	Timer_pqueue_ty *pqueue = TimerPQueueCreate(NULL);
+	timer_ty timer = {0, 0};
+	long prev = -1;
+	int is_sorted = 1;
+	int i = 0;
+
+	/* more than the initial capacity, so the array grows */
+	for (i = 0; i < 100; ++i)
+	{
+		timer.deadline = (i * 37) % 101;
+		timer.id = i;
+		TimerPQueueEnqueue(pqueue, timer);
+	}
+
+	if (100 != TimerPQueueSize(pqueue))
+	{
+		is_sorted = 0;
+	}
+
+	while (!TimerPQueueIsEmpty(pqueue))
+	{
+		if (TimerPQueuePeek(pqueue)->deadline < prev)
+		{
+			is_sorted = 0;
+		}
+		prev = TimerPQueuePeek(pqueue)->deadline;
+		TimerPQueueDequeue(pqueue);
+	}
+
+	if (is_sorted)
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Enqueue Dequeue Order: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Enqueue Dequeue Order: FAILED);
+		DEFAULT;
+	}
+
+	TimerPQueueDestroy(pqueue);
+}
+
+void TestTypedPQueueStable(void)
+{
+	Timer_pqueue_ty *pqueue = TimerPQueueCreate(NULL);
+	timer_ty timer = {5, 0};
+	int is_fifo = 1;
+	int i = 0;
+
+	for (i = 0; i < 20; ++i)
+	{
+		timer.id = i;
+		TimerPQueueEnqueue(pqueue, timer);
+	}
+
+	for (i = 0; i < 20; ++i)
+	{
+		if (TimerPQueuePeek(pqueue)->id != i)
+		{
+			is_fifo = 0;
+		}
+		TimerPQueueDequeue(pqueue);
+	}
+
+	if (is_fifo)
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Equal Elements FIFO: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Equal Elements FIFO: FAILED);
+		DEFAULT;
+	}
+
+	TimerPQueueDestroy(pqueue);
+}
+
+void TestTypedPQueueErase(void)
+{
+	Timer_pqueue_ty *pqueue = TimerPQueueCreate(NULL);
+	timer_ty timer = {0, 0};
+	timer_ty erased = {0, 0};
+	int id_exists = 3;
+	int id_not_exists = 42;
+	size_t counter = 0;
+	int i = 0;
+
+	for (i = 0; i < 8; ++i)
+	{
+		timer.deadline = 8 - i;
+		timer.id = i;
+		TimerPQueueEnqueue(pqueue, timer);
+	}
+
+	if (0 == TimerPQueueErase(pqueue, IsTimerId, &id_exists, &erased) &&
+		id_exists == erased.id)
+	{ ++counter; }
+
+	if (1 == TimerPQueueErase(pqueue, IsTimerId, &id_not_exists, NULL))
+	{ ++counter; }
+
+	if (7 == TimerPQueueSize(pqueue) && 1 == TimerPQueuePeek(pqueue)->deadline)
+	{ ++counter; }
+
+	if (3 == counter)
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Erase: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Erase: FAILED);
+		DEFAULT;
+	}
+
+	TimerPQueueDestroy(pqueue);
+}
+
+/*-------------------------------Side Functions ------------------------------*/
+
+static int CmpTimers(const timer_ty *t1, const timer_ty *t2, const void *ignore)
+{
+	UNUSED(ignore);
+
+	return ((t1->deadline > t2->deadline) - (t1->deadline < t2->deadline));
+}
+
+static int IsTimerId(const timer_ty *timer, const void *id)
+{
+	return (timer->id == *(const int *)id);
+}
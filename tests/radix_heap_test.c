@@ -0,0 +1,287 @@
+/*******************************************************************************
+******************************** - RADIX HEAP - *******************************
+*
+*	DESCRIPTION		Tests
+*	AUTHOR          Liad Raz
+*
+*******************************************************************************/
+
+#include <stdio.h>		/* printf, puts */
+#include <stdlib.h>		/* abort, rand, srand */
+#include <stddef.h>		/* size_t */
+
+#include "utilities.h"
+#include "radix_heap.h"
+
+#define NUM_ELEMENTS 1000
+
+typedef struct timer
+{
+	long next_run;
+	long interval;
+	int id;
+} timer_ty;
+
+void TestRHeapCreate(void);
+void TestRHeapHold(void);
+void TestRHeapFifo(void);
+void TestRHeapSetFloor(void);
+void TestRHeapErase(void);
+
+static int IsSameAddress(const void *element_data, const void *param);
+
+int main(void)
+{
+	PRINT_MSG(\n--- Tests Radix Heap ---\n);
+
+	TestRHeapCreate();
+	TestRHeapHold();
+	TestRHeapFifo();
+	TestRHeapSetFloor();
+	TestRHeapErase();
+
+	return 0;
+}
+
+/*-------------------------------Test Function-------------------------------*/
+
+void TestRHeapCreate(void)
+{
+	rheap_ty *heap = RHeapCreate();
+
+	if (NULL == heap)
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Create: FAILED);
+		DEFAULT;
+		abort();
+	}
+
+	if (RHeapIsEmpty(heap) && 0 == RHeapSize(heap) && NULL == RHeapPeek(heap))
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Create: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Create: FAILED);
+		DEFAULT;
+	}
+
+	RHeapDestroy(heap);
+}
+
+void TestRHeapHold(void)
+{
+	static timer_ty timers[NUM_ELEMENTS];
+	rheap_ty *heap = RHeapCreate();
+	timer_ty *current = NULL;
+	long prev = -1000;
+	int is_sorted = 1;
+	size_t i = 0;
+
+	/* negative keys too; more than the initial capacity */
+	srand(50);
+	for (i = 0; i < NUM_ELEMENTS; ++i)
+	{
+		timers[i].next_run = (long)(rand() % 2000) - 900;
+		timers[i].interval = 1 + rand() % 5000;
+		RHeapPush(heap, timers[i].next_run, &timers[i]);
+	}
+
+	/* pop the earliest and push it back later, like a scheduler */
+	for (i = 0; i < 20 * NUM_ELEMENTS; ++i)
+	{
+		current = RHeapPeek(heap);
+		if (current->next_run < prev || current->next_run != RHeapPeekKey(heap))
+		{
+			is_sorted = 0;
+		}
+		prev = current->next_run;
+		RHeapPop(heap);
+
+		current->next_run += current->interval;
+		RHeapPush(heap, current->next_run, current);
+	}
+
+	if (is_sorted && NUM_ELEMENTS == RHeapSize(heap))
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Hold Order: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Hold Order: FAILED);
+		DEFAULT;
+	}
+
+	RHeapDestroy(heap);
+}
+
+void TestRHeapFifo(void)
+{
+	timer_ty timers[12] = {{0}};
+	rheap_ty *heap = RHeapCreate();
+	int is_fifo = 1;
+	int i = 0;
+
+	/* same key pushed before and after the floor moves towards it */
+	for (i = 0; i < 6; ++i)
+	{
+		timers[i].id = i;
+		RHeapPush(heap, 40, &timers[i]);
+	}
+	timers[6].id = 6;
+	RHeapPush(heap, 10, &timers[6]);
+	RHeapPeek(heap);
+	RHeapPop(heap);
+	for (i = 7; i < 12; ++i)
+	{
+		timers[i].id = i;
+		RHeapPush(heap, 40, &timers[i]);
+	}
+
+	for (i = 0; i < 12; ++i)
+	{
+		if (6 != i && ((timer_ty *)RHeapPeek(heap))->id != i)
+		{
+			is_fifo = 0;
+		}
+		if (6 != i)
+		{
+			RHeapPop(heap);
+		}
+	}
+
+	if (is_fifo && RHeapIsEmpty(heap))
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Equal Keys FIFO: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Equal Keys FIFO: FAILED);
+		DEFAULT;
+	}
+
+	RHeapDestroy(heap);
+}
+
+void TestRHeapSetFloor(void)
+{
+	timer_ty early = {5, 0, 1};
+	timer_ty late = {500, 0, 2};
+	timer_ty reset = {3, 0, 3};
+	rheap_ty *heap = RHeapCreate();
+	size_t counter = 0;
+
+	RHeapPush(heap, early.next_run, &early);
+	RHeapPush(heap, late.next_run, &late);
+	RHeapPop(heap);
+
+	/* the floor follows the last key taken out */
+	if (500 == RHeapPeekKey(heap))
+	{ ++counter; }
+
+	/* after the clock reset smaller keys are accepted again */
+	RHeapSetFloor(heap, 0);
+	if (0 == RHeapPush(heap, reset.next_run, &reset) && &reset == RHeapPeek(heap))
+	{ ++counter; }
+
+	RHeapPop(heap);
+	if (&late == RHeapPeek(heap) && 1 == RHeapSize(heap))
+	{ ++counter; }
+
+	RHeapClear(heap);
+	if (RHeapIsEmpty(heap) && 0 == RHeapPush(heap, -7, &early) &&
+		-7 == RHeapPeekKey(heap))
+	{ ++counter; }
+
+	if (4 == counter)
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Set Floor: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Set Floor: FAILED);
+		DEFAULT;
+	}
+
+	RHeapDestroy(heap);
+}
+
+void TestRHeapErase(void)
+{
+	long keys[] = {50, 10, 40, 20, 30, 60, 5, 30};
+	long not_exist = 0;
+	rheap_ty *heap = RHeapCreate();
+	size_t counter = 0;
+	size_t i = 0;
+
+	for (i = 0; i < SIZEOF_ARRAY(keys); ++i)
+	{
+		RHeapPush(heap, keys[i], &keys[i]);
+	}
+
+	/* erase the minimum and an inner element; released slots are reused */
+	if (&keys[6] == RHeapErase(heap, IsSameAddress, &keys[6]) &&
+		&keys[4] == RHeapErase(heap, IsSameAddress, &keys[4]) &&
+		0 == RHeapPush(heap, keys[4], &keys[4]))
+	{ ++counter; }
+
+	if (NULL == RHeapErase(heap, IsSameAddress, &not_exist))
+	{ ++counter; }
+
+	/* find leaves the heap as is */
+	if (&keys[2] == RHeapFind(heap, IsSameAddress, &keys[2]) &&
+		NULL == RHeapFind(heap, IsSameAddress, &keys[6]))
+	{ ++counter; }
+
+	if (7 == RHeapSize(heap) && &keys[1] == RHeapPeek(heap))
+	{ ++counter; }
+
+	/* the peek moved the floor; a key leads to its bucket, a wrong one not */
+	if (&keys[0] == RHeapEraseKey(heap, keys[0], IsSameAddress, &keys[0]) &&
+		NULL == RHeapEraseKey(heap, keys[3] + 1000, IsSameAddress, &keys[3]) &&
+		6 == RHeapSize(heap))
+	{ ++counter; }
+
+	/* drain in order */
+	for (i = 0; i < 5; ++i)
+	{
+		RHeapPop(heap);
+	}
+	if (&keys[5] == RHeapPeek(heap))
+	{ ++counter; }
+
+	if (6 == counter)
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Erase: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Erase: FAILED);
+		DEFAULT;
+	}
+
+	RHeapDestroy(heap);
+}
+
+/*-------------------------------Side Functions ------------------------------*/
+
+static int IsSameAddress(const void *element_data, const void *param)
+{
+	return (element_data == param);
+}
@@ -6,8 +6,14 @@
 *
 *******************************************************************************/
 
-#include <stdio.h>		/* printf, puts, size_t */
+#define _POSIX_C_SOURCE 200112L	/* fork, pipe, shm_unlink */
+
+#include <stdio.h>		/* printf, puts, size_t, tmpfile, rewind, remove, fseek */
 #include <stdlib.h>		/* abort */
+#include <time.h>		/* clock, CLOCKS_PER_SEC */
+#include <unistd.h>		/* fork, pipe, read, write, sleep, _exit */
+#include <sys/wait.h>	/* waitpid */
+#include <sys/mman.h>	/* shm_unlink */
 
 #include "utilities.h" 		/* UNUSED */
 #include "scheduler.h"
@@ -25,6 +31,17 @@ typedef struct package
 	sched_id_ty id;
 } package_ty;
 
+typedef struct hook_counts
+{
+	size_t num_pre;
+	size_t num_post;
+	size_t num_failed;
+	size_t num_removed;
+	sched_id_ty removed;
+	int is_paired;		/* every post follows the pre of the same task */
+	sched_id_ty running;
+} hook_counts_ty;
+
 /* Global Declaration */
 cartoon_ty patrik = {"Patrik", "pink", 1};
 cartoon_ty sponge_bob = {"Sponge Bob", "yellow", 2};
@@ -39,11 +56,30 @@ void TestSchedPause(void);
 void TestSchedSize(void);
 void TestSchedIsEmpty(void);
 void TestSchedClear(void);
+void TestSchedSetEngine(void);
+void TestSchedAdaptive(void);
+void TestSchedLazyRemove(void);
+void TestSchedFind(void);
+void TestSchedReschedule(void);
+void TestSchedSnapshot(void);
+void TestSchedMap(void);
+void TestSchedJournal(void);
+void TestSchedShm(void);
+void TestSchedStats(void);
+void TestSchedHooks(void);
+void TestSchedTaskStats(void);
+void TestSchedOverload(void);
 
 static scheduler_ty *CreateSchedulerWithTasks(void);
 static int ExeTask(void *params);
 static int PauseTask(void *params);
 static int RemoveInRunTask(void *params);
+static int CountTask(void *params);
+static int OrderTask(void *params);
+static int BusyTask(void *params);
+static void PreHook(sched_id_ty id, void *params, void *counts);
+static void PostHook(sched_id_ty id, void *params, int status, void *counts);
+static void RemoveHook(sched_id_ty id, void *params, void *counts);
 
 int main(void)
 {
@@ -57,6 +93,19 @@ int main(void)
 	TestSchedSize();
 	TestSchedIsEmpty();
 	TestSchedClear();
+	TestSchedSetEngine();
+	TestSchedAdaptive();
+	TestSchedLazyRemove();
+	TestSchedFind();
+	TestSchedReschedule();
+	TestSchedSnapshot();
+	TestSchedMap();
+	TestSchedJournal();
+	TestSchedShm();
+	TestSchedStats();
+	TestSchedHooks();
+	TestSchedTaskStats();
+	TestSchedOverload();
 
 	return 0;
 }
@@ -122,10 +171,10 @@ void TestSchedRun(void)
 int TestSchedAdd(void)
 {
 	scheduler_ty *scheduler = NULL;
-	sched_id_ty id_task1 = {0};
-	sched_id_ty id_task2 = {0};
-	sched_id_ty id_task3 = {0};
-	sched_id_ty id_task4 = {0};
+	sched_id_ty id_task1 = SCHED_BAD_ID;
+	sched_id_ty id_task2 = SCHED_BAD_ID;
+	sched_id_ty id_task3 = SCHED_BAD_ID;
+	sched_id_ty id_task4 = SCHED_BAD_ID;
 	size_t counter = 0;
 
 	scheduler = SchedCreate();
@@ -139,16 +188,16 @@ int TestSchedAdd(void)
 	id_task3 = SchedAdd(scheduler, ExeTask, &gary, 4);
 	id_task4 = SchedAdd(scheduler, ExeTask, &skidward, 5);
 
-	if (0 == UIDIsBad(id_task1))
+	if (SCHED_BAD_ID != id_task1)
 	{ ++counter; }
 
-	if (0 == UIDIsBad(id_task2))
+	if (SCHED_BAD_ID != id_task2)
 	{ ++counter; }
 
-	if (0 == UIDIsBad(id_task3))
+	if (SCHED_BAD_ID != id_task3)
 	{ ++counter; }
 
-	if (0 == UIDIsBad(id_task4))
+	if (SCHED_BAD_ID != id_task4)
 	{ ++counter; }
 
 	if (4 == counter)
@@ -173,8 +222,8 @@ void TestSchedRemove(void)
 {
 	scheduler_ty *scheduler = NULL;
 	package_ty *pkg = NULL;
-	sched_id_ty id_task1 = {0};
-	uid_ty random_id = UIDGenerate();
+	sched_id_ty id_task1 = SCHED_BAD_ID;
+	sched_id_ty id_task2 = SCHED_BAD_ID;
 	size_t counter = 0;
 
 	scheduler = SchedCreate();
@@ -191,12 +240,15 @@ void TestSchedRemove(void)
 
 	id_task1 = SchedAdd(scheduler, ExeTask, &patrik, 2);
 
-	/* 1. Test remove uid that located in pqueue */
+	/* 1. Test remove id that located in pqueue */
 	if (0 == SchedRemove(scheduler, id_task1))
 	{ ++counter; }
 
-	/* 2. Test uid is not in pqueue */
-	if (1 == SchedRemove(scheduler, random_id))
+	/* 2. Test removed id is stale, also once its slot holds a new task */
+	id_task2 = SchedAdd(scheduler, ExeTask, &patrik, 2);
+	if (1 == SchedRemove(scheduler, id_task1) && id_task1 != id_task2 &&
+		0 == SchedRemove(scheduler, id_task2) &&
+		1 == SchedRemove(scheduler, id_task2))
 	{ ++counter; }
 
 	/* 3. Test remove the current task */
@@ -353,64 +405,1462 @@ void TestSchedClear(void)
 	SchedDestroy(scheduler);
 }
 
-/*-------------------------------Side Functions ------------------------------*/
-static scheduler_ty *CreateSchedulerWithTasks(void)
+void TestSchedSetEngine(void)
 {
-	scheduler_ty *ret = NULL;
-	sched_id_ty id_task1 = {0};
-	sched_id_ty id_task2 = {0};
-	sched_id_ty id_task3 = {0};
-	sched_id_ty id_task4 = {0};
+	scheduler_ty *scheduler = NULL;
+	sched_id_ty ids[20] = {0};
+	cqueue_stats_ty stats = {0};
+	int ranks[40] = {0};
+	size_t counter = 0;
+	time_t i = 0;
 
-	ret = SchedCreate();
-	if (NULL == ret)
+	scheduler = SchedCreate();
+	if (NULL == scheduler)
 	{
-		return NULL;
+		PRINT_MSG(allocation failure in set engine);
+		return;
 	}
 
-	id_task1 = SchedAdd(ret, ExeTask, &patrik, 1);
-	id_task2 = SchedAdd(ret, ExeTask, &sponge_bob, 2);
-	id_task3 = SchedAdd(ret, ExeTask, &gary, 3);
-	id_task4 = SchedAdd(ret, ExeTask, &skidward, 6);
+	/* 1. switch on an empty scheduler */
+	if (0 == SchedSetEngine(scheduler, SCHED_ENGINE_FIFO))
+	{ ++counter; }
 
-	UNUSED(id_task1);
-	UNUSED(id_task2);
-	UNUSED(id_task3);
-	UNUSED(id_task4);
+	/* 2. more distinct intervals than buckets, the rest go to the pqueue */
+	for (i = 0; i < 20; ++i)
+	{
+		ids[i] = SchedAdd(scheduler, ExeTask, &gary, 100 + i % 18);
+	}
 
-	return ret;
+	if (20 == SchedSize(scheduler))
+	{ ++counter; }
+
+	/* 3. engine is fixed while tasks exist */
+	if (1 == SchedSetEngine(scheduler, SCHED_ENGINE_PQUEUE))
+	{ ++counter; }
+
+	/* 4. remove from the buckets and from the fallback pqueue */
+	if (0 == SchedRemove(scheduler, ids[0]) && 0 == SchedRemove(scheduler, ids[17]) &&
+		0 == SchedRemove(scheduler, ids[19]) && 17 == SchedSize(scheduler))
+	{ ++counter; }
+
+	/* 5. run until pause */
+	SchedClear(scheduler);
+	SchedAdd(scheduler, PauseTask, scheduler, 1);
+	SchedAdd(scheduler, PauseTask, scheduler, 2);
+	if (STOPPED == SchedRun(scheduler) && 2 == SchedSize(scheduler))
+	{ ++counter; }
+
+	/* 6. radix engine: the clock restarts with every run and every add
+		while paused, run times go back below the last one taken */
+	SchedClear(scheduler);
+	if (0 == SchedSetEngine(scheduler, SCHED_ENGINE_RADIX))
+	{ ++counter; }
+
+	SchedAdd(scheduler, PauseTask, scheduler, 2);
+	SchedAdd(scheduler, PauseTask, scheduler, 1);
+	if (STOPPED == SchedRun(scheduler) &&
+		SCHED_BAD_ID != SchedAdd(scheduler, PauseTask, scheduler, 1) &&
+		STOPPED == SchedRun(scheduler) && 3 == SchedSize(scheduler))
+	{ ++counter; }
+
+	/* 8. calendar engine resizes its buckets as tasks are added */
+	SchedClear(scheduler);
+	if (1 == SchedGetCalendarStats(scheduler, &stats) &&
+		0 == SchedSetEngine(scheduler, SCHED_ENGINE_CALENDAR))
+	{ ++counter; }
+
+	for (i = 0; i < 100; ++i)
+	{
+		SchedAdd(scheduler, PauseTask, scheduler, 1000 + i * 60);
+	}
+	SchedAdd(scheduler, PauseTask, scheduler, 1);
+
+	/* 9. resize statistics are exposed */
+	if (0 == SchedGetCalendarStats(scheduler, &stats) && 0 < stats.grows &&
+		stats.resizes == stats.grows && 101 == SchedSize(scheduler))
+	{ ++counter; }
+
+	/* 10. the earliest task runs first and pauses */
+	if (STOPPED == SchedRun(scheduler) && 101 == SchedSize(scheduler))
+	{ ++counter; }
+
+	/* 11. FIFO buckets emptied of old intervals take new ones */
+	SchedClear(scheduler);
+	SchedSetEngine(scheduler, SCHED_ENGINE_FIFO);
+	for (i = 0; i < 40; ++i)
+	{
+		ids[0] = SchedAdd(scheduler, ExeTask, &gary, 200 + i);
+		ids[1] = SchedAdd(scheduler, ExeTask, &gary, 200 + i);
+		SchedRemove(scheduler, ids[0]);
+		SchedRemove(scheduler, ids[1]);
+	}
+	for (i = 0; i < 20; ++i)
+	{
+		ids[i] = SchedAdd(scheduler, ExeTask, &gary, 300 + i % 17);
+	}
+	if (20 == SchedSize(scheduler) && 0 == SchedRemove(scheduler, ids[3]) &&
+		0 == SchedRemove(scheduler, ids[16]) && !SchedFind(scheduler, ids[3]) &&
+		SchedFind(scheduler, ids[19]) &&
+		SCHED_BAD_ID != SchedAdd(scheduler, PauseTask, scheduler, 1) &&
+		STOPPED == SchedRun(scheduler) && 19 == SchedSize(scheduler))
+	{ ++counter; }
+
+	/* 12. pairing engine runs tasks due the same second in the order they
+		were added */
+	SchedClear(scheduler);
+	SchedSetEngine(scheduler, SCHED_ENGINE_PAIRING);
+	for (i = 0; i < 40; ++i)
+	{
+		SchedAdd(scheduler, OrderTask, &ranks[i], 1);
+	}
+	SchedAdd(scheduler, PauseTask, scheduler, 1);
+	SchedRun(scheduler);
+
+	for (i = 1; i < 40 && 0 != ranks[0] && ranks[0] + i == ranks[i]; ++i)
+	{
+	}
+	if (40 == i)
+	{ ++counter; }
+
+	if (12 == counter)
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Set Engine: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Set Engine: FAILED);
+		DEFAULT;
+	}
+
+	SchedDestroy(scheduler);
 }
 
-static int ExeTask(void *params)
+void TestSchedAdaptive(void)
 {
-	static int runThreeTimes = 0;
-	cartoon_ty *cartoon = params;
+	scheduler_ty *scheduler = SchedCreate();
+	sched_id_ty ids[40] = {0};
+	int ranks[40] = {0};
+	size_t counter = 0;
+	size_t removed = 0;
+	time_t i = 0;
 
-	++runThreeTimes;
+	if (NULL == scheduler)
+	{
+		PRINT_MSG(allocation failure in adaptive);
+		return;
+	}
 
-	printf("\tName: %s\tInterval: %lu\tTime: %lu\n", cartoon->name, cartoon->interval, time(NULL));
+	/* 1. grows past the sorted list threshold; latest tasks added first */
+	for (i = 0; i < 40; ++i)
+	{
+		ids[i] = SchedAdd(scheduler, PauseTask, scheduler, 1000 - i);
+	}
+	SchedAdd(scheduler, PauseTask, scheduler, 1);
 
+	if (41 == SchedSize(scheduler))
+	{ ++counter; }
 
-	return (5 <= runThreeTimes); /* SUCCESS 0*/
+	/* 2. the heap still runs the earliest task first */
+	if (STOPPED == SchedRun(scheduler) && 41 == SchedSize(scheduler))
+	{ ++counter; }
+
+	/* 3. shrinks back to the sorted list */
+	for (i = 0; i < 30; ++i)
+	{
+		removed += (0 == SchedRemove(scheduler, ids[i]));
+	}
+
+	if (30 == removed && 11 == SchedSize(scheduler))
+	{ ++counter; }
+
+	SchedAdd(scheduler, PauseTask, scheduler, 1);
+	if (STOPPED == SchedRun(scheduler) && 12 == SchedSize(scheduler))
+	{ ++counter; }
+
+	/* 4. another engine can be chosen once empty */
+	SchedClear(scheduler);
+	if (0 == SchedSetEngine(scheduler, SCHED_ENGINE_PQUEUE) &&
+		0 == SchedSetEngine(scheduler, SCHED_ENGINE_ADAPTIVE))
+	{ ++counter; }
+
+	/* 5. the heap runs tasks due the same second in the order they were added */
+	for (i = 0; i < 40; ++i)
+	{
+		SchedAdd(scheduler, OrderTask, &ranks[i], 1);
+	}
+	SchedAdd(scheduler, PauseTask, scheduler, 1);
+	SchedRun(scheduler);
+
+	for (i = 1; i < 40 && 0 != ranks[0] && ranks[0] + i == ranks[i]; ++i)
+	{
+	}
+	if (40 == i)
+	{ ++counter; }
+
+	if (6 == counter)
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Adaptive Engine: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Adaptive Engine: FAILED);
+		DEFAULT;
+	}
+
+	SchedDestroy(scheduler);
 }
 
-static int PauseTask(void *scheduler)
+void TestSchedLazyRemove(void)
 {
-	static int count = 0;
+	scheduler_ty *scheduler = SchedCreate();
+	sched_id_ty ids[40] = {0};
+	sched_id_ty first = SCHED_BAD_ID;
+	size_t counter = 0;
+	size_t removed = 0;
+	time_t i = 0;
 
-	++count;
-	if (3 <= count)
+	if (NULL == scheduler)
 	{
-		SchedPause(scheduler);
+		PRINT_MSG(allocation failure in lazy remove);
+		return;
 	}
 
-	return 0;
+	SchedSetLazyRemove(scheduler, 1);
+
+	/* 1. the earliest task is cancelled, the next one runs and pauses */
+	first = SchedAdd(scheduler, PauseTask, scheduler, 1);
+	SchedAdd(scheduler, PauseTask, scheduler, 2);
+
+	if (0 == SchedRemove(scheduler, first) && 1 == SchedSize(scheduler))
+	{ ++counter; }
+
+	if (STOPPED == SchedRun(scheduler) && 1 == SchedSize(scheduler))
+	{ ++counter; }
+
+	/* 2. enough cancelled tasks to compact on the next add */
+	for (i = 0; i < 40; ++i)
+	{
+		ids[i] = SchedAdd(scheduler, PauseTask, scheduler, 1000 + i);
+	}
+	for (i = 0; i < 30; ++i)
+	{
+		removed += (0 == SchedRemove(scheduler, ids[i]));
+	}
+
+	if (30 == removed && 11 == SchedSize(scheduler) && !SchedIsEmpty(scheduler))
+	{ ++counter; }
+
+	SchedAdd(scheduler, PauseTask, scheduler, 1);
+	if (12 == SchedSize(scheduler) && STOPPED == SchedRun(scheduler) &&
+		12 == SchedSize(scheduler))
+	{ ++counter; }
+
+	/* 3. back to removing at once */
+	SchedSetLazyRemove(scheduler, 0);
+	if (0 == SchedRemove(scheduler, ids[35]) && 11 == SchedSize(scheduler))
+	{ ++counter; }
+
+	if (5 == counter)
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Lazy Remove: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Lazy Remove: FAILED);
+		DEFAULT;
+	}
+
+	SchedDestroy(scheduler);
 }
 
-static int RemoveInRunTask(void *params)
+void TestSchedFind(void)
 {
-	puts("\tNext Task Will remove itself");
-	SchedRemove(((package_ty *)params)->sched, ((package_ty *)params)->id);
-	return 0;
+	enum sched_engine_ty engines[] = {SCHED_ENGINE_ADAPTIVE, SCHED_ENGINE_PQUEUE,
+									SCHED_ENGINE_FIFO, SCHED_ENGINE_RADIX,
+									SCHED_ENGINE_CALENDAR, SCHED_ENGINE_PAIRING};
+	scheduler_ty *scheduler = SchedCreate();
+	sched_id_ty ids[40] = {0};
+	time_t next_run = 0;
+	size_t num_engines = SIZEOF_ARRAY(engines);
+	size_t counter = 0;
+	size_t e = 0;
+	int is_valid = 1;
+	time_t i = 0;
+
+	if (NULL == scheduler)
+	{
+		PRINT_MSG(allocation failure in find);
+		return;
+	}
+
+	for (e = 0; e < num_engines; ++e)
+	{
+		is_valid = (0 == SchedSetEngine(scheduler, engines[e]));
+
+		/* shared intervals fill FIFO buckets; 40 tasks make ADAPTIVE a heap */
+		for (i = 0; i < 40; ++i)
+		{
+			ids[i] = SchedAdd(scheduler, ExeTask, &patrik, 1 + i % 5 + (i % 3) * 100);
+		}
+
+		/* 1. every id leads to its task */
+		for (i = 0; i < 40; ++i)
+		{
+			is_valid = is_valid && SchedFind(scheduler, ids[i]) &&
+						0 == SchedGetNextRun(scheduler, ids[i], &next_run) &&
+						1 + i % 5 + (i % 3) * 100 == next_run;
+		}
+		is_valid = is_valid && 0 == SchedSetParams(scheduler, ids[3], &sponge_bob);
+
+		/* 2. removed tasks are gone, the others stay queued */
+		for (i = 0; i < 40; i += 2)
+		{
+			is_valid = is_valid && 0 == SchedRemove(scheduler, ids[i]);
+		}
+		for (i = 0; i < 40; ++i)
+		{
+			is_valid = is_valid && (i % 2) == SchedFind(scheduler, ids[i]);
+		}
+		is_valid = is_valid && 20 == SchedSize(scheduler) &&
+					1 == SchedGetNextRun(scheduler, ids[0], &next_run) &&
+					1 == SchedSetParams(scheduler, ids[0], &sponge_bob);
+
+		/* 3. and can be removed in turn */
+		for (i = 1; i < 40; i += 2)
+		{
+			is_valid = is_valid && 0 == SchedRemove(scheduler, ids[i]);
+		}
+
+		if (is_valid && SchedIsEmpty(scheduler))
+		{ ++counter; }
+	}
+
+	if (num_engines == counter)
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Find By Id: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Find By Id: FAILED);
+		DEFAULT;
+	}
+
+	SchedDestroy(scheduler);
+}
+
+void TestSchedReschedule(void)
+{
+	enum sched_engine_ty engines[] = {SCHED_ENGINE_ADAPTIVE, SCHED_ENGINE_PQUEUE,
+									SCHED_ENGINE_FIFO, SCHED_ENGINE_RADIX,
+									SCHED_ENGINE_CALENDAR, SCHED_ENGINE_PAIRING};
+	scheduler_ty *scheduler = SchedCreate();
+	sched_id_ty ids[40] = {0};
+	sched_id_ty pause_id = SCHED_BAD_ID;
+	time_t next_run = 0;
+	size_t num_engines = SIZEOF_ARRAY(engines);
+	size_t counter = 0;
+	size_t e = 0;
+	int is_valid = 1;
+	time_t i = 0;
+
+	if (NULL == scheduler)
+	{
+		PRINT_MSG(allocation failure in reschedule);
+		return;
+	}
+
+	for (e = 0; e < num_engines; ++e)
+	{
+		SchedClear(scheduler);
+		is_valid = (0 == SchedSetEngine(scheduler, engines[e]));
+
+		/* tasks far in the future; the pause task runs when moved first */
+		for (i = 0; i < 40; ++i)
+		{
+			ids[i] = SchedAdd(scheduler, ExeTask, &patrik, 1000 + i % 5);
+		}
+		pause_id = SchedAdd(scheduler, PauseTask, scheduler, 500);
+
+		/* 1. later and earlier, same id */
+		is_valid = is_valid && 0 == SchedReschedule(scheduler, ids[3], 5000) &&
+					0 == SchedGetNextRun(scheduler, ids[3], &next_run) &&
+					5000 == next_run &&
+					0 == SchedReschedule(scheduler, ids[4], 700) &&
+					0 == SchedGetNextRun(scheduler, ids[4], &next_run) &&
+					700 == next_run;
+
+		/* 2. the pending run moves by the interval difference */
+		is_valid = is_valid && 0 == SchedSetInterval(scheduler, ids[5], 1050) &&
+					0 == SchedGetNextRun(scheduler, ids[5], &next_run) &&
+					1050 == next_run;
+
+		/* 3. a past time is as soon as possible; stale ids fail */
+		is_valid = is_valid && 0 == SchedReschedule(scheduler, pause_id, -10) &&
+					0 == SchedGetNextRun(scheduler, pause_id, &next_run) &&
+					0 == next_run && 0 == SchedRemove(scheduler, ids[6]) &&
+					1 == SchedReschedule(scheduler, ids[6], 10) &&
+					1 == SchedSetInterval(scheduler, ids[6], 10);
+
+		/* 4. the queue order follows: the pause task runs first */
+		SchedReschedule(scheduler, pause_id, 1);
+		is_valid = is_valid && STOPPED == SchedRun(scheduler) &&
+					40 == SchedSize(scheduler) && SchedFind(scheduler, pause_id);
+
+		if (is_valid)
+		{ ++counter; }
+	}
+
+	if (num_engines == counter)
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Reschedule: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Reschedule: FAILED);
+		DEFAULT;
+	}
+
+	SchedDestroy(scheduler);
 }
 
+void TestSchedSnapshot(void)
+{
+	enum sched_engine_ty engines[] = {SCHED_ENGINE_ADAPTIVE, SCHED_ENGINE_PQUEUE,
+									SCHED_ENGINE_FIFO, SCHED_ENGINE_RADIX,
+									SCHED_ENGINE_CALENDAR, SCHED_ENGINE_PAIRING};
+	scheduler_ty *saved = SchedCreate();
+	scheduler_ty *loaded = SchedCreate();
+	FILE *stream = tmpfile();
+	FILE *garbage = tmpfile();
+	sched_task_type_ty types[2];
+	sched_id_ty ids[100] = {0};
+	sched_id_ty pause_id = SCHED_BAD_ID;
+	sched_id_ty new_id = SCHED_BAD_ID;
+	time_t saved_run = 0;
+	time_t loaded_run = 0;
+	size_t num_engines = SIZEOF_ARRAY(engines);
+	size_t counter = 0;
+	size_t e = 0;
+	size_t i = 0;
+	int is_valid = 1;
+
+	if (NULL == saved || NULL == loaded || NULL == stream || NULL == garbage)
+	{
+		PRINT_MSG(allocation failure in snapshot);
+		return;
+	}
+
+	types[0].key = 7;
+	types[0].task_func = ExeTask;
+	types[0].params = &patrik;
+	types[1].key = 9;
+	types[1].task_func = PauseTask;
+	types[1].params = loaded;
+
+	for (i = 0; i < 100; ++i)
+	{
+		ids[i] = SchedAdd(saved, ExeTask, &patrik, 1000 + (time_t)(i % 7) * 100);
+	}
+	SchedRemove(saved, ids[5]);
+	SchedRemove(saved, ids[6]);
+	SchedReschedule(saved, ids[7], 50);
+	pause_id = SchedAdd(saved, PauseTask, saved, 1);
+
+	/* 1. a task function without a key can not be saved */
+	if (1 == SchedSave(saved, garbage, types, 1) &&
+		0 == SchedSave(saved, stream, types, 2))
+	{ ++counter; }
+
+	for (e = 0; e < num_engines; ++e)
+	{
+		SchedClear(loaded);
+		SchedSetEngine(loaded, engines[e]);
+		rewind(stream);
+
+		/* 2. same ids, same times left; removed ids stay stale */
+		is_valid = (0 == SchedLoad(loaded, stream, types, 2) &&
+					99 == SchedSize(loaded) && SchedFind(loaded, pause_id) &&
+					!SchedFind(loaded, ids[5]) && !SchedFind(loaded, ids[6]));
+		for (i = 0; i < 100 && is_valid; ++i)
+		{
+			is_valid = (5 == i || 6 == i ||
+						(0 == SchedGetNextRun(saved, ids[i], &saved_run) &&
+						0 == SchedGetNextRun(loaded, ids[i], &loaded_run) &&
+						saved_run == loaded_run));
+		}
+
+		/* 3. new tasks take free slots without reusing an id */
+		new_id = SchedAdd(loaded, ExeTask, &patrik, 10);
+		is_valid = is_valid && SCHED_BAD_ID != new_id && new_id != ids[5] &&
+					new_id != ids[6] && 0 == SchedRemove(loaded, new_id);
+
+		/* 4. only into an empty scheduler */
+		rewind(stream);
+		is_valid = is_valid && 1 == SchedLoad(loaded, stream, types, 2) &&
+					99 == SchedSize(loaded);
+
+		if (is_valid)
+		{ ++counter; }
+	}
+
+	/* 5. the loaded pause task runs first */
+	if (STOPPED == SchedRun(loaded) && 99 == SchedSize(loaded))
+	{ ++counter; }
+
+	/* 6. a malformed snapshot leaves the scheduler empty */
+	SchedClear(loaded);
+	rewind(garbage);
+	fputs("not a snapshot of the scheduler at all", garbage);
+	rewind(garbage);
+	if (1 == SchedLoad(loaded, garbage, types, 2) && SchedIsEmpty(loaded) &&
+		SCHED_BAD_ID != SchedAdd(loaded, ExeTask, &patrik, 1))
+	{ ++counter; }
+
+	/* 7. a lazily removed task is not saved, and its id stays stale */
+	SchedClear(saved);
+	SchedClear(loaded);
+	SchedSetLazyRemove(saved, 1);
+	for (i = 0; i < 4; ++i)
+	{
+		ids[i] = SchedAdd(saved, ExeTask, &patrik, 100);
+	}
+	SchedRemove(saved, ids[1]);
+	fclose(stream);
+	stream = tmpfile();
+	is_valid = (NULL != stream && 0 == SchedSave(saved, stream, types, 2));
+	if (is_valid)
+	{
+		rewind(stream);
+		is_valid = (0 == SchedLoad(loaded, stream, types, 2) &&
+					3 == SchedSize(loaded) && !SchedFind(loaded, ids[1]));
+	}
+	for (i = 0; i < 100 && is_valid; ++i)
+	{
+		new_id = SchedAdd(loaded, ExeTask, &patrik, 10);
+		is_valid = (SCHED_BAD_ID != new_id && ids[1] != new_id &&
+					!SchedFind(loaded, ids[1]));
+	}
+	if (is_valid)
+	{ ++counter; }
+
+	if (num_engines + 4 == counter)
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Snapshot Save Load: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Snapshot Save Load: FAILED);
+		DEFAULT;
+	}
+
+	if (NULL != stream)
+	{
+		fclose(stream);
+	}
+	fclose(garbage);
+	SchedDestroy(saved);
+	SchedDestroy(loaded);
+}
+
+/*-------------------------------Side Functions ------------------------------*/
+void TestSchedMap(void)
+{
+	const char *path = "scheduler_test.map";
+	scheduler_ty *mapped = SchedCreate();
+	scheduler_ty *reopened = SchedCreate();
+	scheduler_ty *recovered = SchedCreate();
+	FILE *file = NULL;
+	sched_task_type_ty types[2];
+	sched_id_ty ids[40] = {0};
+	sched_id_ty extra[30] = {0};
+	time_t saved_runs[40] = {0};
+	sched_id_ty pause_id = SCHED_BAD_ID;
+	sched_id_ty new_id = SCHED_BAD_ID;
+	time_t loaded_run = 0;
+	size_t num_extra = 0;
+	size_t counter = 0;
+	size_t i = 0;
+	int is_valid = 1;
+
+	if (NULL == mapped || NULL == reopened || NULL == recovered)
+	{
+		PRINT_MSG(allocation failure in map);
+		return;
+	}
+
+	remove(path);
+	types[0].key = 7;
+	types[0].task_func = ExeTask;
+	types[0].params = &patrik;
+	types[1].key = 9;
+	types[1].task_func = PauseTask;
+	types[1].params = reopened;
+
+	/* 1. a new file; tasks need a type */
+	if (0 == SchedMapOpen(mapped, path, 64, types, 2) &&
+		1 == SchedMapOpen(mapped, path, 64, types, 2) &&
+		SCHED_BAD_ID == SchedAdd(mapped, RemoveInRunTask, mapped, 1))
+	{ ++counter; }
+
+	for (i = 0; i < 40; ++i)
+	{
+		ids[i] = SchedAdd(mapped, ExeTask, &patrik, 1000 + (time_t)i * 10);
+	}
+	SchedSetLazyRemove(mapped, 1);
+	SchedRemove(mapped, ids[3]);
+	SchedSetLazyRemove(mapped, 0);
+	SchedRemove(mapped, ids[4]);
+	SchedReschedule(mapped, ids[7], 50);
+	pause_id = SchedAdd(mapped, PauseTask, reopened, 1);
+
+	/* 2. the file holds 64 tasks; the cancelled one keeps its slot */
+	for (num_extra = 0; num_extra < 30; ++num_extra)
+	{
+		extra[num_extra] = SchedAdd(mapped, ExeTask, &patrik, 5);
+		if (SCHED_BAD_ID == extra[num_extra])
+		{
+			break;
+		}
+	}
+	for (i = 0; i < num_extra; ++i)
+	{
+		SchedRemove(mapped, extra[i]);
+	}
+	if (24 == num_extra && 39 == SchedSize(mapped) && 0 == SchedMapSync(mapped))
+	{ ++counter; }
+
+	for (i = 0; i < 40; ++i)
+	{
+		SchedGetNextRun(mapped, ids[i], &saved_runs[i]);
+	}
+	SchedDestroy(mapped);
+
+	/* 3. reopened with the same ids and runs, whatever capacity is asked */
+	SchedSetEngine(reopened, SCHED_ENGINE_PAIRING);
+	is_valid = (0 == SchedMapOpen(reopened, path, 8, types, 2) &&
+				39 == SchedSize(reopened) && SchedFind(reopened, pause_id) &&
+				!SchedFind(reopened, ids[3]) && !SchedFind(reopened, ids[4]) &&
+				!SchedFind(reopened, extra[0]));
+	for (i = 0; i < 40 && is_valid; ++i)
+	{
+		is_valid = (3 == i || 4 == i ||
+					(0 == SchedGetNextRun(reopened, ids[i], &loaded_run) &&
+					loaded_run <= saved_runs[i] && saved_runs[i] <= loaded_run + 1));
+	}
+	new_id = SchedAdd(reopened, ExeTask, &patrik, 10);
+	if (is_valid && SCHED_BAD_ID != new_id && new_id != ids[3] &&
+		new_id != ids[4])
+	{ ++counter; }
+
+	/* 4. the reopened pause task runs first */
+	if (STOPPED == SchedRun(reopened) && 40 == SchedSize(reopened))
+	{ ++counter; }
+	SchedDestroy(reopened);
+
+	/* 5. a record changed behind the scheduler loses its task, not the file */
+	file = fopen(path, "r+b");
+	if (NULL != file && 0 == fseek(file, 64 + 9, SEEK_SET))
+	{
+		fputc(0x5a, file);
+		fclose(file);
+	}
+	new_id = SCHED_BAD_ID;
+	is_valid = (0 == SchedMapOpen(recovered, path, 64, types, 2) &&
+				39 == SchedSize(recovered) && !SchedFind(recovered, ids[0]) &&
+				SchedFind(recovered, ids[1]) && SchedFind(recovered, pause_id));
+	if (is_valid)
+	{
+		new_id = SchedAdd(recovered, ExeTask, &patrik, 10);
+	}
+	if (is_valid && SCHED_BAD_ID != new_id && new_id != ids[0] &&
+		!SchedFind(recovered, ids[0]) && 0 == SchedMapSync(recovered))
+	{ ++counter; }
+
+	if (5 == counter)
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Mapped File: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Mapped File: FAILED);
+		DEFAULT;
+	}
+
+	SchedDestroy(recovered);
+	remove(path);
+}
+
+void TestSchedJournal(void)
+{
+	enum sched_engine_ty engines[] = {SCHED_ENGINE_ADAPTIVE, SCHED_ENGINE_PQUEUE,
+									SCHED_ENGINE_FIFO, SCHED_ENGINE_RADIX,
+									SCHED_ENGINE_CALENDAR, SCHED_ENGINE_PAIRING};
+	scheduler_ty *journaled = SchedCreate();
+	scheduler_ty *recovered = SchedCreate();
+	FILE *snapshot = tmpfile();
+	FILE *journal = tmpfile();
+	FILE *cleared = tmpfile();
+	sched_task_type_ty types[2];
+	sched_id_ty ids[30] = {0};
+	sched_id_ty pause_id = SCHED_BAD_ID;
+	sched_id_ty new_id = SCHED_BAD_ID;
+	time_t journaled_run = 0;
+	time_t recovered_run = 0;
+	size_t num_engines = SIZEOF_ARRAY(engines);
+	size_t counter = 0;
+	size_t e = 0;
+	size_t i = 0;
+	int is_valid = 1;
+
+	if (NULL == journaled || NULL == recovered || NULL == snapshot ||
+		NULL == journal || NULL == cleared)
+	{
+		PRINT_MSG(allocation failure in journal);
+		return;
+	}
+
+	types[0].key = 7;
+	types[0].task_func = ExeTask;
+	types[0].params = &patrik;
+	types[1].key = 9;
+	types[1].task_func = PauseTask;
+	types[1].params = recovered;
+
+	for (i = 0; i < 20; ++i)
+	{
+		ids[i] = SchedAdd(journaled, ExeTask, &patrik, 1000 + (time_t)i * 10);
+	}
+	SchedSave(journaled, snapshot, types, 2);
+
+	/* 1. one journal at a time, of tasks with a type, no load into it */
+	rewind(snapshot);
+	if (0 == SchedJournalStart(journaled, journal, types, 2, 4) &&
+		1 == SchedJournalStart(journaled, journal, types, 2, 4) &&
+		SCHED_BAD_ID == SchedAdd(journaled, RemoveInRunTask, journaled, 1) &&
+		1 == SchedLoad(journaled, snapshot, types, 2))
+	{ ++counter; }
+
+	for (i = 20; i < 30; ++i)
+	{
+		ids[i] = SchedAdd(journaled, ExeTask, &patrik, 2000 + (time_t)i);
+	}
+	SchedRemove(journaled, ids[2]);
+	SchedRemove(journaled, ids[21]);
+	SchedSetLazyRemove(journaled, 1);
+	SchedRemove(journaled, ids[3]);
+	SchedSetLazyRemove(journaled, 0);
+	SchedReschedule(journaled, ids[5], 70);
+	SchedSetInterval(journaled, ids[24], 300);
+
+	/* 2. committed on sync and stop */
+	if (0 == SchedJournalSync(journaled) && 0 == SchedJournalStop(journaled) &&
+		1 == SchedJournalSync(journaled))
+	{ ++counter; }
+
+	/* a record a crash cut short */
+	fseek(journal, 0, SEEK_END);
+	fwrite("torn record", 11, 1, journal);
+
+	for (e = 0; e < num_engines; ++e)
+	{
+		SchedClear(recovered);
+		SchedSetEngine(recovered, engines[e]);
+		rewind(snapshot);
+		rewind(journal);
+
+		/* 3. the snapshot and the journal give back the same tasks */
+		is_valid = (0 == SchedLoad(recovered, snapshot, types, 2) &&
+					0 == SchedJournalReplay(recovered, journal, types, 2) &&
+					27 == SchedSize(recovered));
+		for (i = 0; i < 30 && is_valid; ++i)
+		{
+			is_valid = (2 == i || 3 == i || 21 == i) ?
+						!SchedFind(recovered, ids[i]) :
+						(0 == SchedGetNextRun(journaled, ids[i], &journaled_run) &&
+						0 == SchedGetNextRun(recovered, ids[i], &recovered_run) &&
+						journaled_run == recovered_run);
+		}
+
+		/* 4. new tasks do not reuse a replayed id */
+		new_id = SchedAdd(recovered, ExeTask, &patrik, 10);
+		is_valid = is_valid && SCHED_BAD_ID != new_id && new_id != ids[2] &&
+					new_id != ids[3] && new_id != ids[21] &&
+					0 == SchedRemove(recovered, new_id);
+
+		if (is_valid)
+		{ ++counter; }
+	}
+
+	/* 5. a clear is replayed as well; the last add runs */
+	SchedClear(recovered);
+	rewind(snapshot);
+	SchedLoad(recovered, snapshot, types, 2);
+	SchedJournalStart(recovered, cleared, types, 2, 1);
+	SchedAdd(recovered, ExeTask, &patrik, 5);
+	SchedClear(recovered);
+	pause_id = SchedAdd(recovered, PauseTask, recovered, 1);
+	SchedJournalStop(recovered);
+	SchedClear(recovered);
+	rewind(snapshot);
+	rewind(cleared);
+	if (0 == SchedLoad(recovered, snapshot, types, 2) &&
+		0 == SchedJournalReplay(recovered, cleared, types, 2) &&
+		1 == SchedSize(recovered) && SchedFind(recovered, pause_id) &&
+		STOPPED == SchedRun(recovered))
+	{ ++counter; }
+
+	/* 6. a snapshot is not a journal */
+	rewind(snapshot);
+	if (1 == SchedJournalReplay(recovered, snapshot, types, 2))
+	{ ++counter; }
+
+	if (num_engines + 4 == counter)
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Journal Replay: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Journal Replay: FAILED);
+		DEFAULT;
+	}
+
+	fclose(snapshot);
+	fclose(journal);
+	fclose(cleared);
+	SchedDestroy(journaled);
+	SchedDestroy(recovered);
+}
+
+void TestSchedShm(void)
+{
+	const char *name = "/scheduler_test_shm";
+	scheduler_ty *dispatcher = SchedCreate();
+	scheduler_ty *other = SchedCreate();
+	sched_shm_ty *client = NULL;
+	sched_task_type_ty types[2];
+	sched_id_ty own_ids[2] = {0};
+	sched_id_ty client_ids[4] = {0};
+	enum run_status_ty run_status = EMPTY;
+	int fds[2] = {-1, -1};
+	int child_status = 1;
+	int is_valid = 0;
+	pid_t child = -1;
+	time_t start = 0;
+	size_t num_added = 0;
+	size_t counter = 0;
+
+	if (NULL == dispatcher || NULL == other || 0 != pipe(fds))
+	{
+		PRINT_MSG(allocation failure in shared memory);
+		return;
+	}
+
+	/* left by a run which was killed */
+	shm_unlink(name);
+	types[0].key = 7;
+	types[0].task_func = ExeTask;
+	types[0].params = &patrik;
+	types[1].key = 9;
+	types[1].task_func = PauseTask;
+	types[1].params = dispatcher;
+
+	/* 1. one dispatcher per segment */
+	if (0 == SchedShmCreate(dispatcher, name, 16, types, 2) &&
+		1 == SchedShmCreate(other, name, 16, types, 2) &&
+		NULL == SchedShmAttach("/scheduler_test_none"))
+	{ ++counter; }
+
+	own_ids[0] = SchedAdd(dispatcher, ExeTask, &patrik, 100);
+	own_ids[1] = SchedAdd(dispatcher, ExeTask, &patrik, 200);
+
+	/* 2. another process adds and removes tasks; a later add of an earlier
+		task wakes the dispatcher */
+	child = fork();
+	if (0 == child)
+	{
+		client = SchedShmAttach(name);
+		if (NULL == client)
+		{
+			_exit(1);
+		}
+
+		client_ids[0] = SchedShmAdd(client, 7, 50);
+		client_ids[1] = SchedShmAdd(client, 7, 60);
+		client_ids[2] = SchedShmAdd(client, 99, 60);
+		is_valid = (SCHED_BAD_ID != client_ids[0] && SCHED_BAD_ID != client_ids[2] &&
+					0 == SchedShmRemove(client, client_ids[1]) &&
+					1 == SchedShmRemove(client, client_ids[1]) &&
+					0 == SchedShmRemove(client, own_ids[1]));
+
+		sleep(1);
+		client_ids[3] = SchedShmAdd(client, 9, 1);
+		is_valid = is_valid && SCHED_BAD_ID != client_ids[3] &&
+					sizeof(client_ids) == write(fds[1], client_ids, sizeof(client_ids));
+
+		SchedShmDetach(client);
+		_exit(!is_valid);
+	}
+
+	start = time(NULL);
+	run_status = SchedRun(dispatcher);
+	waitpid(child, &child_status, 0);
+	if (STOPPED == run_status && 10 > time(NULL) - start && 0 == child_status &&
+		sizeof(client_ids) == read(fds[0], client_ids, sizeof(client_ids)))
+	{ ++counter; }
+
+	/* 3. ids are shared: removed ones and a key without a type are stale */
+	if (SchedFind(dispatcher, client_ids[0]) && !SchedFind(dispatcher, client_ids[1]) &&
+		!SchedFind(dispatcher, client_ids[2]) && SchedFind(dispatcher, client_ids[3]) &&
+		SchedFind(dispatcher, own_ids[0]) && !SchedFind(dispatcher, own_ids[1]) &&
+		3 == SchedSize(dispatcher))
+	{ ++counter; }
+
+	/* 4. every process takes from the same 16 slots */
+	client = SchedShmAttach(name);
+	for (num_added = 0; NULL != client && num_added < 20; ++num_added)
+	{
+		if (SCHED_BAD_ID == SchedShmAdd(client, 7, 30))
+		{
+			break;
+		}
+	}
+	if (13 == num_added && SCHED_BAD_ID == SchedAdd(dispatcher, ExeTask, &patrik, 1))
+	{ ++counter; }
+	SchedShmDetach(client);
+
+	/* 5. destroy takes the segment name away */
+	SchedDestroy(dispatcher);
+	client = SchedShmAttach(name);
+	if (NULL == client)
+	{ ++counter; }
+
+	/* 6. radix engine: a client task due before the local one it waits for */
+	dispatcher = SchedCreate();
+	if (NULL == dispatcher)
+	{
+		PRINT_MSG(allocation failure in shared memory);
+		SchedDestroy(other);
+		return;
+	}
+	types[1].params = dispatcher;
+	SchedSetEngine(dispatcher, SCHED_ENGINE_RADIX);
+	SchedShmCreate(dispatcher, name, 4, types, 2);
+	own_ids[0] = SchedAdd(dispatcher, ExeTask, &patrik, 5);
+
+	child = fork();
+	if (0 == child)
+	{
+		client = SchedShmAttach(name);
+		sleep(1);
+		_exit(NULL == client || SCHED_BAD_ID == SchedShmAdd(client, 9, 1));
+	}
+
+	start = time(NULL);
+	run_status = SchedRun(dispatcher);
+	waitpid(child, &child_status, 0);
+	if (STOPPED == run_status && 5 > time(NULL) - start && 0 == child_status &&
+		2 == SchedSize(dispatcher) && SchedFind(dispatcher, own_ids[0]))
+	{ ++counter; }
+	SchedDestroy(dispatcher);
+
+	if (6 == counter)
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Shared Memory: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Shared Memory: FAILED);
+		DEFAULT;
+	}
+
+	close(fds[0]);
+	close(fds[1]);
+	SchedDestroy(other);
+}
+
+void TestSchedStats(void)
+{
+	const char *name = "/scheduler_test_stats";
+	scheduler_ty *scheduler = SchedCreate();
+	scheduler_ty *other = SchedCreate();
+	sched_stats_view_ty *view = NULL;
+	sched_stats_ty stats;
+	sched_task_runs_ty tasks[4];
+	sched_id_ty count_id = SCHED_BAD_ID;
+	sched_id_ty pause_id = SCHED_BAD_ID;
+	int num_runs = 0;
+	int is_valid = 0;
+	size_t counter = 0;
+	size_t i = 0;
+
+	if (NULL == scheduler || NULL == other)
+	{
+		PRINT_MSG(allocation failure in stats);
+		return;
+	}
+
+	/* left by a run which was killed */
+	shm_unlink(name);
+
+	/* 1. one segment per scheduler, one scheduler per segment */
+	if (0 == SchedStatsCreate(scheduler, name, 4) &&
+		1 == SchedStatsCreate(scheduler, "/scheduler_test_stats_2", 4) &&
+		1 == SchedStatsCreate(other, name, 4) &&
+		NULL == SchedStatsAttach("/scheduler_test_none"))
+	{ ++counter; }
+
+	/* 2. a monitor reads it before any run */
+	view = SchedStatsAttach(name);
+	if (NULL != view && 0 == SchedStatsRead(view, &stats, tasks, 4) &&
+		4 == stats.capacity && 0 == stats.num_tasks && 0 == stats.is_running &&
+		0 == stats.num_dispatched)
+	{ ++counter; }
+
+	if (NULL == view)
+	{
+		SchedDestroy(scheduler);
+		SchedDestroy(other);
+		return;
+	}
+
+	/* ExeTask returns non-zero after its fifth run, long ago */
+	count_id = SchedAdd(scheduler, CountTask, &num_runs, 1);
+	SchedAdd(scheduler, ExeTask, &gary, 1);
+	pause_id = SchedAdd(scheduler, PauseTask, scheduler, 3);
+	SchedRun(scheduler);
+
+	/* 3. every run counted; the failed task is freed, so is its entry */
+	if (0 == SchedStatsRead(view, &stats, tasks, 4) && 0 == stats.is_running &&
+		(unsigned long)num_runs + 2 == stats.num_dispatched &&
+		1 == stats.num_failed && 2 == stats.queue_depth && 2 == stats.num_tasks &&
+		stats.late_p50 <= stats.late_p90 && stats.late_p90 <= stats.late_p99 &&
+		stats.late_p99 <= stats.late_max && 2000 > stats.late_max &&
+		stats.started <= stats.updated)
+	{ ++counter; }
+
+	for (i = 0, is_valid = 1; i < stats.num_tasks; ++i)
+	{
+		is_valid = is_valid &&
+					((count_id == tasks[i].id && (unsigned long)num_runs == tasks[i].runs) ||
+					(pause_id == tasks[i].id && 1 == tasks[i].runs));
+	}
+	if (is_valid && 2 <= num_runs)
+	{ ++counter; }
+
+	/* 4. fewer entries than tasks: num_tasks tells them all */
+	tasks[1].id = SCHED_BAD_ID;
+	if (0 == SchedStatsRead(view, &stats, tasks, 1) && 2 == stats.num_tasks &&
+		SCHED_BAD_ID == tasks[1].id)
+	{ ++counter; }
+
+	/* 5. destroy takes the name away; the last update stays readable */
+	SchedDestroy(scheduler);
+	if (NULL == SchedStatsAttach(name) &&
+		0 == SchedStatsRead(view, &stats, tasks, 4) &&
+		(unsigned long)num_runs + 2 == stats.num_dispatched)
+	{ ++counter; }
+
+	if (6 == counter)
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Stats: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Stats: FAILED);
+		DEFAULT;
+	}
+
+	SchedStatsDetach(view);
+	SchedDestroy(other);
+}
+
+void TestSchedHooks(void)
+{
+	const char *path = "scheduler_test_hooks.map";
+	scheduler_ty *scheduler = SchedCreate();
+	scheduler_ty *mapped = SchedCreate();
+	scheduler_ty *replayed = SchedCreate();
+	FILE *journal = tmpfile();
+	hook_counts_ty counts = {0};
+	sched_hooks_ty hooks;
+	sched_task_type_ty types[1];
+	sched_id_ty count_id = SCHED_BAD_ID;
+	sched_id_ty fail_id = SCHED_BAD_ID;
+	int num_runs = 0;
+	size_t counter = 0;
+
+	if (NULL == scheduler || NULL == mapped || NULL == replayed || NULL == journal)
+	{
+		PRINT_MSG(allocation failure in hooks);
+		return;
+	}
+
+	types[0].key = 7;
+	types[0].task_func = ExeTask;
+	types[0].params = &patrik;
+
+	hooks.pre_dispatch = PreHook;
+	hooks.post_dispatch = PostHook;
+	hooks.on_remove = RemoveHook;
+	hooks.hook_params = &counts;
+	counts.is_paired = 1;
+	SchedSetHooks(scheduler, &hooks);
+
+	/* ExeTask returns non-zero after its fifth run, long ago */
+	count_id = SchedAdd(scheduler, CountTask, &num_runs, 1);
+	fail_id = SchedAdd(scheduler, ExeTask, &gary, 1);
+	SchedAdd(scheduler, PauseTask, scheduler, 2);
+	SchedRun(scheduler);
+
+	/* 1. every run is wrapped by both hooks */
+	if (counts.is_paired && (size_t)num_runs + 2 == counts.num_pre &&
+		counts.num_pre == counts.num_post && 1 == counts.num_failed)
+	{ ++counter; }
+
+	/* 2. the failed task is freed, then a removed one */
+	if (1 == counts.num_removed && fail_id == counts.removed &&
+		0 == SchedRemove(scheduler, count_id) &&
+		2 == counts.num_removed && count_id == counts.removed)
+	{ ++counter; }
+
+	/* 3. hooks set to NULL are not called */
+	SchedSetHooks(scheduler, NULL);
+	SchedClear(scheduler);
+	if (2 == counts.num_removed && SchedIsEmpty(scheduler))
+	{ ++counter; }
+
+	/* 4. tasks a mapped scheduler leaves in its file are not removed */
+	remove(path);
+	SchedSetHooks(mapped, &hooks);
+	SchedMapOpen(mapped, path, 8, types, 1);
+	SchedAdd(mapped, ExeTask, &patrik, 10);
+	SchedAdd(mapped, ExeTask, &patrik, 20);
+	SchedDestroy(mapped);
+	mapped = SchedCreate();
+	if (2 == counts.num_removed && NULL != mapped &&
+		0 == SchedMapOpen(mapped, path, 8, types, 1) && 2 == SchedSize(mapped))
+	{ ++counter; }
+
+	/* 5. nor are the removals a journal replays; later ones are */
+	SchedJournalStart(scheduler, journal, types, 1, 1);
+	SchedAdd(scheduler, ExeTask, &patrik, 10);
+	SchedRemove(scheduler, SchedAdd(scheduler, ExeTask, &patrik, 20));
+	SchedAdd(scheduler, ExeTask, &patrik, 30);
+	SchedJournalStop(scheduler);
+	rewind(journal);
+	SchedSetHooks(replayed, &hooks);
+	if (0 == SchedJournalReplay(replayed, journal, types, 1) &&
+		2 == SchedSize(replayed) && 2 == counts.num_removed)
+	{ ++counter; }
+	SchedClear(replayed);
+	if (4 == counts.num_removed)
+	{ ++counter; }
+
+	if (6 == counter)
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Hooks: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Hooks: FAILED);
+		DEFAULT;
+	}
+
+	SchedDestroy(scheduler);
+	SchedDestroy(mapped);
+	SchedDestroy(replayed);
+	fclose(journal);
+	remove(path);
+}
+
+void TestSchedTaskStats(void)
+{
+	scheduler_ty *scheduler = SchedCreate();
+	sched_task_stats_ty stats;
+	sched_id_ty busy_id = SCHED_BAD_ID;
+	sched_id_ty fail_id = SCHED_BAD_ID;
+	sched_id_ty new_id = SCHED_BAD_ID;
+	int num_runs = 0;
+	size_t counter = 0;
+
+	if (NULL == scheduler)
+	{
+		PRINT_MSG(allocation failure in task stats);
+		return;
+	}
+
+	/* ExeTask returns non-zero after its fifth run, long ago */
+	SchedSetTaskStats(scheduler, 1);
+	busy_id = SchedAdd(scheduler, BusyTask, &num_runs, 1);
+	fail_id = SchedAdd(scheduler, ExeTask, &gary, 1);
+	SchedAdd(scheduler, PauseTask, scheduler, 2);
+
+	/* 1. a task which did not run has none */
+	stats.runs = 1;
+	if (0 == SchedGetTaskStats(scheduler, busy_id, &stats) && 0 == stats.runs &&
+		0 == stats.cpu_ns)
+	{ ++counter; }
+
+	SchedRun(scheduler);
+
+	/* 2. CPU time of every run: BusyTask burns 10 ms a run */
+	if (0 == SchedGetTaskStats(scheduler, busy_id, &stats) &&
+		(unsigned long)num_runs == stats.runs && 0 == stats.failures &&
+		stats.runs * 9000000 <= stats.cpu_ns && 9000000 <= stats.max_cpu_ns &&
+		stats.max_cpu_ns <= stats.cpu_ns)
+	{ ++counter; }
+
+	/* 3. the failed task is freed, its counts are kept */
+	if (!SchedFind(scheduler, fail_id) &&
+		0 == SchedGetTaskStats(scheduler, fail_id, &stats) &&
+		1 == stats.runs && 1 == stats.failures)
+	{ ++counter; }
+
+	/* 4. a new task in the slot starts from none once it runs */
+	SchedRemove(scheduler, busy_id);
+	new_id = SchedAdd(scheduler, CountTask, &num_runs, 1);
+	if (0 == SchedGetTaskStats(scheduler, new_id, &stats) && 0 == stats.runs &&
+		1 == SchedGetTaskStats(scheduler, fail_id + ((sched_id_ty)1 << 40), &stats))
+	{ ++counter; }
+
+	if (4 == counter)
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Task Stats: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Task Stats: FAILED);
+		DEFAULT;
+	}
+
+	SchedDestroy(scheduler);
+}
+
+void TestSchedOverload(void)
+{
+	scheduler_ty *scheduler = SchedCreate();
+	sched_load_stats_ty load;
+	int num_runs[10] = {0};
+	int min_runs = 0;
+	int max_runs = 0;
+	size_t num_added = 0;
+	size_t counter = 0;
+	size_t i = 0;
+
+	if (NULL == scheduler)
+	{
+		PRINT_MSG(allocation failure in overload);
+		return;
+	}
+
+	/* 1. admission stops at the max size, rejections are counted */
+	SchedSetMaxSize(scheduler, 11);
+	for (i = 0; i < 10; ++i)
+	{
+		num_added += (SCHED_BAD_ID != SchedAdd(scheduler, BusyTask, &num_runs[i], 1));
+	}
+	num_added += (SCHED_BAD_ID != SchedAdd(scheduler, PauseTask, scheduler, 3));
+	num_added += (SCHED_BAD_ID != SchedAdd(scheduler, PauseTask, scheduler, 3));
+	SchedGetLoadStats(scheduler, &load);
+	if (11 == num_added && 11 == SchedSize(scheduler) &&
+		0 == load.num_deferred && 1 == load.num_rejected)
+	{ ++counter; }
+
+	/* 2. 10 tasks of 10 ms a second over a budget of 35 ms: the tasks
+		left are deferred, and each task still runs in turn */
+	SchedSetBudget(scheduler, 35);
+	SchedRun(scheduler);
+	SchedGetLoadStats(scheduler, &load);
+
+	min_runs = num_runs[0];
+	max_runs = num_runs[0];
+	for (i = 1; i < 10; ++i)
+	{
+		min_runs = (num_runs[i] < min_runs) ? num_runs[i] : min_runs;
+		max_runs = (num_runs[i] > max_runs) ? num_runs[i] : max_runs;
+	}
+	if (5 <= load.num_deferred && 1 <= min_runs && 1 >= max_runs - min_runs)
+	{ ++counter; }
+
+	/* 3. no limits */
+	SchedSetMaxSize(scheduler, 0);
+	SchedSetBudget(scheduler, 0);
+	if (SCHED_BAD_ID != SchedAdd(scheduler, CountTask, &min_runs, 1))
+	{ ++counter; }
+
+	if (3 == counter)
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Overload: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Overload: FAILED);
+		DEFAULT;
+	}
+
+	SchedDestroy(scheduler);
+}
+
+static scheduler_ty *CreateSchedulerWithTasks(void)
+{
+	scheduler_ty *ret = NULL;
+	sched_id_ty id_task1 = SCHED_BAD_ID;
+	sched_id_ty id_task2 = SCHED_BAD_ID;
+	sched_id_ty id_task3 = SCHED_BAD_ID;
+	sched_id_ty id_task4 = SCHED_BAD_ID;
+
+	ret = SchedCreate();
+	if (NULL == ret)
+	{
+		return NULL;
+	}
+
+	id_task1 = SchedAdd(ret, ExeTask, &patrik, 1);
+	id_task2 = SchedAdd(ret, ExeTask, &sponge_bob, 2);
+	id_task3 = SchedAdd(ret, ExeTask, &gary, 3);
+	id_task4 = SchedAdd(ret, ExeTask, &skidward, 6);
+
+	UNUSED(id_task1);
+	UNUSED(id_task2);
+	UNUSED(id_task3);
+	UNUSED(id_task4);
+
+	return ret;
+}
+
+static int ExeTask(void *params)
+{
+	static int runThreeTimes = 0;
+	cartoon_ty *cartoon = params;
+
+	++runThreeTimes;
+
+	printf("\tName: %s\tInterval: %lu\tTime: %lu\n", cartoon->name, cartoon->interval, time(NULL));
+
+
+	return (5 <= runThreeTimes); /* SUCCESS 0*/
+}
+
+static int PauseTask(void *scheduler)
+{
+	static int count = 0;
+
+	++count;
+	if (3 <= count)
+	{
+		SchedPause(scheduler);
+	}
+
+	return 0;
+}
+
+static int RemoveInRunTask(void *params)
+{
+	puts("\tNext Task Will remove itself");
+	SchedRemove(((package_ty *)params)->sched, ((package_ty *)params)->id);
+	return 0;
+}
+
+static int CountTask(void *num_runs)
+{
+	++*(int *)num_runs;
+
+	return 0;
+}
+
+/* writes the order it first ran in */
+static int OrderTask(void *rank)
+{
+	static int count = 0;
+
+	if (0 == *(int *)rank)
+	{
+		*(int *)rank = ++count;
+	}
+
+	return 0;
+}
+
+static int BusyTask(void *num_runs)
+{
+	clock_t start = clock();
+
+	while (clock() - start < CLOCKS_PER_SEC / 100)
+	{
+	}
+	++*(int *)num_runs;
+
+	return 0;
+}
+
+static void PreHook(sched_id_ty id, void *params, void *counts)
+{
+	hook_counts_ty *hook_counts = counts;
+
+	++hook_counts->num_pre;
+	hook_counts->is_paired = hook_counts->is_paired && SCHED_BAD_ID == hook_counts->running;
+	hook_counts->running = id;
+
+	UNUSED(params);
+}
+
+static void PostHook(sched_id_ty id, void *params, int status, void *counts)
+{
+	hook_counts_ty *hook_counts = counts;
+
+	++hook_counts->num_post;
+	hook_counts->num_failed += (0 != status);
+	hook_counts->is_paired = hook_counts->is_paired && id == hook_counts->running;
+	hook_counts->running = SCHED_BAD_ID;
+
+	UNUSED(params);
+}
+
+static void RemoveHook(sched_id_ty id, void *params, void *counts)
+{
+	hook_counts_ty *hook_counts = counts;
+
+	++hook_counts->num_removed;
+	hook_counts->removed = id;
+
+	UNUSED(params);
+}
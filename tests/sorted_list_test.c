@@ -21,9 +21,20 @@ void TestSortLNextPrev(void);
 void TestSortLIsSameIter(void);
 void TestSortLFind(void);
 void TestSortLMerge(void);
+void TestSortLCreateKeyed(void);
+void TestSortLInsertHint(void);
+void TestSortLSkipList(void);
+void TestSortLReposition(void);
+
+typedef struct keyed
+{
+	char *name;
+	long key;
+} keyed_ty;
 
 static int CmpObjects(const void *obj1, const void *obj2, const void *key);
 static void PrintSortedList(sortl_ty *sort_list);
+static int IsSortedList(sortl_ty *sort_list);
 
 
 int main(void)
@@ -38,6 +49,10 @@ int main(void)
 	TestSortLIsSameIter();
 	TestSortLFind();
 	TestSortLMerge();
+	TestSortLCreateKeyed();
+	TestSortLInsertHint();
+	TestSortLSkipList();
+	TestSortLReposition();
 
 	return 0;
 }
@@ -317,6 +332,281 @@ void TestSortLMerge(void)
 	SortLDestroy(donor);
 }
 
+void TestSortLCreateKeyed(void)
+{
+	keyed_ty first = {"first", 7};
+	keyed_ty second = {"second", 3};
+	keyed_ty third = {"third", 7};
+	keyed_ty to_find = {"to_find", 7};
+	keyed_ty not_exist = {"not_exist", 5};
+	sortl_itr_ty itr = {NULL};
+	sortl_ty *sort_list = SortLCreateKeyed(OFFSETOF_SIZE_T(keyed_ty, key));
+	size_t counter = 0;
+
+	PRINT_MSG(\n--- Test Create Keyed ---);
+
+	SortLInsert(sort_list, &first);
+	SortLInsert(sort_list, &second);
+	SortLInsert(sort_list, &third);
+
+	/* 1. smallest key first, equal keys in insertion order */
+	itr = SortLBegin(sort_list);
+	if (&second == SortLGetData(itr))
+	{ ++counter; }
+
+	itr = SortLNext(itr);
+	if (&first == SortLGetData(itr))
+	{ ++counter; }
+
+	itr = SortLNext(itr);
+	if (&third == SortLGetData(itr))
+	{ ++counter; }
+
+	/* 2. find by key */
+	if (&first == SortLGetData(SortLFind(sort_list, &to_find)))
+	{ ++counter; }
+
+	if (SortLIsSameIter(SortLEnd(sort_list), SortLFind(sort_list, &not_exist)))
+	{ ++counter; }
+
+	if (5 == counter)
+	{
+		GREEN;
+		PRINT_MSG(\tCreate Keyed SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_MSG(\tCreate Keyed FAILED);
+		DEFAULT;
+	}
+
+	SortLDestroy(sort_list);
+}
+
+void TestSortLInsertHint(void)
+{
+	int key = 1;
+	int nums[] = {50, 10, 40, 20, 30, 60, 5, 30};
+	int *prev = NULL;
+	int is_sorted = 1;
+	size_t i = 0;
+	sortl_itr_ty itr = {NULL};
+	sortl_itr_ty middle = {NULL};
+	sortl_ty *sort_list = SortLCreate(CmpObjects, (void *)&key);
+
+	PRINT_MSG(\n--- Test Insert Hint ---);
+
+	/* hints from the end, the beginning and a fixed middle element */
+	middle = SortLInsertHint(sort_list, SortLEnd(sort_list), &nums[0]);
+	SortLInsertHint(sort_list, SortLEnd(sort_list), &nums[1]);
+	SortLInsertHint(sort_list, SortLBegin(sort_list), &nums[2]);
+	SortLInsertHint(sort_list, middle, &nums[3]);
+	SortLInsertHint(sort_list, middle, &nums[4]);
+	SortLInsertHint(sort_list, SortLBegin(sort_list), &nums[5]);
+	SortLInsertHint(sort_list, SortLEnd(sort_list), &nums[6]);
+	itr = SortLInsertHint(sort_list, SortLEnd(sort_list), &nums[7]);
+
+	/* equal elements keep insertion order */
+	if (&nums[4] != SortLGetData(SortLPrev(itr)))
+	{
+		is_sorted = 0;
+	}
+
+	itr = SortLBegin(sort_list);
+	for (i = 0; i < SIZEOF_ARRAY(nums); ++i)
+	{
+		if (NULL != prev && *prev > *(int *)SortLGetData(itr))
+		{
+			is_sorted = 0;
+		}
+		prev = SortLGetData(itr);
+		itr = SortLNext(itr);
+	}
+
+	if (is_sorted && SIZEOF_ARRAY(nums) == SortLCount(sort_list))
+	{
+		GREEN;
+		PRINT_MSG(\tInsert Hint SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_MSG(\tInsert Hint FAILED);
+		DEFAULT;
+	}
+
+	SortLDestroy(sort_list);
+}
+
+
+void TestSortLSkipList(void)
+{
+	int key = 1;
+	static int nums[4000];
+	static int others[1000];
+	sortl_ty *sort_list = SortLCreate(CmpObjects, (void *)&key);
+	sortl_ty *donor = SortLCreate(CmpObjects, (void *)&key);
+	sortl_itr_ty itr = {NULL};
+	size_t n_nums = SIZEOF_ARRAY(nums);
+	size_t n_others = SIZEOF_ARRAY(others);
+	size_t i = 0;
+	size_t counter = 0;
+
+	PRINT_MSG(\n--- Test Skip List (many elements) ---);
+
+	/* permutation of 0..3999, every value inserted twice */
+	for (i = 0; i < n_nums; ++i)
+	{
+		nums[i] = (int)((i * 1543) % n_nums) / 2;
+		SortLInsert(sort_list, &nums[i]);
+	}
+
+	/* 1. count and order */
+	if (n_nums == SortLCount(sort_list) && IsSortedList(sort_list))
+	{ ++counter; }
+
+	/* 2. find returns the first inserted of two equal elements */
+	for (i = 0; i < n_nums; ++i)
+	{
+		itr = SortLFind(sort_list, &nums[i]);
+		if (*(int *)SortLGetData(itr) != nums[i] ||
+			(SortLGetData(itr) != &nums[i] &&
+			SortLGetData(SortLNext(itr)) != &nums[i]))
+		{
+			break;
+		}
+	}
+	if (n_nums == i)
+	{ ++counter; }
+
+	/* 3. remove every first occurrence, the second one must still be found */
+	for (i = 0; i < n_nums / 2; ++i)
+	{
+		key = (int)i;
+		SortLRemove(SortLFind(sort_list, &key));
+	}
+	for (i = 0; i < n_nums / 2; ++i)
+	{
+		key = (int)i;
+		if (SortLIsSameIter(SortLEnd(sort_list), SortLFind(sort_list, &key)))
+		{
+			break;
+		}
+	}
+	if (n_nums / 2 == i && n_nums / 2 == SortLCount(sort_list))
+	{ ++counter; }
+
+	/* 4. merged elements are found through the rebuilt express levels */
+	for (i = 0; i < n_others; ++i)
+	{
+		others[i] = (int)(i * 3) - 500;
+		SortLInsert(donor, &others[i]);
+	}
+	SortLMerge(sort_list, donor);
+
+	for (i = 0; i < n_others; ++i)
+	{
+		if (SortLIsSameIter(SortLEnd(sort_list), SortLFind(sort_list, &others[i])))
+		{
+			break;
+		}
+	}
+	if (n_others == i && SortLIsEmpty(donor) && IsSortedList(sort_list) &&
+		n_nums / 2 + n_others == SortLCount(sort_list))
+	{ ++counter; }
+
+	/* 5. remove everything from the front */
+	while (!SortLIsEmpty(sort_list))
+	{
+		SortLRemove(SortLBegin(sort_list));
+	}
+	key = 7;
+	if (0 == SortLCount(sort_list) &&
+		SortLIsSameIter(SortLEnd(sort_list), SortLFind(sort_list, &key)))
+	{ ++counter; }
+
+	if (5 == counter)
+	{
+		GREEN;
+		PRINT_MSG(\tSkip List SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_MSG(\tSkip List FAILED);
+		DEFAULT;
+	}
+
+	SortLDestroy(donor);
+	SortLDestroy(sort_list);
+}
+
+void TestSortLReposition(void)
+{
+	int key = 1;
+	static int nums[1000];
+	static sortl_itr_ty itrs[1000];
+	sortl_ty *sort_list = SortLCreate(CmpObjects, (void *)&key);
+	sortl_itr_ty itr = {NULL};
+	size_t n_nums = SIZEOF_ARRAY(nums);
+	size_t i = 0;
+	size_t counter = 0;
+
+	PRINT_MSG(\n--- Test Reposition ---);
+
+	for (i = 0; i < n_nums; ++i)
+	{
+		nums[i] = (int)i;
+		itrs[i] = SortLInsert(sort_list, &nums[i]);
+	}
+
+	/* 1. every element moves to a reversed value; nothing is added */
+	for (i = 0; i < n_nums; ++i)
+	{
+		nums[i] = (int)(n_nums - i);
+		itrs[i] = SortLReposition(itrs[i]);
+	}
+	if (n_nums == SortLCount(sort_list) && IsSortedList(sort_list) &&
+		&nums[n_nums - 1] == SortLGetData(SortLBegin(sort_list)))
+	{ ++counter; }
+
+	/* 2. the express levels still find every element */
+	for (i = 0; i < n_nums; ++i)
+	{
+		if (&nums[i] != SortLGetData(SortLFind(sort_list, &nums[i])))
+		{
+			break;
+		}
+	}
+	if (n_nums == i)
+	{ ++counter; }
+
+	/* 3. a moved element goes behind the equal one */
+	nums[0] = nums[500];
+	itr = SortLReposition(itrs[0]);
+	if (&nums[500] == SortLGetData(SortLPrev(itr)) && IsSortedList(sort_list))
+	{ ++counter; }
+
+	if (3 == counter)
+	{
+		GREEN;
+		PRINT_MSG(\tReposition SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_MSG(\tReposition FAILED);
+		DEFAULT;
+	}
+
+	SortLDestroy(sort_list);
+}
+
 
 /*******************************************************************************
 *******************************************************************************/
@@ -339,6 +629,24 @@ static void PrintSortedList(sortl_ty *sort_list)
 	}
 }
 
+static int IsSortedList(sortl_ty *sort_list)
+{
+	sortl_itr_ty runner = SortLBegin(sort_list);
+	sortl_itr_ty end = SortLEnd(sort_list);
+	int *prev = NULL;
+
+	for (; !SortLIsSameIter(runner, end); runner = SortLNext(runner))
+	{
+		if (NULL != prev && *prev > *(int *)SortLGetData(runner))
+		{
+			return 0;
+		}
+		prev = SortLGetData(runner);
+	}
+
+	return 1;
+}
+
 static int CmpObjects(const void *obj1, const void *obj2, const void *key)
 {
 	UNUSED(key);
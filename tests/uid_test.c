@@ -6,19 +6,31 @@
 *
 *******************************************************************************/
 
+#define _POSIX_C_SOURCE 200112L	/* clock_gettime */
 
 #include <stdio.h>		/* printf, puts */
+#include <stdlib.h>		/* malloc, free, qsort, exit */
 #include <stddef.h>		/* size_t */
+#include <pthread.h>	/* pthread_create, pthread_join */
+#include <sys/wait.h>	/* waitpid */
 
 #include "utilities.h"
 #include "uid.h"
 
+#define NUM_THREADS 	8
+#define IDS_PER_THREAD 	500000
+
 void TestUIDGenerate(void);
 void TestUIDIsSame(void);
 void TestUIDIsBad(void);
+void TestUIDThreads(void);
+void TestUIDFork(void);
 
 static void TestTimeFunctions(void);
 static void PrintUID(uid_ty uid);
+static void *GenerateIds(void *ids_);
+static int CmpCounters(const void *uid1_, const void *uid2_);
+static double NowSec(void);
 
 int main(void)
 {
@@ -26,6 +38,8 @@ int main(void)
 	TestUIDGenerate();
 	TestUIDIsSame();
 	TestUIDIsBad();
+	TestUIDThreads();
+	TestUIDFork();
 
 	TestTimeFunctions();
 
@@ -79,6 +93,98 @@ void TestUIDIsBad(void)
 	PRINT_IS_SUCCESS(is_bad, BAD_UID);
 }
 
+void TestUIDThreads(void)
+{
+	pthread_t threads[NUM_THREADS];
+	uid_ty *ids = (uid_ty *)malloc(NUM_THREADS * IDS_PER_THREAD * sizeof(uid_ty));
+	size_t num_ids = 0;
+	size_t num_started = 0;
+	size_t num_same = 0;
+	double elapsed = 0;
+	size_t i = 0;
+
+	puts("\n==> Threads");
+	if (NULL == ids)
+	{
+		return;
+	}
+
+	/* all threads generate at once, each into its own part of ids */
+	elapsed = NowSec();
+	for (num_started = 0; num_started < NUM_THREADS; ++num_started)
+	{
+		if (0 != pthread_create(&threads[num_started], NULL, GenerateIds,
+								ids + num_started * IDS_PER_THREAD))
+		{
+			break;
+		}
+	}
+	for (i = 0; i < num_started; ++i)
+	{
+		pthread_join(threads[i], NULL);
+	}
+	elapsed = NowSec() - elapsed;
+
+	/* equal neighbours after sorting are duplicates */
+	num_ids = num_started * IDS_PER_THREAD;
+	qsort(ids, num_ids, sizeof(uid_ty), CmpCounters);
+	for (i = 1; i < num_ids; ++i)
+	{
+		num_same += UIDIsSame(ids[i - 1], ids[i]);
+	}
+
+	printf("\t%lu ids by %lu threads, %.1f million ids per second\n",
+			(unsigned long)num_ids, (unsigned long)num_started,
+			(0 < elapsed) ? num_ids / elapsed / 1e6 : 0.0);
+
+	if (NUM_THREADS == num_started && 0 == num_same)
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Threads Unique: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Threads Unique: FAILED);
+		DEFAULT;
+	}
+
+	free(ids);
+}
+
+void TestUIDFork(void)
+{
+	int status = 0;
+	pid_t child = 0;
+
+	/* the parent has cached its pid already */
+	UIDGenerate();
+
+	/* the child exits through exit(), do not let it print our buffer */
+	fflush(stdout);
+	child = fork();
+	if (0 == child)
+	{
+		exit((UIDGenerate().pid == getpid()) ? 0 : 1);
+	}
+
+	if (0 < child && child == waitpid(child, &status, 0) &&
+		WIFEXITED(status) && 0 == WEXITSTATUS(status) &&
+		UIDGenerate().pid == getpid())
+	{
+		GREEN;
+		PRINT_STATUS_MSG(Test Fork Pid: SUCCESS);
+		DEFAULT;
+	}
+	else
+	{
+		RED;
+		PRINT_STATUS_MSG(Test Fork Pid: FAILED);
+		DEFAULT;
+	}
+}
+
 
 static void TestTimeFunctions(void)
 {
@@ -96,3 +202,33 @@ static void PrintUID(uid_ty uid)
 	printf("PID:\t%d\n", uid.pid);
 	puts("\n");
 }
+
+static void *GenerateIds(void *ids_)
+{
+	uid_ty *ids = (uid_ty *)ids_;
+	size_t i = 0;
+
+	for (i = 0; i < IDS_PER_THREAD; ++i)
+	{
+		ids[i] = UIDGenerate();
+	}
+
+	return NULL;
+}
+
+static int CmpCounters(const void *uid1_, const void *uid2_)
+{
+	size_t counter1 = ((const uid_ty *)uid1_)->counter;
+	size_t counter2 = ((const uid_ty *)uid2_)->counter;
+
+	return (counter1 > counter2) - (counter1 < counter2);
+}
+
+static double NowSec(void)
+{
+	struct timespec now = {0};
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return now.tv_sec + now.tv_nsec / 1e9;
+}
@@ -0,0 +1,145 @@
+/*******************************************************************************
+******************************** - SCHEDTOP - **********************************
+*
+*	DESCRIPTION		Live view of the statistics a scheduler publishes with
+*					SchedStatsCreate: queue depth, dispatch rate, lateness
+*					percentiles and the tasks which ran the most. It only
+*					reads the segment; the scheduler is never called.
+*	AUTHOR          Liad Raz
+*	USAGE			schedtop NAME [INTERVAL] [COUNT]
+*					INTERVAL seconds between updates, 1 by default; COUNT
+*					updates, 0 (forever) by default.
+*
+*******************************************************************************/
+
+#define _POSIX_C_SOURCE 200112L	/* isatty */
+
+#include <stdio.h>		/* printf, puts, fprintf */
+#include <stdlib.h>		/* malloc, free, qsort, atol */
+#include <time.h>		/* time, time_t */
+#include <unistd.h>		/* sleep, isatty */
+
+#include "scheduler.h"
+
+#define MAX_ROWS 	20
+
+static void Show(const char *name, const sched_stats_ty *stats,
+				sched_task_runs_ty *tasks, size_t num_tasks);
+static int CmpRuns(const void *task1, const void *task2);
+
+int main(int argc, char *argv[])
+{
+	sched_stats_view_ty *view = NULL;
+	sched_task_runs_ty *tasks = NULL;
+	sched_stats_ty stats;
+	unsigned int interval = (2 < argc) ? (unsigned int)atol(argv[2]) : 1;
+	long count = (3 < argc) ? atol(argv[3]) : 0;
+	long i = 0;
+
+	if (2 > argc)
+	{
+		fprintf(stderr, "usage: %s NAME [INTERVAL] [COUNT]\n", argv[0]);
+		return 2;
+	}
+
+	view = SchedStatsAttach(argv[1]);
+	if (NULL == view)
+	{
+		fprintf(stderr, "%s: no scheduler statistics at %s\n", argv[0], argv[1]);
+		return 1;
+	}
+
+	/* the capacity is known after the first read */
+	if (0 != SchedStatsRead(view, &stats, NULL, 0))
+	{
+		fprintf(stderr, "%s: the statistics keep changing\n", argv[0]);
+		SchedStatsDetach(view);
+		return 1;
+	}
+
+	tasks = (sched_task_runs_ty *)malloc((stats.capacity + 1) * sizeof(sched_task_runs_ty));
+	if (NULL == tasks)
+	{
+		SchedStatsDetach(view);
+		return 1;
+	}
+
+	for (i = 0; 0 == count || i < count; ++i)
+	{
+		if (0 != i)
+		{
+			sleep(interval);
+		}
+
+		/* a torn read is skipped, the next one is shown */
+		if (0 == SchedStatsRead(view, &stats, tasks, stats.capacity))
+		{
+			Show(argv[1], &stats, tasks, stats.num_tasks);
+		}
+	}
+
+	free(tasks);
+	SchedStatsDetach(view);
+
+	return 0;
+}
+
+static void Show(const char *name, const sched_stats_ty *stats,
+				sched_task_runs_ty *tasks, size_t num_tasks)
+{
+	time_t now = time(NULL);
+	unsigned long rate = stats->dispatch_rate;
+	size_t i = 0;
+
+	/* nothing ran since the second before the update */
+	if (1 < now - stats->updated)
+	{
+		rate = 0;
+	}
+
+	if (num_tasks > stats->capacity)
+	{
+		num_tasks = stats->capacity;
+	}
+
+	qsort(tasks, num_tasks, sizeof(sched_task_runs_ty), CmpRuns);
+
+	/* redraw in place on a terminal, append otherwise */
+	if (isatty(STDOUT_FILENO))
+	{
+		printf("\033[H\033[2J");
+	}
+
+	printf("schedtop %s\t%s, up %lds, updated %lds ago\n", name,
+			stats->is_running ? "running" : "stopped",
+			(long)(stats->is_running ? now - stats->started : 0),
+			(long)(now - stats->updated));
+	printf("queue %lu\tdispatched %lu (%lu failed)\trate %lu/s\n",
+			stats->queue_depth, stats->num_dispatched, stats->num_failed, rate);
+	printf("lateness ms\tp50 %lu\tp90 %lu\tp99 %lu\tmax %lu\n",
+			stats->late_p50, stats->late_p90, stats->late_p99, stats->late_max);
+	printf("overload\tdeferred %lu\trejected %lu\n\n",
+			stats->num_deferred, stats->num_rejected);
+
+	printf("%20s %12s\n", "TASK ID", "RUNS");
+	for (i = 0; i < num_tasks && i < MAX_ROWS; ++i)
+	{
+		printf("%20lu %12lu\n", tasks[i].id, tasks[i].runs);
+	}
+	if (MAX_ROWS < num_tasks)
+	{
+		printf("%20s (%lu more)\n", "...", (unsigned long)(num_tasks - MAX_ROWS));
+	}
+	puts("");
+
+	fflush(stdout);
+}
+
+/* most runs first */
+static int CmpRuns(const void *task1, const void *task2)
+{
+	unsigned long runs1 = ((const sched_task_runs_ty *)task1)->runs;
+	unsigned long runs2 = ((const sched_task_runs_ty *)task2)->runs;
+
+	return (runs1 < runs2) - (runs1 > runs2);
+}
@@ -0,0 +1,92 @@
+/*******************************************************************************
+********************************* - PROBES - ***********************************
+*
+*	DESCRIPTION		Static tracepoints (USDT) without sys/sdt.h
+*	AUTHOR          Liad Raz
+*
+*******************************************************************************/
+
+#ifndef __PROBES_H__
+#define __PROBES_H__
+
+/*******************************************************************************
+* SDT_PROBEn(provider, name, args...) marks a static tracepoint: a single nop
+* in the code, and a note in the .note.stapsdt section which tells its
+* address and where its arguments are, in the format of SystemTap's
+* sys/sdt.h. perf, bpftrace and SystemTap list and attach to them:
+*
+*	$ perf probe -x ./app sdt_scheduler:dispatch_start
+*	$ bpftrace -e 'usdt:./app:scheduler:dispatch_start { @[arg0] = count(); }'
+*
+* An attached tool replaces the nop with a trap; unattached the cost is the
+* nop, and the arguments being in a register or on the stack already.
+* Arguments are passed as long, 8 bytes signed.
+*
+* Notes are emitted for GCC compatible compilers on x86-64 and AArch64 ELF
+* targets. Elsewhere, or built with -DNO_PROBES, the probes expand to
+* nothing and their arguments are not evaluated.
+*******************************************************************************/
+
+#if defined(__GNUC__) && defined(__ELF__) && !defined(NO_PROBES) && \
+	(defined(__x86_64__) || defined(__aarch64__))
+
+/* where the compiler may leave an argument: register, offsettable memory
+   or constant on x86-64, register on AArch64 */
+#if defined(__x86_64__)
+#define SDT_ARG_IMP(arg) 	"nor" ((long)(arg))
+#else
+#define SDT_ARG_IMP(arg) 	"r" ((long)(arg))
+#endif
+
+/* the nop, its note, and the .stapsdt.base symbol tools use to find where
+   the library was loaded, once per object */
+#define SDT_ASM_IMP(provider, name, args)									\
+		"990:	nop\n"														\
+		"	.pushsection .note.stapsdt,\"?\",\"note\"\n"					\
+		"	.balign 4\n"													\
+		"	.4byte 992f-991f, 994f-993f, 3\n"								\
+		"991:	.asciz \"stapsdt\"\n"										\
+		"992:	.balign 4\n"												\
+		"993:	.8byte 990b\n"												\
+		"	.8byte _.stapsdt.base\n"										\
+		"	.8byte 0\n"														\
+		"	.asciz \"" #provider "\"\n"										\
+		"	.asciz \"" #name "\"\n"											\
+		"	.asciz \"" args "\"\n"											\
+		"994:	.balign 4\n"												\
+		"	.popsection\n"													\
+		"	.ifndef _.stapsdt.base\n"										\
+		"	.pushsection .stapsdt.base,\"aG\",\"progbits\",.stapsdt.base,comdat\n" \
+		"	.weak _.stapsdt.base\n"											\
+		"	.hidden _.stapsdt.base\n"										\
+		"_.stapsdt.base:	.space 1\n"										\
+		"	.size _.stapsdt.base, 1\n"										\
+		"	.popsection\n"													\
+		"	.endif\n"
+
+#define SDT_PROBE0(provider, name)											\
+		__asm__ __volatile__ (SDT_ASM_IMP(provider, name, ""))
+
+#define SDT_PROBE1(provider, name, arg1)									\
+		__asm__ __volatile__ (SDT_ASM_IMP(provider, name, "-8@%0")			\
+							: : SDT_ARG_IMP(arg1))
+
+#define SDT_PROBE2(provider, name, arg1, arg2)								\
+		__asm__ __volatile__ (SDT_ASM_IMP(provider, name, "-8@%0 -8@%1")	\
+							: : SDT_ARG_IMP(arg1), SDT_ARG_IMP(arg2))
+
+#define SDT_PROBE3(provider, name, arg1, arg2, arg3)						\
+		__asm__ __volatile__ (SDT_ASM_IMP(provider, name, "-8@%0 -8@%1 -8@%2") \
+							: : SDT_ARG_IMP(arg1), SDT_ARG_IMP(arg2),		\
+							SDT_ARG_IMP(arg3))
+
+#else
+
+#define SDT_PROBE0(provider, name)
+#define SDT_PROBE1(provider, name, arg1)
+#define SDT_PROBE2(provider, name, arg1, arg2)
+#define SDT_PROBE3(provider, name, arg1, arg2, arg3)
+
+#endif
+
+#endif /* __PROBES_H__ */